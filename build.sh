@@ -74,14 +74,28 @@ function build_modules()
 						clang++ ${cflags_common} -c module.cpp -o module.o
 						on_fail $? "Failed to compile module $mod (C++)"
 					fi
-					if [ -f module.o ] ; then
+					if [ -f module_params.yml ] && { [ -f module.c ] || [ -f module.cpp ] ; } ; then
+						# Variants: the same source rebuilt with extra flags,
+						# e.g. "sim: -DZKVM_SIM=1" produces module.sim.o
+						while read -r variant variant_flags ; do
+							[ -n "$variant" ] || continue
+							if [ -f module.c ] ; then
+								clang ${cflags_common} ${variant_flags} -c module.c -o module.${variant}.o
+							else
+								clang++ ${cflags_common} ${variant_flags} -c module.cpp -o module.${variant}.o
+							fi
+							on_fail $? "Failed to compile module $mod (variant ${variant})"
+						done < <(yq -r '.options.variants // {} | to_entries[] | "\(.key) \(.value)"' module_params.yml)
+					fi
+					for obj in module*.o ; do
+						[ -f "$obj" ] || continue
 						# Fix up ABI marker — only meaningful for ELF objects;
 						# LTO bitcode files are not ELF, ABI is handled at LTO link time.
-						magic=$(head -c 4 module.o | xxd -p)
+						magic=$(head -c 4 "$obj" | xxd -p)
 						if [ "$magic" = "7f454c46" ] ; then
-							printf '\x00' | dd of="module.o" bs=1 seek=$((0x30)) count=1 conv=notrunc status=none
+							printf '\x00' | dd of="$obj" bs=1 seek=$((0x30)) count=1 conv=notrunc status=none
 						fi
-					fi
+					done
 					if [ -f module_params.yml ] ; then
 						repo="$(yq -r .options.repo module_params.yml)"
 						tag="$(yq -r .options.tag module_params.yml)"
@@ -0,0 +1,236 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using Xunit;
+
+namespace bflat.Tests;
+
+public class ElfSymbolReaderTests : IDisposable
+{
+    private readonly string _directory = Directory.CreateTempSubdirectory("bflat-elfsym-").FullName;
+    private readonly string _previousCache = Environment.GetEnvironmentVariable("BFLAT_SYMBOL_CACHE");
+
+    public ElfSymbolReaderTests()
+    {
+        Environment.SetEnvironmentVariable("BFLAT_SYMBOL_CACHE", Path.Combine(_directory, "cache"));
+    }
+
+    public void Dispose()
+    {
+        Environment.SetEnvironmentVariable("BFLAT_SYMBOL_CACHE", _previousCache);
+        Directory.Delete(_directory, recursive: true);
+    }
+
+    // Symbols of the fixture object, after the null entry: a local function,
+    // a global one, and an undefined reference.
+    private static readonly (string Name, byte Info, ushort Section, ulong Value, ulong Size)[] Symbols =
+    [
+        ("local_helper", (ElfFile.StbLocal << 4) | ElfFile.SttFunc, 4, 0, 8),
+        ("main", (1 << 4) | ElfFile.SttFunc, 4, 8, 8),
+        ("puts", (1 << 4) | ElfFile.SttNotype, 0, 0, 0),
+    ];
+
+    private string WriteFile(string name, byte[] contents)
+    {
+        string path = Path.Combine(_directory, name);
+        File.WriteAllBytes(path, contents);
+        return path;
+    }
+
+    // A relocatable RISC-V ELF64 object: null, .shstrtab, .strtab, .symtab
+    // and a 16-byte .text.
+    private static byte[] Object(params (string Name, byte Info, ushort Section, ulong Value, ulong Size)[] symbols)
+    {
+        byte[] shstrtab = Encoding.ASCII.GetBytes("\0.shstrtab\0.strtab\0.symtab\0.text\0");
+        var strtab = new MemoryStream();
+        strtab.WriteByte(0);
+        var symtab = new byte[24 * (symbols.Length + 1)];
+        for (int i = 0; i < symbols.Length; i++)
+        {
+            Span<byte> e = symtab.AsSpan(24 * (i + 1), 24);
+            BinaryPrimitives.WriteUInt32LittleEndian(e, (uint)strtab.Length);
+            e[4] = symbols[i].Info;
+            BinaryPrimitives.WriteUInt16LittleEndian(e.Slice(6), symbols[i].Section);
+            BinaryPrimitives.WriteUInt64LittleEndian(e.Slice(8), symbols[i].Value);
+            BinaryPrimitives.WriteUInt64LittleEndian(e.Slice(16), symbols[i].Size);
+            strtab.Write(Encoding.ASCII.GetBytes(symbols[i].Name + "\0"));
+        }
+        byte[] text = new byte[16];
+
+        var image = new MemoryStream();
+        image.Write(new byte[64]);
+        var sections = new List<ElfFile.Section> { new ElfFile.Section() };
+        void Add(uint name, uint type, byte[] contents, uint link = 0, uint info = 0, ulong entsize = 0)
+        {
+            sections.Add(new ElfFile.Section
+            {
+                NameOffset = name, Type = type, Offset = (ulong)image.Length, Size = (ulong)contents.Length,
+                Link = link, Info = info, Align = 1, Entsize = entsize,
+            });
+            image.Write(contents);
+        }
+        Add(1, 3, shstrtab);
+        Add(11, 3, strtab.ToArray());
+        Add(19, ElfFile.ShtSymtab, symtab, link: 2, info: 2, entsize: 24);
+        Add(27, ElfFile.ShtProgbits, text);
+
+        long shoff = (image.Length + 7) & ~7L;
+        image.SetLength(shoff);
+        image.Position = shoff;
+        foreach (ElfFile.Section s in sections)
+            image.Write(ElfFile.PackSectionHeader(s));
+
+        byte[] elf = image.ToArray();
+        "\x7F"u8.CopyTo(elf);
+        "ELF"u8.CopyTo(elf.AsSpan(1));
+        elf[4] = 2;                                                        // ELFCLASS64
+        elf[5] = 1;                                                        // little-endian
+        elf[6] = 1;                                                        // EV_CURRENT
+        BinaryPrimitives.WriteUInt16LittleEndian(elf.AsSpan(0x10), 1);     // ET_REL
+        BinaryPrimitives.WriteUInt16LittleEndian(elf.AsSpan(0x12), 243);   // EM_RISCV
+        BinaryPrimitives.WriteUInt32LittleEndian(elf.AsSpan(0x14), 1);
+        BinaryPrimitives.WriteUInt64LittleEndian(elf.AsSpan(0x28), (ulong)shoff);
+        BinaryPrimitives.WriteUInt16LittleEndian(elf.AsSpan(0x34), 64);
+        BinaryPrimitives.WriteUInt16LittleEndian(elf.AsSpan(0x3A), ElfFile.SectionHeaderSize);
+        BinaryPrimitives.WriteUInt16LittleEndian(elf.AsSpan(0x3C), (ushort)sections.Count);
+        BinaryPrimitives.WriteUInt16LittleEndian(elf.AsSpan(0x3E), 1);
+        return elf;
+    }
+
+    // An ar archive with a "/" symbol index naming `indexed` and one member.
+    // A thin archive keeps only the index inline.
+    private static byte[] Archive(byte[] member, bool thin, params string[] indexed)
+    {
+        var index = new MemoryStream();
+        var word = new byte[4];
+        BinaryPrimitives.WriteUInt32BigEndian(word, (uint)indexed.Length);
+        index.Write(word);
+        foreach (string _ in indexed)
+            index.Write(new byte[4]);
+        foreach (string name in indexed)
+            index.Write(Encoding.ASCII.GetBytes(name + "\0"));
+
+        var archive = new MemoryStream();
+        archive.Write(Encoding.ASCII.GetBytes(thin ? "!<thin>\n" : "!<arch>\n"));
+        void Member(string name, byte[] contents, bool inline)
+        {
+            archive.Write(Encoding.ASCII.GetBytes(
+                $"{name,-16}{0,-12}{0,-6}{0,-6}{644,-8}{contents.Length,-10}`\n"));
+            if (inline)
+            {
+                archive.Write(contents);
+                if ((contents.Length & 1) != 0)
+                    archive.WriteByte((byte)'\n');
+            }
+        }
+        Member("/", index.ToArray(), inline: true);
+        Member("fixture.o/", member, inline: !thin);
+        return archive.ToArray();
+    }
+
+    [Fact]
+    public void ReadBinaryListsEveryEntry()
+    {
+        string path = WriteFile("fixture.o", Object(Symbols));
+
+        List<ElfSymbol> symbols = ElfSymbolReader.ReadBinary(path);
+
+        Assert.Equal(4, symbols.Count);
+        Assert.Equal("", symbols[0].Name);
+        Assert.Equal(new ElfSymbol(1, 0, 8, "FUNC", "LOCAL", "DEFAULT", "4", "local_helper"), symbols[1]);
+        Assert.Equal(new ElfSymbol(2, 8, 8, "FUNC", "GLOBAL", "DEFAULT", "4", "main"), symbols[2]);
+        Assert.Equal(new ElfSymbol(3, 0, 0, "NOTYPE", "GLOBAL", "DEFAULT", "UND", "puts"), symbols[3]);
+    }
+
+    [Fact]
+    public void ReadBinaryRejectsNonElf()
+    {
+        string path = WriteFile("notes.txt", Encoding.ASCII.GetBytes("not an object file at all, just some text"));
+
+        Assert.Null(ElfSymbolReader.ReadBinary(path));
+    }
+
+    [Fact]
+    public void ReadNamesOfObject()
+    {
+        string path = WriteFile("fixture.o", Object(Symbols));
+
+        HashSet<string> names = ElfSymbolReader.ReadNames([path]);
+
+        Assert.Equal(new[] { "local_helper", "main", "puts" }, names.Order(StringComparer.Ordinal));
+    }
+
+    [Fact]
+    public void ReadNamesOfArchiveIncludesIndexAndMembers()
+    {
+        string path = WriteFile("libfixture.a", Archive(Object(Symbols), thin: false, "main", "only_in_index"));
+
+        HashSet<string> names = ElfSymbolReader.ReadNames([path]);
+
+        Assert.Equal(new[] { "local_helper", "main", "only_in_index", "puts" }, names.Order(StringComparer.Ordinal));
+    }
+
+    [Fact]
+    public void ReadNamesOfThinArchiveReadsOnlyIndex()
+    {
+        string path = WriteFile("libthin.a", Archive(Object(Symbols), thin: true, "main"));
+
+        HashSet<string> names = ElfSymbolReader.ReadNames([path]);
+
+        Assert.Equal(new[] { "main" }, names);
+    }
+
+    [Fact]
+    public void ReadNamesSkipsUnreadableInputs()
+    {
+        string good = WriteFile("fixture.o", Object(Symbols));
+        string bad = WriteFile("bad.o", Encoding.ASCII.GetBytes("garbage that is neither ELF nor ar"));
+
+        HashSet<string> names = ElfSymbolReader.ReadNames([bad, good, Path.Combine(_directory, "missing.o")]);
+
+        Assert.Equal(3, names.Count);
+    }
+
+    [Fact]
+    public void ReadNamesCachesOnDisk()
+    {
+        string path = WriteFile("fixture.o", Object(Symbols));
+
+        ElfSymbolReader.ReadNames([path]);
+
+        string entry = Path.Combine(_directory, "cache", ElfSymbolReader.CacheKey(ElfSymbolReader.Identity(path)));
+        Assert.True(File.Exists(entry));
+        Assert.Equal(new[] { "local_helper", "main", "puts" },
+            File.ReadAllText(entry).Split('\n').Order(StringComparer.Ordinal));
+    }
+
+    [Fact]
+    public void RewrittenInputIsReadAgain()
+    {
+        string path = WriteFile("fixture.o", Object(Symbols));
+        File.SetLastWriteTimeUtc(path, new DateTime(2026, 1, 1, 0, 0, 0, DateTimeKind.Utc));
+        Assert.Contains("puts", ElfSymbolReader.ReadNames([path]));
+
+        File.WriteAllBytes(path, Object(("main", (1 << 4) | ElfFile.SttFunc, 4, 8, 8), ("printf", 1 << 4, 0, 0, 0)));
+        File.SetLastWriteTimeUtc(path, new DateTime(2026, 1, 2, 0, 0, 0, DateTimeKind.Utc));
+
+        HashSet<string> names = ElfSymbolReader.ReadNames([path]);
+        Assert.Contains("printf", names);
+        Assert.DoesNotContain("puts", names);
+    }
+
+    [Fact]
+    public void IdentityFollowsMetadata()
+    {
+        string path = WriteFile("fixture.o", Object(Symbols));
+        string before = ElfSymbolReader.Identity(path);
+        Assert.Equal(before, ElfSymbolReader.Identity(path));
+        Assert.StartsWith(Path.GetFullPath(path) + "\n", before);
+
+        File.SetLastWriteTimeUtc(path, File.GetLastWriteTimeUtc(path).AddSeconds(-10));
+        Assert.NotEqual(before, ElfSymbolReader.Identity(path));
+    }
+}
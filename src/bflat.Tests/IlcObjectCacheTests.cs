@@ -0,0 +1,143 @@
+using System;
+using System.IO;
+using Xunit;
+
+namespace bflat.Tests;
+
+public class IlcObjectCacheTests : IDisposable
+{
+    private readonly string _directory = Directory.CreateTempSubdirectory("bflat-ilccache-").FullName;
+
+    public void Dispose() => Directory.Delete(_directory, recursive: true);
+
+    private string Root => Path.Combine(_directory, "cache");
+
+    private string WriteFile(string relativePath, string contents)
+    {
+        string path = Path.Combine(_directory, relativePath);
+        Directory.CreateDirectory(Path.GetDirectoryName(path));
+        File.WriteAllText(path, contents);
+        return path;
+    }
+
+    private IlcObjectCache Cache(params string[] compilerBinaries) => new IlcObjectCache(Root, compilerBinaries);
+
+    [Fact]
+    public void SameInputsGiveSameKey()
+    {
+        string reference = WriteFile("System.Runtime.dll", "reference");
+        string Key()
+        {
+            IlcObjectCache cache = Cache();
+            cache.AddBytes([1, 2, 3]);
+            cache.AddFile(reference);
+            cache.AddString("--libc");
+            cache.AddString("zisk");
+            return cache.Key;
+        }
+
+        string key = Key();
+        Assert.Equal(64, key.Length);
+        Assert.Equal(key, Key());
+    }
+
+    [Fact]
+    public void EachInputChangesKey()
+    {
+        IlcObjectCache baseline = Cache();
+        baseline.AddBytes([1, 2, 3]);
+        baseline.AddString("-Os");
+
+        IlcObjectCache otherIl = Cache();
+        otherIl.AddBytes([1, 2, 4]);
+        otherIl.AddString("-Os");
+
+        IlcObjectCache otherOption = Cache();
+        otherOption.AddBytes([1, 2, 3]);
+        otherOption.AddString("-Ot");
+
+        IlcObjectCache nullOption = Cache();
+        nullOption.AddBytes([1, 2, 3]);
+        nullOption.AddString(null);
+
+        Assert.NotEqual(baseline.Key, otherIl.Key);
+        Assert.NotEqual(baseline.Key, otherOption.Key);
+        Assert.NotEqual(baseline.Key, nullOption.Key);
+    }
+
+    [Fact]
+    public void ValuesDoNotRunTogether()
+    {
+        IlcObjectCache split = Cache();
+        split.AddString("ab");
+        split.AddString("c");
+
+        IlcObjectCache joined = Cache();
+        joined.AddString("a");
+        joined.AddString("bc");
+
+        Assert.NotEqual(split.Key, joined.Key);
+    }
+
+    [Fact]
+    public void FilesAreKeyedByNameAndContent()
+    {
+        string Key(string path)
+        {
+            IlcObjectCache cache = Cache();
+            cache.AddFile(path);
+            return cache.Key;
+        }
+
+        string key = Key(WriteFile("a/System.Runtime.dll", "reference"));
+        Assert.Equal(key, Key(WriteFile("b/System.Runtime.dll", "reference")));
+        Assert.NotEqual(key, Key(WriteFile("c/System.Runtime.dll", "reference v2")));
+        Assert.NotEqual(key, Key(WriteFile("d/System.Console.dll", "reference")));
+    }
+
+    [Fact]
+    public void RebuiltCompilerChangesKey()
+    {
+        string compiler = WriteFile("ILCompiler.Compiler.dll", "compiler");
+        File.SetLastWriteTimeUtc(compiler, new DateTime(2026, 1, 1, 0, 0, 0, DateTimeKind.Utc));
+        string before = Cache(compiler).Key;
+
+        File.SetLastWriteTimeUtc(compiler, new DateTime(2026, 1, 2, 0, 0, 0, DateTimeKind.Utc));
+        Assert.NotEqual(before, Cache(compiler).Key);
+    }
+
+    [Fact]
+    public void StoreThenRestore()
+    {
+        string objectFile = WriteFile("out/program.o", "object");
+        string sideFile = WriteFile("out/program.exports", "exports");
+
+        IlcObjectCache cache = Cache();
+        cache.AddString("program");
+        Assert.False(cache.TryRestore(objectFile, [sideFile]));
+        cache.Store(objectFile, [sideFile]);
+
+        File.Delete(objectFile);
+        File.Delete(sideFile);
+
+        IlcObjectCache again = Cache();
+        again.AddString("program");
+        Assert.True(again.TryRestore(objectFile, [sideFile]));
+        Assert.Equal("object", File.ReadAllText(objectFile));
+        Assert.Equal("exports", File.ReadAllText(sideFile));
+    }
+
+    [Fact]
+    public void RestoreMissesWhenASideFileIsMissing()
+    {
+        string objectFile = WriteFile("out/program.o", "object");
+        string sideFile = WriteFile("out/program.exports", "exports");
+
+        IlcObjectCache cache = Cache();
+        cache.Store(objectFile, []);
+
+        File.WriteAllText(objectFile, "untouched");
+        Assert.False(Cache().TryRestore(objectFile, [sideFile]));
+        Assert.Equal("untouched", File.ReadAllText(objectFile));
+    }
+}
@@ -0,0 +1,53 @@
+using System;
+using System.IO;
+using Xunit;
+
+namespace bflat.Tests;
+
+public class StackDepthAnalysisTests
+{
+    [Theory]
+    [InlineData("65536", 65536)]
+    [InlineData("0x10000", 65536)]
+    [InlineData("64K", 64 * 1024)]
+    [InlineData("64k", 64 * 1024)]
+    [InlineData("4M", 4 * 1024 * 1024)]
+    [InlineData(" 1m ", 1024 * 1024)]
+    [InlineData("100", 112)]
+    public void StackSizeParses(string value, long expected)
+    {
+        Assert.True(StackDepthAnalysis.TryParseStackSize(value, out long bytes));
+        Assert.Equal(expected, bytes);
+    }
+
+    [Theory]
+    [InlineData("")]
+    [InlineData("K")]
+    [InlineData("0")]
+    [InlineData("-4K")]
+    [InlineData("4G")]
+    [InlineData("4KB")]
+    [InlineData("0x")]
+    [InlineData("4096M")]
+    public void StackSizeRejects(string value)
+    {
+        Assert.False(StackDepthAnalysis.TryParseStackSize(value, out _));
+    }
+
+    [Fact]
+    public void NonElfInputThrowsWithoutReport()
+    {
+        string input = Path.GetTempFileName();
+        string report = Path.ChangeExtension(input, ".stack.txt");
+        File.WriteAllText(input, "not an executable");
+        try
+        {
+            Assert.ThrowsAny<Exception>(() => StackDepthAnalysis.Write(input, report, 4096));
+            Assert.False(File.Exists(report));
+        }
+        finally
+        {
+            File.Delete(input);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+using System;
+using System.IO;
+using System.Linq;
+using Xunit;
+
+namespace bflat.Tests;
+
+// What zkVM build options change in the compiled object.
+public class ZkvmBuildTests
+{
+    // Four implementations: over NativeAOT's default budget of three type
+    // checks per call site, within the five --zkvm-exact-dispatch allows.
+    private const string FourShapes = """
+        IShape[] shapes = [new A(), new B(), new C(), new D()];
+        int total = 0;
+        foreach (IShape shape in shapes)
+            total += Area(shape);
+        System.Console.WriteLine(total);
+
+        [System.Runtime.CompilerServices.MethodImpl(System.Runtime.CompilerServices.MethodImplOptions.NoInlining)]
+        static int Area(IShape shape) => shape.Area();
+
+        interface IShape { int Area(); }
+        class A : IShape { public int Area() => 1; }
+        class B : IShape { public int Area() => 2; }
+        class C : IShape { public int Area() => 3; }
+        class D : IShape { public int Area() => 4; }
+        """;
+
+    private static int ShapeDispatchCells(BflatCompilationResult result)
+    {
+        ElfFile elf = ElfFile.Read(Path.ChangeExtension(result.BinaryName, ".o"));
+        return elf.ReadSymbols().Count(s =>
+            s.Name.Contains("__InterfaceDispatchCell_", StringComparison.Ordinal) &&
+            s.Name.Contains("IShape", StringComparison.Ordinal));
+    }
+
+    [Fact]
+    public void ExactDispatchRemovesDispatchCells()
+    {
+        var compilation = new BflatCompilation();
+        var plain = compilation.Build(FourShapes, "--libc zisk_sim -c");
+        var exact = compilation.Build(FourShapes, "--libc zisk_sim -c --zkvm-exact-dispatch");
+
+        Assert.NotEqual(0, ShapeDispatchCells(plain));
+        Assert.Equal(0, ShapeDispatchCells(exact));
+
+        string report = File.ReadAllText(Path.ChangeExtension(exact.BinaryName, ".dispatch.txt"));
+        Assert.Contains(report.Split('\n'), line => line.StartsWith("direct  ", StringComparison.Ordinal) && line.Contains("IShape"));
+    }
+}
@@ -0,0 +1,190 @@
+using System;
+using Xunit;
+
+namespace bflat.Tests;
+
+// Known-answer tests for the zisk precompile and arith256 wrappers, run
+// against the software fallbacks of zisk_sim guests.
+public class ZkvmPrecompileTests
+{
+    // Appended after the top-level statements of a test program.
+    private const string Point = """
+
+        static unsafe class Curve
+        {
+            public static Bflat.Zkvm.Secp256k1Point G()
+            {
+                var g = new Bflat.Zkvm.Secp256k1Point();
+                g.X[0] = 0x59F2815B16F81798; g.X[1] = 0x029BFCDB2DCE28D9; g.X[2] = 0x55A06295CE870B07; g.X[3] = 0x79BE667EF9DCBBAC;
+                g.Y[0] = 0x9C47D08FFB10D4B8; g.Y[1] = 0xFD17B448A6855419; g.Y[2] = 0x5DA4FBFC0E1108A8; g.Y[3] = 0x483ADA7726A3C465;
+                return g;
+            }
+
+            public static string Hex(Bflat.Zkvm.Secp256k1Point p) =>
+                $"{p.X[3]:x16}{p.X[2]:x16}{p.X[1]:x16}{p.X[0]:x16} {p.Y[3]:x16}{p.Y[2]:x16}{p.Y[1]:x16}{p.Y[0]:x16}";
+        }
+        """;
+
+    // Appended after the top-level statements of a test program.
+    private const string Wide = """
+
+        static class Wide
+        {
+            public static readonly Bflat.Zkvm.ZkUInt256 Max = new(ulong.MaxValue, ulong.MaxValue, ulong.MaxValue, ulong.MaxValue);
+            public static readonly Bflat.Zkvm.ZkUInt256 Top = new(0, 0, 0, 1UL << 63);
+
+            public static string Hex(Bflat.Zkvm.ZkUInt256 v) => $"{v.U3:x16}{v.U2:x16}{v.U1:x16}{v.U0:x16}";
+        }
+        """;
+
+    private const string Zero = "0000000000000000000000000000000000000000000000000000000000000000";
+    private const string One = "0000000000000000000000000000000000000000000000000000000000000001";
+    private const string Max = "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff";
+
+    private const string G =
+        "79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798 " +
+        "483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8";
+
+    private const string ThreeG =
+        "f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9 " +
+        "388f7b0f632de8140fe337e62a37f3566500a99934c2231b6cb9fd7584b8e672";
+
+    [Fact]
+    public void Keccak256MatchesReference()
+    {
+        string source = """
+            byte[] hash = new byte[32];
+            Bflat.Zkvm.ZkPrecompiles.Keccak256([], hash);
+            System.Console.WriteLine(System.Convert.ToHexString(hash));
+            Bflat.Zkvm.ZkPrecompiles.Keccak256("abc"u8, hash);
+            System.Console.WriteLine(System.Convert.ToHexString(hash));
+            """;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run(
+            "C5D2460186F7233C927E7DB2DCC703C0E500B653CA82273B7BFAD8045D85A470" + Environment.NewLine +
+            "4E03657AEA45A94FC7D47BA826C8D667C0D1E6E33A64A036EC44F58FA12D6C45" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void Sha256MatchesReference()
+    {
+        // The 56-byte message pads into a second block.
+        string source = """
+            byte[] hash = new byte[32];
+            Bflat.Zkvm.ZkPrecompiles.Sha256("abc"u8, hash);
+            System.Console.WriteLine(System.Convert.ToHexString(hash));
+            Bflat.Zkvm.ZkPrecompiles.Sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"u8, hash);
+            System.Console.WriteLine(System.Convert.ToHexString(hash));
+            """;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run(
+            "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD" + Environment.NewLine +
+            "248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void Secp256k1MultiplyAgreesWithDoubleAndAdd()
+    {
+        string source = """
+            var product = Curve.G();
+            bool finite = Bflat.Zkvm.ZkPrecompiles.Secp256k1Multiply(ref product, [3, 0, 0, 0]);
+            System.Console.WriteLine($"{finite} {Curve.Hex(product)}");
+
+            var sum = Curve.G();
+            Bflat.Zkvm.ZkPrecompiles.Secp256k1Double(ref sum);
+            Bflat.Zkvm.ZkPrecompiles.Secp256k1Add(ref sum, Curve.G());
+            System.Console.WriteLine(Curve.Hex(sum));
+            """ + Point;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run(
+            "True " + ThreeG + Environment.NewLine + ThreeG + Environment.NewLine);
+    }
+
+    [Fact]
+    public void Secp256k1MultiplyByGroupOrder()
+    {
+        // n·G is the point at infinity: false, and the point is left alone.
+        // (n-1)·G is -G, which shares G's x.
+        string source = """
+            var infinity = Curve.G();
+            bool finite = Bflat.Zkvm.ZkPrecompiles.Secp256k1Multiply(ref infinity,
+                [0xBFD25E8CD0364141, 0xBAAEDCE6AF48A03B, 0xFFFFFFFFFFFFFFFE, 0xFFFFFFFFFFFFFFFF]);
+            System.Console.WriteLine($"{finite} {Curve.Hex(infinity)}");
+
+            var negated = Curve.G();
+            finite = Bflat.Zkvm.ZkPrecompiles.Secp256k1Multiply(ref negated,
+                [0xBFD25E8CD0364140, 0xBAAEDCE6AF48A03B, 0xFFFFFFFFFFFFFFFE, 0xFFFFFFFFFFFFFFFF]);
+            System.Console.WriteLine($"{finite} {Curve.Hex(negated)}");
+            """ + Point;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run(
+            "False " + G + Environment.NewLine +
+            "True 79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798 " +
+            "b7c52588d95c3b9aa25b0403f1eef75702e84bb7597aabe663b82f6f04ef2777" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void WideOperationsKeepTheOverflow()
+    {
+        string source = """
+            var sum = Bflat.Zkvm.ZkArith256.Add(Wide.Max, new(1), out bool carry);
+            System.Console.WriteLine($"{carry} {Wide.Hex(sum)}");
+            var low = Bflat.Zkvm.ZkArith256.Multiply(Wide.Max, Wide.Max, out var high);
+            System.Console.WriteLine($"{Wide.Hex(high)} {Wide.Hex(low)}");
+            low = Bflat.Zkvm.ZkArith256.MultiplyAdd(Wide.Max, Wide.Max, Wide.Max, out high);
+            System.Console.WriteLine($"{Wide.Hex(high)} {Wide.Hex(low)}");
+            """ + Wide;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run(
+            "True " + Zero + Environment.NewLine +
+            "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe " + One + Environment.NewLine +
+            Max + " " + Zero + Environment.NewLine);
+    }
+
+    [Fact]
+    public void ModularOperationsReduceTheFullResult()
+    {
+        // Each sum or product here overflows 256 bits before the reduction.
+        string source = """
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.AddMod(Wide.Max, Wide.Max, new(7))));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.MulMod(Wide.Max, Wide.Max, new(7))));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.AddMod(Wide.Max, Wide.Max, Wide.Max)));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.MulMod(Wide.Max, Wide.Max, Wide.Max)));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.AddMod(Wide.Max, new(1), Wide.Top)));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.MulMod(Wide.Top, new(2), new(3))));
+            """ + Wide;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run(
+            "0000000000000000000000000000000000000000000000000000000000000002" + Environment.NewLine +
+            One + Environment.NewLine +
+            Zero + Environment.NewLine +
+            Zero + Environment.NewLine +
+            Zero + Environment.NewLine +
+            One + Environment.NewLine);
+    }
+
+    [Fact]
+    public void ModularOperationsFollowTheEvmEdgeCases()
+    {
+        // A zero modulus gives zero for ADDMOD/MULMOD but means 2^256 for
+        // ExpMod; 0^0 is 1 before the reduction.
+        string source = """
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.AddMod(Wide.Max, new(1), new(0))));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.MulMod(Wide.Max, Wide.Max, new(0))));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.ExpMod(new(2), new(300), new(0))));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.ExpMod(new(3), Wide.Top, new(0))));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.ExpMod(new(3), new(10), new(1000))));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.ExpMod(new(0), new(0), new(0))));
+            System.Console.WriteLine(Wide.Hex(Bflat.Zkvm.ZkArith256.ExpMod(new(0), new(0), new(1))));
+            """ + Wide;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run(
+            Zero + Environment.NewLine +
+            Zero + Environment.NewLine +
+            Zero + Environment.NewLine +
+            One + Environment.NewLine +
+            "0000000000000000000000000000000000000000000000000000000000000031" + Environment.NewLine +
+            One + Environment.NewLine +
+            Zero + Environment.NewLine);
+    }
+}
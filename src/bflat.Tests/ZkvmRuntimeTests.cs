@@ -0,0 +1,209 @@
+using System;
+using System.IO;
+using Xunit;
+
+namespace bflat.Tests;
+
+// Runtime behaviour of the zkVM modules, checked on zisk_sim guests.
+public class ZkvmRuntimeTests
+{
+    // Appended after the top-level statements of a test program.
+    private const string Heap = """
+
+        static class Heap
+        {
+            [System.Runtime.InteropServices.DllImport("*")]
+            public static extern nint zk_heap_mark();
+
+            [System.Runtime.InteropServices.DllImport("*")]
+            public static extern void zk_heap_reset(nint mark);
+
+            public static nint Address(byte[] a) =>
+                System.Runtime.InteropServices.Marshal.UnsafeAddrOfPinnedArrayElement(a, 0);
+        }
+        """;
+
+    [Fact]
+    public void HeapResetReleasesLargeBlocks()
+    {
+        string source = """
+            nint mark = Heap.zk_heap_mark();
+            nint first = Heap.Address(new byte[64 * 1024]);
+            Heap.zk_heap_reset(mark);
+            nint second = Heap.Address(new byte[64 * 1024]);
+            System.Console.WriteLine(first == second ? "reused" : "leaked");
+            """ + Heap;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run("reused" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void ArenaReleasesLargeBlocks()
+    {
+        string source = """
+            static nint Scope()
+            {
+                using var arena = Bflat.Zkvm.ZkArena.Enter();
+                byte[] big = new byte[64 * 1024];
+                big[big.Length - 1] = 1;
+                return Heap.Address(big);
+            }
+
+            nint first = Scope();
+            nint second = Scope();
+            byte[] after = new byte[64 * 1024];
+            System.Console.WriteLine(first == second && Heap.Address(after) == first && after[after.Length - 1] == 0 ? "reused" : "leaked");
+            """ + Heap;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run("reused" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void ThreadStaticsSurviveArenaReset()
+    {
+        string source = """
+            using (Bflat.Zkvm.ZkArena.Enter())
+            {
+                Holder.Value = 42;
+            }
+
+            var junk = new long[64];
+            System.Array.Fill(junk, -1);
+            System.Console.WriteLine(Holder.Value);
+
+            static class Holder
+            {
+                [System.ThreadStatic] public static long Value;
+            }
+            """;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run("42" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void ThreadStaticKeepsObjectAliveAcrossCollection()
+    {
+        string source = """
+            Holder.Value = new long[] { 1, 2, 3, 4 };
+            System.GC.Collect();
+
+            for (int i = 0; i < 1000; i++)
+                System.Array.Fill(new long[4], -1);
+
+            long[] kept = Holder.Value;
+            System.Console.WriteLine(kept[0] + kept[1] + kept[2] + kept[3]);
+
+            static class Holder
+            {
+                [System.ThreadStatic] public static long[] Value;
+            }
+            """;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim --zkvm-gc").Run("10" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void ThreadStaticInitializerReadsBack()
+    {
+        string source = """
+            System.Console.WriteLine(Holder.Value + Holder.Name);
+
+            static class Holder
+            {
+                [System.ThreadStatic] public static int Value = 42;
+                [System.ThreadStatic] public static string Name = "x";
+            }
+            """;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim").Run("42x" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void ZiskMapsTdataInLoadSegment()
+    {
+        // ZisK only maps PT_LOAD segments, so the initial TLS image must sit
+        // in one of them, not just in PT_TLS.
+        var result = new BflatCompilation().Build("System.Console.WriteLine(1);", "--libc zisk");
+        ElfFile elf = ElfFile.Read(result.BinaryName);
+        ElfFile.Section tdata = elf.Find(".tdata");
+        Assert.NotNull(tdata);
+
+        byte[] image = elf.Image;
+        ulong phoff = ElfFile.RdU64(image, 0x20);
+        int phnum = ElfFile.RdU16(image, 0x38);
+        bool loaded = false;
+        for (int i = 0; i < phnum; i++)
+        {
+            int ph = (int)phoff + i * 56;
+            ulong vaddr = ElfFile.RdU64(image, ph + 16);
+            ulong filesz = ElfFile.RdU64(image, ph + 32);
+            if (ElfFile.RdU32(image, ph) == 1 /* PT_LOAD */ &&
+                tdata.Addr >= vaddr && tdata.Addr + tdata.Size <= vaddr + filesz)
+                loaded = true;
+        }
+        Assert.True(loaded);
+    }
+
+    [Fact]
+    public void FreelistRecyclesFreedBlocks()
+    {
+        string source = """
+            using System.Runtime.InteropServices;
+
+            nint first = Marshal.AllocHGlobal(100);
+            for (int i = 0; i < 100; i++)
+                Marshal.WriteByte(first, i, 0xAB);
+            Marshal.FreeHGlobal(first);
+
+            nint second = Marshal.AllocHGlobal(100);
+            bool zeroed = true;
+            for (int i = 0; i < 100; i++)
+                zeroed &= Marshal.ReadByte(second, i) == 0;
+            System.Console.WriteLine(second == first && zeroed ? "recycled" : "fresh");
+            """;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim --zkvm-freelist").Run("recycled" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void EagerCctorSeesStartupState()
+    {
+        // The schedule runs after the startup code has set up the command
+        // line and the AppContext switches from the runtime configuration.
+        string source = """
+            System.Console.WriteLine($"{Startup.Args} {Startup.Invariant}");
+
+            static class Startup
+            {
+                public static readonly int Args = System.Environment.GetCommandLineArgs().Length;
+                public static readonly bool Invariant =
+                    System.AppContext.TryGetSwitch("System.Globalization.Invariant", out bool on) && on;
+            }
+            """;
+
+        var result = new BflatCompilation().Build(source, "--libc zisk_sim --zkvm-eager-cctors");
+        string report = File.ReadAllText(Path.ChangeExtension(result.BinaryName, ".cctors.txt"));
+        Assert.Contains(report.Split('\n'), line => line.StartsWith("eager  Startup:", StringComparison.Ordinal));
+        result.Run("1 True" + Environment.NewLine);
+    }
+
+    [Fact]
+    public void EagerCctorThatThrowsFailsAtFirstAccess()
+    {
+        string source = """
+            System.Console.WriteLine("start");
+            System.Exception thrown = Bflat.Zkvm.ZkTry.Run(() => System.Console.WriteLine(Thrower.Value));
+            System.Console.WriteLine(thrown != null ? "caught" : "completed");
+
+            static class Thrower
+            {
+                public static readonly int Value = Fail();
+
+                static int Fail() => throw new System.InvalidOperationException();
+            }
+            """;
+
+        new BflatCompilation().Build(source, "--libc zisk_sim --zkvm-eager-cctors")
+            .Run("start" + Environment.NewLine + "caught" + Environment.NewLine);
+    }
+}
@@ -0,0 +1,203 @@
+// bflat C# compiler
+// Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+using System;
+using System.Collections.Generic;
+using System.CommandLine;
+using System.CommandLine.Parsing;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+
+// Turns the allocation profile of a `--zkvm-alloc-profile` build into a report.
+//
+// The profiling flavour of pal prints raw `ZKALLOC` lines on stderr at exit:
+//   ZKALLOC heap size=<n> high_water=<n> remaining=<n> dropped=<n>
+//   ZKALLOC type <MethodTable address> <objects> <bytes>
+//   ZKALLOC site <return address> <objects> <bytes>
+//   ZKALLOC counter <name>=<n> ...   (other modules' profiling counters)
+// This command resolves the addresses against the guest's ELF symbol table
+// (the same ElfSymbolReader as --symchart) and ranks them by bytes.
+internal class AllocProfileCommand : CommandBase
+{
+    private AllocProfileCommand() { }
+
+    private static readonly Argument<string> GuestArgument =
+        new Argument<string>("guest-elf")
+        { Description = "Guest ELF built with --zkvm-alloc-profile." };
+    private static readonly Argument<string> LogArgument =
+        new Argument<string>("log")
+        { Description = "Captured stderr of the guest run (lines other than ZKALLOC are ignored)." };
+    private static readonly Option<int> TopOption =
+        new Option<int>("--top", () => 30, "Number of types and call sites to list");
+
+    public static Command Create()
+    {
+        var command = new Command("allocprof",
+            "Symbolises the allocation profile of a --zkvm-alloc-profile guest run")
+        {
+            GuestArgument,
+            LogArgument,
+            TopOption,
+        };
+        command.Handler = new AllocProfileCommand();
+        return command;
+    }
+
+    private sealed class Entry
+    {
+        public ulong Key, Count, Bytes;
+    }
+
+    public override int Handle(ParseResult result)
+    {
+        string guestPath = result.GetValueForArgument(GuestArgument);
+        string logPath = result.GetValueForArgument(LogArgument);
+        int top = result.GetValueForOption(TopOption);
+
+        var types = new List<Entry>();
+        var sites = new List<Entry>();
+        string heapLine = null;
+        var counters = new List<string>();
+
+        foreach (string rawLine in File.ReadLines(logPath))
+        {
+            int at = rawLine.IndexOf("ZKALLOC ", StringComparison.Ordinal);
+            if (at < 0)
+                continue;
+
+            string[] parts = rawLine[(at + "ZKALLOC ".Length)..].Split(' ', StringSplitOptions.RemoveEmptyEntries);
+            if (parts.Length > 1 && parts[0] == "heap")
+            {
+                heapLine = string.Join(" ", parts, 1, parts.Length - 1);
+            }
+            else if (parts.Length > 1 && parts[0] == "counter")
+            {
+                counters.AddRange(parts.Skip(1).Select(c => c.Replace('=', ' ')));
+            }
+            else if (parts.Length == 4 && (parts[0] == "type" || parts[0] == "site")
+                && TryParseHex(parts[1], out ulong key)
+                && ulong.TryParse(parts[2], NumberStyles.None, CultureInfo.InvariantCulture, out ulong count)
+                && ulong.TryParse(parts[3], NumberStyles.None, CultureInfo.InvariantCulture, out ulong bytes))
+            {
+                (parts[0] == "type" ? types : sites).Add(new Entry { Key = key, Count = count, Bytes = bytes });
+            }
+        }
+
+        if (heapLine == null)
+        {
+            Console.Error.WriteLine($"No ZKALLOC report in {logPath}; was the guest built with --zkvm-alloc-profile and run to exit?");
+            return 1;
+        }
+
+        var symbols = ElfSymbolReader.ReadBinary(guestPath);
+        if (symbols == null)
+            return 1;
+
+        var index = symbols
+            .Where(s => s.SectionIndex != "UND" && s.Address != 0
+                     && !string.IsNullOrWhiteSpace(s.Name)
+                     && s.Type is not "SECTION" and not "FILE")
+            .OrderBy(s => s.Address)
+            .ToArray();
+
+        ulong totalCount = types.Aggregate(0UL, (acc, e) => acc + e.Count);
+        ulong totalBytes = types.Aggregate(0UL, (acc, e) => acc + e.Bytes);
+
+        Console.WriteLine($"Heap: {FormatHeap(heapLine)}");
+        Console.WriteLine($"Managed allocations: {totalCount} objects, {SymbolChartGenerator.Fmt((long)totalBytes)}");
+        if (counters.Count > 0)
+            Console.WriteLine($"Counters: {string.Join(", ", counters)}");
+        PrintTable("Types", types, index, top, totalBytes);
+        PrintTable("Call sites", sites, index, top, totalBytes);
+        return 0;
+    }
+
+    private static void PrintTable(string title, List<Entry> entries, ElfSymbol[] index, int top, ulong totalBytes)
+    {
+        Console.WriteLine();
+        Console.WriteLine($"{title} (top {Math.Min(top, entries.Count)} of {entries.Count} by bytes):");
+        Console.WriteLine($"  {"bytes",12} {"%",6} {"objects",10}  symbol");
+        foreach (Entry e in entries.OrderByDescending(e => e.Bytes).ThenBy(e => e.Key).Take(top))
+        {
+            double share = totalBytes == 0 ? 0 : 100.0 * e.Bytes / totalBytes;
+            Console.WriteLine($"  {e.Bytes,12} {share,6:F2} {e.Count,10}  {Symbolize(index, e.Key)}");
+        }
+    }
+
+    // The symbol covering `address` (or the nearest one below it, for
+    // symbols without a size), as name+offset.
+    private static string Symbolize(ElfSymbol[] index, ulong address)
+    {
+        int lo = 0, hi = index.Length - 1, found = -1;
+        while (lo <= hi)
+        {
+            int mid = (lo + hi) >>> 1;
+            if (index[mid].Address <= address)
+            {
+                found = mid;
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid - 1;
+            }
+        }
+
+        if (found < 0)
+            return $"0x{address:x}";
+
+        // Prefer a sized symbol that actually contains the address among
+        // the candidates sharing the nearest start address.
+        ElfSymbol best = index[found];
+        for (int i = found; i >= 0 && index[i].Address == best.Address; i--)
+        {
+            if (index[i].Size != 0)
+            {
+                best = index[i];
+                break;
+            }
+        }
+
+        if (best.Size != 0 && address >= best.Address + best.Size)
+            return $"0x{address:x}";
+
+        ulong offset = address - best.Address;
+        return offset == 0 ? best.Name : $"{best.Name}+0x{offset:x}";
+    }
+
+    private static string FormatHeap(string heapLine)
+    {
+        var fields = new List<string>();
+        foreach (string pair in heapLine.Split(' ', StringSplitOptions.RemoveEmptyEntries))
+        {
+            int eq = pair.IndexOf('=');
+            if (eq > 0 && pair[..eq] != "dropped"
+                && long.TryParse(pair[(eq + 1)..], NumberStyles.None, CultureInfo.InvariantCulture, out long value))
+                fields.Add($"{pair[..eq]} {SymbolChartGenerator.Fmt(value)}");
+            else
+                fields.Add(pair.Replace('=', ' '));
+        }
+        return string.Join(", ", fields);
+    }
+
+    private static bool TryParseHex(string s, out ulong value)
+    {
+        if (s.StartsWith("0x", StringComparison.OrdinalIgnoreCase))
+            s = s[2..];
+        return ulong.TryParse(s, NumberStyles.HexNumber, CultureInfo.InvariantCulture, out value);
+    }
+}
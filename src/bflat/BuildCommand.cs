@@ -22,6 +22,7 @@ using System.CommandLine;
 using System.CommandLine.Help;
 using System.CommandLine.Parsing;
 using System.Diagnostics;
+using System.Globalization;
 using System.Reflection.Metadata;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
@@ -34,6 +35,7 @@ using System.Threading;
 using System.Threading.Tasks;
 
 using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
 using Microsoft.CodeAnalysis.Emit;
 using Microsoft.CodeAnalysis;
 
@@ -129,7 +131,15 @@ internal class BuildCommand : CommandBase
 
     private static Option<bool> NoLinkOption = new Option<bool>("-c", "Produce object file, but don't run linker");
     private static Option<bool> MstatOption = new Option<bool>("--mstat", "Produce MSTAT and DGML files for size analysis");
-    private static Option<bool> SymChartOption = new Option<bool>("--symchart", "Run readelf after linking and generate an HTML symbol-size chart");
+    private static Option<bool> SymChartOption = new Option<bool>("--symchart", "Generate an HTML symbol-size chart from the linked binary's symbol table");
+    private static Option<bool> ZkvmAllocProfileOption = new Option<bool>("--zkvm-alloc-profile", "zisk_sim: link the allocation-profiling runtime, which reports per-type and per-call-site allocations at exit (see 'bflat allocprof')");
+    private static Option<bool> ZkvmGcOption = new Option<bool>("--zkvm-gc", "zisk/zisk_sim: link the explicit mark-sweep collector, so GC.Collect() reclaims unreachable managed objects");
+    private static Option<bool> ZkvmFreelistOption = new Option<bool>("--zkvm-freelist", "zisk/zisk_sim: link the allocator whose malloc reuses blocks passed to free, by size class");
+    private static Option<bool> ZkvmEagerCctorsOption = new Option<bool>("--zkvm-eager-cctors", "zisk/zisk_sim: run the class constructors the compiler could not preinitialize in dependency order before Main, and report them");
+    private static Option<string> StackSizeOption = new Option<string>("--stack-size", "zisk/zisk_sim: stack size in bytes, K/M suffixes allowed (default 4M on zisk, 64K on zisk_sim)");
+    private static Option<bool> ZkvmStackReportOption = new Option<bool>("--zkvm-stack-report", "zisk/zisk_sim: bound the worst-case stack depth from the call graph of the linked program, and report it");
+    private static Option<bool> ZkvmExactDispatchOption = new Option<bool>("--zkvm-exact-dispatch", "zisk/zisk_sim: resolve interface calls with up to five implementations (default three) at build time instead of through dispatch cells, and report the cells left");
+    private static Option<bool> IlcCacheOption = new Option<bool>("--ilc-cache", "Reuse the native object of an earlier build with the same IL, references and compiler options (cache in $BFLAT_ILC_CACHE, default ~/.cache/bflat/ilc)");
     private static Option<bool> WrapCheckOption = new Option<bool>("--wrap-check", "Verify every --wrap= linker flag points to a real symbol; fails the build if any is missing");
     private static Option<string[]> LdFlagsOption = new Option<string[]>(new string[] { "--ldflags" }, "Arguments to pass to the linker");
     private static Option<string[]> MibcOption = new Option<string[]>(new string[] { "--mibc" }, "MIBC profile file(s) for profile-guided optimization");
@@ -160,7 +170,7 @@ internal class BuildCommand : CommandBase
         ArgumentHelpName = "{isa1}[,{isaN}]|native"
     };
 
-    private static Option<string> TargetLibcOption = new Option<string>("--libc", "Target libc (Windows: shcrt|none, Linux: glibc|bionic|musl|zisk|zisk_sim)");
+    private static Option<string> TargetLibcOption = new Option<string>("--libc", "Target libc (Windows: shcrt|none, Linux: glibc|bionic|musl|zisk|zisk_sim); 'zisk,zisk_sim' links both from one compile");
 
     private static Option<string> MapFileOption = new Option<string>("--map", "Generate an object map file")
     {
@@ -177,6 +187,16 @@ internal class BuildCommand : CommandBase
         ArgumentHelpName = "repo:version|pkg.nupkg|pkg.bflat.manifest"
     };
 
+    // Options that only reach the link or the tools after it; they stay out
+    // of the ILC cache key so changing them still reuses the object.
+    private static readonly HashSet<Option> LinkOnlyOptions = new HashSet<Option>
+    {
+        NoLinkOption, LdFlagsOption, CommonOptions.ExtraLd, CommonOptions.KeepObjectOption,
+        CommonOptions.VerbosityOption, CommonOptions.DeterministicOption, PrintCommandsOption,
+        SeparateSymbolsOption, SymChartOption, WrapCheckOption, ExtLibOption, IlcCacheOption, CommonOptions.ServerOption,
+        ZkvmGcOption, ZkvmFreelistOption, ZkvmAllocProfileOption, StackSizeOption, ZkvmStackReportOption,
+    };
+
     public static Command Create()
     {
         var command = new Command("build", "Compiles the specified C# source files into native code")
@@ -221,6 +241,15 @@ internal class BuildCommand : CommandBase
             ExtLibOption,
             SymChartOption,
             WrapCheckOption,
+            ZkvmAllocProfileOption,
+            ZkvmGcOption,
+            ZkvmFreelistOption,
+            ZkvmEagerCctorsOption,
+            ZkvmExactDispatchOption,
+            StackSizeOption,
+            ZkvmStackReportOption,
+            IlcCacheOption,
+            CommonOptions.ServerOption,
         };
         command.Handler = new BuildCommand();
 
@@ -376,12 +405,43 @@ internal class BuildCommand : CommandBase
         string[] inputFiles = CommonOptions.GetInputFiles(userSpecifiedInputFiles);
         string[] defines = result.GetValueForOption(CommonOptions.DefinedSymbolsOption);
         string libc = result.GetValueForOption(TargetLibcOption);
-        if (libc == "zisk")
+        string[] libcTargets = new[] { libc };
+        if (libc != null && libc.Contains(','))
+        {
+            // zisk and zisk_sim only differ at link time: compile once and
+            // link each flavour from the same object.
+            libcTargets = libc.Split(',', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries);
+            if (libcTargets.Any(l => l != "zisk" && l != "zisk_sim") || libcTargets.Distinct().Count() != libcTargets.Length)
+            {
+                Console.Error.WriteLine($"Only zisk and zisk_sim can be built together, not '{libc}'.");
+                return 1;
+            }
+            libc = libcTargets[0];
+        }
+        if (libc == "zisk" && libcTargets.Length == 1)
         {
             var definesList = new List<string>(defines ?? Array.Empty<string>());
             definesList.Add("ZKVM_ZISK");
             defines = definesList.ToArray();
         }
+        string stackSizeStr = result.GetValueForOption(StackSizeOption);
+        long requestedStackSize = 0;
+        if (stackSizeStr != null)
+        {
+            if (!StackDepthAnalysis.TryParseStackSize(stackSizeStr, out requestedStackSize))
+            {
+                Console.Error.WriteLine($"Stack size '{stackSizeStr}' is not valid; use bytes, 0x hex, or a K or M suffix.");
+                return 1;
+            }
+            if (libc != "zisk" && libc != "zisk_sim")
+                Console.Error.WriteLine("Warning: --stack-size only applies to --libc zisk and zisk_sim; ignored");
+        }
+        if ((libc == "zisk" || libc == "zisk_sim") && stdlib == StandardLibType.DotNet && Directory.Exists(ziskLibPath))
+        {
+            // Managed surface of the zkVM modules (e.g. ZkArena), shipped as
+            // sources next to the module objects and compiled with the program.
+            inputFiles = inputFiles.Concat(Directory.GetFiles(ziskLibPath, "*.cs").Order(StringComparer.Ordinal)).ToArray();
+        }
         string[] references = CommonOptions.GetReferencePaths(result.GetValueForOption(CommonOptions.ReferencesOption), stdlib,
             result.GetValueForOption(CommonOptions.NoStdLibRefsOption));
         string[] extraLd = result.GetValueForOption(CommonOptions.ExtraLd);
@@ -427,7 +487,7 @@ internal class BuildCommand : CommandBase
 
         // Handle extlib resolution synchronously - after we know target arch/os/libc
         string[] extLibSpecs = result.GetValueForOption(ExtLibOption);
-        List<string> downloadedLibPaths = new List<string>();
+        var downloadedLibPaths = new List<(string Libc, string Path)>();
         var extLibWrapSymbols = new List<string>();
         bool verbose = result.GetValueForOption(CommonOptions.VerbosityOption);
 
@@ -438,22 +498,23 @@ internal class BuildCommand : CommandBase
             string tempDir = Path.Combine(Path.GetTempPath(), "bflat-extlibs");
 
             foreach (var spec in extLibSpecs)
+            foreach (var extLibc in libcTargets)
             {
                 try
                 {
                     ExtLibResolver.Result extLibResult = ExtLibResolver.Resolve(
-                        spec, tempDir, verbose, targetArchitecture, targetOS, libc).GetAwaiter().GetResult();
+                        spec, tempDir, verbose, targetArchitecture, targetOS, extLibc).GetAwaiter().GetResult();
 
                     if (extLibResult.StaticLibPath != null)
                     {
-                        downloadedLibPaths.Add(extLibResult.StaticLibPath);
+                        downloadedLibPaths.Add((extLibc, extLibResult.StaticLibPath));
 
                         // Patch RISC-V ABI if needed
                         if (targetArchitecture == TargetArchitecture.RiscV64)
                             PatchRiscvAbiStaticLib(extLibResult.StaticLibPath, verbose);
                     }
 
-                    if (extLibResult.DotnetLibPath != null)
+                    if (extLibResult.DotnetLibPath != null && !referenceList.Contains(extLibResult.DotnetLibPath))
                     {
                         referenceList.Add(extLibResult.DotnetLibPath);
                         if (verbose)
@@ -562,6 +623,16 @@ internal class BuildCommand : CommandBase
             result.GetValueForOption(CommonOptions.LangVersionOption));
         createCompilationWatch.Complete();
 
+        // A shared compile cannot honour "#if ZKVM_ZISK": the two outputs
+        // would need different IL.
+        if (libcTargets.Length > 1 && sourceCompilation.SyntaxTrees.Any(tree => ((CSharpSyntaxNode)tree.GetRoot())
+            .GetDirectives(d => d is ConditionalDirectiveTriviaSyntax c && c.Condition.DescendantNodesAndSelf()
+                .OfType<IdentifierNameSyntax>().Any(i => i.Identifier.ValueText == "ZKVM_ZISK")).Count > 0))
+        {
+            Console.Error.WriteLine("Sources test ZKVM_ZISK, so zisk and zisk_sim cannot share a compile; build each --libc separately.");
+            return 1;
+        }
+
         bool nativeLib;
         if (buildTargetType == 0)
         {
@@ -626,12 +697,10 @@ internal class BuildCommand : CommandBase
             }
         }
 
-        if (stdlib != StandardLibType.DotNet)
-        {
-            SettingsTunnel.EmitGCInfo = false;
-            SettingsTunnel.EmitEHInfo = false;
-            SettingsTunnel.EmitGSCookies = false;
-        }
+        // Assigned both ways: the build server runs many builds per process.
+        SettingsTunnel.EmitGCInfo = stdlib == StandardLibType.DotNet;
+        SettingsTunnel.EmitEHInfo = stdlib == StandardLibType.DotNet;
+        SettingsTunnel.EmitGSCookies = stdlib == StandardLibType.DotNet;
 
         Console.WriteLine("Supports reflection: " + supportsReflection.ToString());
         CompilerTypeSystemContext typeSystemContext =
@@ -649,7 +718,6 @@ internal class BuildCommand : CommandBase
         if (targetOS == TargetOS.Windows && targetArchitecture == TargetArchitecture.X86)
             libc ??= "none"; // don't have shcrt for Windows x86 because that one's hacked up
 
-        string patchElfPath = Path.Combine(homePath, "patch_elf.py");
         string libPath = Environment.GetEnvironmentVariable("BFLAT_LIB");
         if (libPath == null)
         {
@@ -711,6 +779,12 @@ internal class BuildCommand : CommandBase
                 Console.WriteLine("Reference file: " + assemblyName + " -> " + reference);
 #endif
             }
+
+            // The zkVM zerolib is built with -d ZKVM: its memory primitives
+            // call the libziskos DMA-accelerated memmove/memset/memcmp.
+            string zkvmZerolib = Path.Combine(ziskLibPath, "zerolib.dll");
+            if (stdlib == StandardLibType.Zero && (libc == "zisk" || libc == "zisk_sim") && File.Exists(zkvmZerolib))
+                referenceFilePaths["zerolib"] = zkvmZerolib;
         }
 
         typeSystemContext.InputFilePaths = new Dictionary<string, string>();
@@ -832,7 +906,7 @@ internal class BuildCommand : CommandBase
             directPinvokes.Add("libsokol");
         }
 
-        if (libc == "zisk")
+        if (libcTargets.Contains("zisk"))
         {
             directPinvokes.Add("__Internal");
         }
@@ -985,6 +1059,60 @@ internal class BuildCommand : CommandBase
             .UseTypeMapManager(typeMapManager)
             .UseResilience(true);
 
+        string objectFilePath = Path.ChangeExtension(outputFilePath, targetOS is TargetOS.Windows or TargetOS.UEFI ? ".obj" : ".o");
+        string exportsFile = nativeLib ? Path.ChangeExtension(outputFilePath, targetOS == TargetOS.Windows ? ".def" : ".txt") : null;
+        string cctorScheduleFile = (libc == "zisk" || libc == "zisk_sim") && stdlib == StandardLibType.DotNet && result.GetValueForOption(ZkvmEagerCctorsOption)
+            ? Path.ChangeExtension(outputFilePath, ".cctors.ld") : null;
+
+        // Files the compile writes besides the object; the cache keeps them with it.
+        var compileSideFiles = new List<string>();
+        if (exportsFile != null)
+            compileSideFiles.Add(exportsFile);
+        if (cctorScheduleFile != null)
+            compileSideFiles.AddRange([cctorScheduleFile, Path.ChangeExtension(outputFilePath, ".cctors.txt")]);
+        if ((libc == "zisk" || libc == "zisk_sim") && useScanner && result.GetValueForOption(ZkvmExactDispatchOption))
+            compileSideFiles.Add(Path.ChangeExtension(outputFilePath, ".dispatch.txt"));
+
+        IlcObjectCache ilcCache = null;
+        if (result.GetValueForOption(IlcCacheOption))
+        {
+            if (result.GetValueForOption(MapFileOption) != null || result.GetValueForOption(MstatOption))
+            {
+                Console.Error.WriteLine("Warning: --map and --mstat are written by the compile itself; --ilc-cache ignored");
+            }
+            else
+            {
+                PerfWatch cacheKeyWatch = new PerfWatch("ILC cache key");
+                ilcCache = new IlcObjectCache(IlcObjectCache.DefaultRoot(), [typeof(ICompilation).Assembly.Location]);
+                ilcCache.AddBytes(ms.GetBuffer().AsSpan(0, (int)ms.Length));
+                foreach (string reference in referenceFilePaths.Keys.Order(StringComparer.Ordinal))
+                    ilcCache.AddFile(referenceFilePaths[reference]);
+                foreach (string file in (mibcFiles ?? Array.Empty<string>()).Concat(directPinvokeList))
+                    ilcCache.AddFile(file);
+                foreach (string pinvoke in directPinvokes)
+                    ilcCache.AddString(pinvoke);
+                foreach (var featureSwitch in featureSwitches.OrderBy(f => f.Key, StringComparer.Ordinal))
+                    ilcCache.AddString($"{featureSwitch.Key}={featureSwitch.Value}");
+                foreach (OptionResult option in result.CommandResult.Children.OfType<OptionResult>())
+                {
+                    if (LinkOnlyOptions.Contains(option.Option))
+                        continue;
+                    ilcCache.AddString(option.Option.Name);
+                    foreach (Token token in option.Tokens)
+                        ilcCache.AddString(token.Value);
+                }
+                cacheKeyWatch.Complete();
+
+                if (ilcCache.TryRestore(objectFilePath, compileSideFiles))
+                {
+                    Console.WriteLine($"ILC cache: reusing {ilcCache.Key}");
+                    if (result.GetValueForOption(NoLinkOption))
+                        return 0;
+                    return LinkAll();
+                }
+            }
+        }
+
         int parallelism = Environment.ProcessorCount;
         ILScanResults scanResults = null;
         if (useScanner)
@@ -1067,6 +1195,27 @@ internal class BuildCommand : CommandBase
             backendOptions.Add("RiscV64ElideLeafRaSave=1");
         }
 
+        // Closed-world interface dispatch. The scanner knows every constructed
+        // type, so ILC can answer the JIT's getExactClasses query with the full
+        // set of implementations of an interface. When that set fits the type
+        // check budget the JIT emits direct calls behind type checks and drops
+        // the fallback, so the call site never touches its dispatch cell and
+        // RhpCidResolve never runs for it. Exact devirtualization is already on
+        // for NativeAOT with a budget of 3 checks (1 under -Os); the option
+        // raises the budget to the JIT's cap. Each extra check costs ROM, hence
+        // opt-in.
+        bool exactDispatch = (libc == "zisk" || libc == "zisk_sim") && result.GetValueForOption(ZkvmExactDispatchOption);
+        if (exactDispatch && scanResults == null)
+        {
+            Console.Error.WriteLine("Warning: --zkvm-exact-dispatch needs the whole-program scanner, which -O0 disables; ignored");
+            exactDispatch = false;
+        }
+        if (exactDispatch)
+        {
+            backendOptions.Add("JitEnableExactDevirtualization=1");
+            backendOptions.Add($"JitGuardedDevirtualizationMaxTypeChecks={ExactDispatchMaxTypeChecks:x}");
+        }
+
         builder
             .UseInstructionSetSupport(instructionSetSupport)
             .UseBackendOptions(backendOptions)
@@ -1155,17 +1304,12 @@ internal class BuildCommand : CommandBase
         if (mstatFileName != null)
             dumpers.Add(new MstatObjectDumper(mstatFileName, typeSystemContext));
 
-        string objectFilePath = Path.ChangeExtension(outputFilePath, targetOS is TargetOS.Windows or TargetOS.UEFI ? ".obj" : ".o");
-        string patchedFilePath = Path.ChangeExtension(outputFilePath, ".patched");
-
         PerfWatch compileWatch = new PerfWatch("Native compile");
         CompilationResults compilationResults = compilation.Compile(objectFilePath, ObjectDumper.Compose(dumpers));
         compileWatch.Complete();
 
-        string exportsFile = null;
-        if (nativeLib)
+        if (exportsFile != null)
         {
-            exportsFile = Path.ChangeExtension(outputFilePath, targetOS == TargetOS.Windows ? ".def" : ".txt");
             ExportsFileWriter defFileWriter = new ExportsFileWriter(typeSystemContext, exportsFile, []);
             foreach (var compilationRoot in compilationRoots)
             {
@@ -1186,6 +1330,26 @@ internal class BuildCommand : CommandBase
 
         preinitManager.LogStatistics(logger);
 
+        if (cctorScheduleFile != null)
+        {
+            string cctorReportFile = Path.ChangeExtension(outputFilePath, ".cctors.txt");
+            // The library initializers have run by the time the schedule
+            // does; what only they trigger already ran lazily, or is unused.
+            MethodDesc[] cctorRoots = [compiledAssembly.EntryPoint];
+            int eagerCount = ClassConstructorSchedule.Write(cctorScheduleFile, cctorReportFile,
+                ((ILCompiler.Compilation)compilation).NodeFactory, compilationResults.CompiledMethodBodies, cctorRoots,
+                preinitManager, ilProvider);
+            Console.WriteLine($"Class constructors: {eagerCount} run eagerly, report in {cctorReportFile}");
+        }
+
+        if (exactDispatch)
+        {
+            WriteDispatchReport(Path.ChangeExtension(outputFilePath, ".dispatch.txt"), objectFilePath,
+                ((ILCompiler.Compilation)compilation).NodeFactory, scanResults.ConstructedEETypes);
+        }
+
+        ilcCache?.Store(objectFilePath, compileSideFiles);
+
         if (result.GetValueForOption(NoLinkOption))
         {
             return 0;
@@ -1195,585 +1359,868 @@ internal class BuildCommand : CommandBase
         // Run the platform linker
         //
 
-        if (targetArchitecture == TargetArchitecture.RiscV64)
+        return LinkAll();
+
+        // Links every --libc target from the object file, then drops the
+        // intermediates. Also the whole back half of a build on a cache hit.
+        int LinkAll()
         {
-            PatchRiscvAbi(objectFilePath);
-        }
+            if (targetArchitecture == TargetArchitecture.RiscV64)
+            {
+                PatchRiscvAbi(objectFilePath);
+            }
 
-        if (logger.IsVerbose)
-            logger.LogMessage("Running the linker");
+            int linkExitCode = 0;
+            foreach (string targetLibc in libcTargets)
+            {
+                string targetOutputFilePath = libcTargets.Length > 1
+                    ? Path.Combine(Path.GetDirectoryName(outputFilePath), $"{Path.GetFileNameWithoutExtension(outputFilePath)}-{targetLibc}{Path.GetExtension(outputFilePath)}")
+                    : outputFilePath;
+                linkExitCode = Link(targetLibc, targetOutputFilePath);
+                if (linkExitCode != 0)
+                    break;
+            }
 
-        string ld = Environment.GetEnvironmentVariable("BFLAT_LD");
-        if (ld == null)
-        {
-            string toolSuffix = RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ".exe" : "";
+            if (!result.GetValueForOption(CommonOptions.KeepObjectOption))
+            {
+                try { File.Delete(objectFilePath); } catch { }
+            }
 
-            ld = Path.Combine(homePath, "bin", "lld" + toolSuffix);
-        }
+            if (exportsFile != null)
+                try { File.Delete(exportsFile); } catch { }
 
-        bool deterministic = result.GetValueForOption(CommonOptions.DeterministicOption);
+            if (cctorScheduleFile != null && !result.GetValueForOption(CommonOptions.KeepObjectOption))
+                try { File.Delete(cctorScheduleFile); } catch { }
 
-        var ldArgs = new StringBuilder();
+            return linkExitCode;
+        }
 
-        if (targetOS is TargetOS.Windows or TargetOS.UEFI)
+        // Links (and for zisk, post-processes) one output from the shared
+        // object file. Runs once per --libc target.
+        int Link(string libc, string outputFilePath)
         {
-            ldArgs.Append("-flavor link \"");
-            ldArgs.Append(objectFilePath);
-            ldArgs.Append("\" ");
-            ldArgs.AppendFormat("/out:\"{0}\" ", outputFilePath);
-            if (deterministic)
-                ldArgs.Append("/Brepro ");
+            string patchedFilePath = Path.ChangeExtension(outputFilePath, ".patched");
+            long stackSize = stackSizeStr != null ? requestedStackSize : libc == "zisk" ? 0x400000 : 64 * 1024;
+
+            if (logger.IsVerbose)
+                logger.LogMessage("Running the linker");
 
-            foreach (var lpath in libPath.Split(RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ';' : ':'))
+            string ld = Environment.GetEnvironmentVariable("BFLAT_LD");
+            if (ld == null)
             {
-                ldArgs.AppendFormat("/libpath:\"{0}\" ", lpath);
+                string toolSuffix = RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ".exe" : "";
+
+                ld = Path.Combine(homePath, "bin", "lld" + toolSuffix);
             }
 
-            if (targetOS == TargetOS.UEFI)
-                ldArgs.Append("/subsystem:EFI_APPLICATION ");
-            else if (buildTargetType == BuildTargetType.Exe)
-                ldArgs.Append("/subsystem:console ");
-            else if (buildTargetType == BuildTargetType.WinExe)
-                ldArgs.Append("/subsystem:windows ");
+            bool deterministic = result.GetValueForOption(CommonOptions.DeterministicOption);
 
-            if (targetOS == TargetOS.UEFI)
-            {
-                ldArgs.Append("/entry:EfiMain ");
-            }
-            else if (buildTargetType is BuildTargetType.Exe or BuildTargetType.WinExe)
+            var ldArgs = new StringBuilder();
+
+            if (targetOS is TargetOS.Windows or TargetOS.UEFI)
             {
+                ldArgs.Append("-flavor link \"");
+                ldArgs.Append(objectFilePath);
+                ldArgs.Append("\" ");
+                ldArgs.AppendFormat("/out:\"{0}\" ", outputFilePath);
+                if (deterministic)
+                    ldArgs.Append("/Brepro ");
+
+                foreach (var lpath in libPath.Split(RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ';' : ':'))
+                {
+                    ldArgs.AppendFormat("/libpath:\"{0}\" ", lpath);
+                }
+
+                if (targetOS == TargetOS.UEFI)
+                    ldArgs.Append("/subsystem:EFI_APPLICATION ");
+                else if (buildTargetType == BuildTargetType.Exe)
+                    ldArgs.Append("/subsystem:console ");
+                else if (buildTargetType == BuildTargetType.WinExe)
+                    ldArgs.Append("/subsystem:windows ");
+
+                if (targetOS == TargetOS.UEFI)
+                {
+                    ldArgs.Append("/entry:EfiMain ");
+                }
+                else if (buildTargetType is BuildTargetType.Exe or BuildTargetType.WinExe)
+                {
+                    if (stdlib == StandardLibType.DotNet)
+                        ldArgs.Append("/entry:wmainCRTStartup bootstrapper.obj ");
+                    else
+                        ldArgs.Append("/entry:__managed__Main ");
+
+                    if (result.GetValueForOption(NoPieOption) && targetArchitecture != TargetArchitecture.ARM64)
+                        ldArgs.Append("/fixed ");
+                }
+                else if (buildTargetType is BuildTargetType.Shared)
+                {
+                    ldArgs.Append("/dll ");
+                    if (stdlib == StandardLibType.DotNet)
+                        ldArgs.Append("bootstrapperdll.obj ");
+                    ldArgs.Append($"/def:\"{exportsFile}\" ");
+                }
+
+                ldArgs.Append("/incremental:no ");
+                if (debugInfoFormat != 0)
+                    ldArgs.Append("/debug ");
                 if (stdlib == StandardLibType.DotNet)
-                    ldArgs.Append("/entry:wmainCRTStartup bootstrapper.obj ");
+                {
+                    ldArgs.Append("Runtime.WorkstationGC.lib System.IO.Compression.Native.Aot.lib System.Globalization.Native.Aot.lib ");
+                }
                 else
-                    ldArgs.Append("/entry:__managed__Main ");
+                {
+                    ldArgs.Append("/merge:.modules=.rdata ");
+                    ldArgs.Append("/merge:.managedcode=.text ");
 
-                if (result.GetValueForOption(NoPieOption) && targetArchitecture != TargetArchitecture.ARM64)
-                    ldArgs.Append("/fixed ");
-            }
-            else if (buildTargetType is BuildTargetType.Shared)
-            {
-                ldArgs.Append("/dll ");
-                if (stdlib == StandardLibType.DotNet)
-                    ldArgs.Append("bootstrapperdll.obj ");
-                ldArgs.Append($"/def:\"{exportsFile}\" ");
-            }
+                    if (stdlib == StandardLibType.Zero)
+                    {
+                        if (targetArchitecture is TargetArchitecture.ARM64 or TargetArchitecture.X86
+                            or TargetArchitecture.RiscV64
+                            )
+                            ldArgs.Append("zerolibnative.obj ");
+                    }
+                }
+                if (targetOS == TargetOS.Windows)
+                {
+                    if (targetArchitecture != TargetArchitecture.X86)
+                        ldArgs.Append("sokol.lib ");
+                    ldArgs.Append("advapi32.lib bcrypt.lib crypt32.lib iphlpapi.lib kernel32.lib mswsock.lib ncrypt.lib normaliz.lib  ntdll.lib ole32.lib oleaut32.lib user32.lib version.lib ws2_32.lib shell32.lib Secur32.Lib ");
 
-            ldArgs.Append("/incremental:no ");
-            if (debugInfoFormat != 0)
-                ldArgs.Append("/debug ");
-            if (stdlib == StandardLibType.DotNet)
-            {
-                ldArgs.Append("Runtime.WorkstationGC.lib System.IO.Compression.Native.Aot.lib System.Globalization.Native.Aot.lib ");
-            }
-            else
-            {
-                ldArgs.Append("/merge:.modules=.rdata ");
-                ldArgs.Append("/merge:.managedcode=.text ");
+                    if (libc != "none")
+                    {
+                        ldArgs.Append("shcrt.lib ");
+                        ldArgs.Append("api-ms-win-crt-conio-l1-1-0.lib api-ms-win-crt-convert-l1-1-0.lib api-ms-win-crt-environment-l1-1-0.lib ");
+                        ldArgs.Append("api-ms-win-crt-filesystem-l1-1-0.lib api-ms-win-crt-heap-l1-1-0.lib api-ms-win-crt-locale-l1-1-0.lib ");
+                        ldArgs.Append("api-ms-win-crt-multibyte-l1-1-0.lib api-ms-win-crt-math-l1-1-0.lib ");
+                        ldArgs.Append("api-ms-win-crt-process-l1-1-0.lib api-ms-win-crt-runtime-l1-1-0.lib api-ms-win-crt-stdio-l1-1-0.lib ");
+                        ldArgs.Append("api-ms-win-crt-string-l1-1-0.lib api-ms-win-crt-time-l1-1-0.lib api-ms-win-crt-utility-l1-1-0.lib ");
+                    }
+                }
+                ldArgs.Append("/opt:ref,icf /nodefaultlib:libcpmt.lib ");
+
+                if (result.GetValueForOption(LtoOption))
+                {
+                    ldArgs.Append("/ltcg ");
+                }
 
-                if (stdlib == StandardLibType.Zero)
+                // Add downloaded external libraries for Windows
+                foreach (var (extLibc, extLibPath) in downloadedLibPaths)
                 {
-                    if (targetArchitecture is TargetArchitecture.ARM64 or TargetArchitecture.X86
-                        or TargetArchitecture.RiscV64
-                        )
-                        ldArgs.Append("zerolibnative.obj ");
+                    if (extLibc == libc)
+                        ldArgs.Append($"\"{extLibPath}\" ");
                 }
             }
-            if (targetOS == TargetOS.Windows)
+            else if (targetOS == TargetOS.Linux)
             {
-                if (targetArchitecture != TargetArchitecture.X86)
-                    ldArgs.Append("sokol.lib ");
-                ldArgs.Append("advapi32.lib bcrypt.lib crypt32.lib iphlpapi.lib kernel32.lib mswsock.lib ncrypt.lib normaliz.lib  ntdll.lib ole32.lib oleaut32.lib user32.lib version.lib ws2_32.lib shell32.lib Secur32.Lib ");
+                ldArgs.Append("-flavor ld ");
+                ldArgs.Append("--no-relax ");
 
-                if (libc != "none")
+                if (result.GetValueForOption(LtoOption))
                 {
-                    ldArgs.Append("shcrt.lib ");
-                    ldArgs.Append("api-ms-win-crt-conio-l1-1-0.lib api-ms-win-crt-convert-l1-1-0.lib api-ms-win-crt-environment-l1-1-0.lib ");
-                    ldArgs.Append("api-ms-win-crt-filesystem-l1-1-0.lib api-ms-win-crt-heap-l1-1-0.lib api-ms-win-crt-locale-l1-1-0.lib ");
-                    ldArgs.Append("api-ms-win-crt-multibyte-l1-1-0.lib api-ms-win-crt-math-l1-1-0.lib ");
-                    ldArgs.Append("api-ms-win-crt-process-l1-1-0.lib api-ms-win-crt-runtime-l1-1-0.lib api-ms-win-crt-stdio-l1-1-0.lib ");
-                    ldArgs.Append("api-ms-win-crt-string-l1-1-0.lib api-ms-win-crt-time-l1-1-0.lib api-ms-win-crt-utility-l1-1-0.lib ");
+                    ldArgs.Append("--lto=full --lto-O3 ");
                 }
-            }
-            ldArgs.Append("/opt:ref,icf /nodefaultlib:libcpmt.lib ");
 
-            if (result.GetValueForOption(LtoOption))
-            {
-                ldArgs.Append("/ltcg ");
-            }
+                string ziskSimLibPath = Path.Combine(homePath, "lib", "linux", "riscv64", "zisk_sim");
 
-            // Add downloaded external libraries for Windows
-            foreach (var extLibPath in downloadedLibPaths)
-            {
-                ldArgs.Append($"\"{extLibPath}\" ");
-            }
-        }
-        else if (targetOS == TargetOS.Linux)
-        {
-            ldArgs.Append("-flavor ld ");
-            ldArgs.Append("--no-relax ");
+                string firstLib = null;
+                foreach (var lpath in libPath.Split(RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ';' : ':'))
+                {
+                    ldArgs.AppendFormat("-L\"{0}\" ", lpath);
+                    if (firstLib == null)
+                        firstLib = lpath;
+                }
 
-            if (result.GetValueForOption(LtoOption))
-            {
-                ldArgs.Append("--lto=full --lto-O3 ");
-            }
+                ldArgs.Append("-z now -z relro -z noexecstack --hash-style=gnu --eh-frame-hdr -z nostart-stop-gc ");
 
-            string ziskSimLibPath = Path.Combine(homePath, "lib", "linux", "riscv64", "zisk_sim");
+                if (targetArchitecture == TargetArchitecture.ARM64)
+                    ldArgs.Append("-EL --fix-cortex-a53-843419 ");
 
-            string firstLib = null;
-            foreach (var lpath in libPath.Split(RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ';' : ':'))
-            {
-                ldArgs.AppendFormat("-L\"{0}\" ", lpath);
-                if (firstLib == null)
-                    firstLib = lpath;
-            }
+                if (libc == "bionic")
+                    ldArgs.Append("--warn-shared-textrel -z max-page-size=4096 --enable-new-dtags ");
+
+                if (buildTargetType != BuildTargetType.Shared)
+                {
+                    if (libc == "bionic")
+                    {
+                        ldArgs.Append("-dynamic-linker /system/bin/linker64 ");
+                        ldArgs.Append($"\"{firstLib}/crtbegin_dynamic.o\" ");
+                    }
+                    else if (libc == "musl" || libc == "zisk" || libc == "zisk_sim")
+                    {
+                        ldArgs.Append("-static ");
+                        if (libc == "zisk" || libc == "zisk_sim")
+                        {
+                            ldArgs.Append($"\"{ziskLibPath}/crt1.o\" ");
+                            PatchRiscvAbi(ziskLibPath + "/crt1.o");
+                        }
+                        else
+                            ldArgs.Append($"\"{firstLib}/crt1.o\" ");
+                        ldArgs.Append($"\"{firstLib}/crti.o\" ");
+                        if (libc == "zisk" || libc == "zisk_sim")
+                        {
+                            PatchRiscvAbi(firstLib + "/crti.o");
+                        }
+                    }
+                    else
+                    {
+                        if (targetArchitecture == TargetArchitecture.ARM64)
+                            ldArgs.Append("-dynamic-linker /lib/ld-linux-aarch64.so.1 ");
+                        else if (targetArchitecture == TargetArchitecture.RiscV64)
+                            ldArgs.Append("-dynamic-linker /lib/ld-linux-riscv64-lp64d.so.1 ");
+                        else
+                            ldArgs.Append("-dynamic-linker /lib64/ld-linux-x86-64.so.2 ");
+                        ldArgs.Append($"\"{firstLib}/Scrt1.o\" ");
+                    }
+                    if (stdlib != StandardLibType.DotNet)
+                        ldArgs.Append("--defsym=main=__managed__Main ");
+                }
+                else
+                {
+                    if (libc == "bionic")
+                    {
+                        ldArgs.Append($"\"{firstLib}/crtbegin_so.o\" ");
+                    }
+                }
 
-            ldArgs.Append("-z now -z relro -z noexecstack --hash-style=gnu --eh-frame-hdr -z nostart-stop-gc ");
+                ldArgs.AppendFormat("-o \"{0}\" ", outputFilePath);
 
-            if (targetArchitecture == TargetArchitecture.ARM64)
-                ldArgs.Append("-EL --fix-cortex-a53-843419 ");
+                if (libc != "bionic" && libc != "musl" && libc != "zisk" &&
+                    libc != "zisk_sim")
+                {
+                    ldArgs.Append($"\"{firstLib}/crti.o\" ");
+                    ldArgs.Append($"\"{firstLib}/crtbeginS.o\" ");
+                }
 
-            if (libc == "bionic")
-                ldArgs.Append("--warn-shared-textrel -z max-page-size=4096 --enable-new-dtags ");
+                ldArgs.Append('"');
+                ldArgs.Append(objectFilePath);
+                ldArgs.Append('"');
+                ldArgs.Append(' ');
+                ldArgs.Append("--as-needed --gc-sections ");
+                ldArgs.Append("-rpath \"$ORIGIN\" ");
 
-            if (buildTargetType != BuildTargetType.Shared)
-            {
-                if (libc == "bionic")
+                if (buildTargetType == BuildTargetType.Shared)
+                {
+                    if (stdlib == StandardLibType.DotNet)
+                    {
+                        ldArgs.Append($"\"{firstLib}/libbootstrapperdll.o\" ");
+                    }
+
+                    ldArgs.Append("-shared ");
+                    ldArgs.Append($"--version-script=\"{exportsFile}\" ");
+                }
+                else
                 {
-                    ldArgs.Append("-dynamic-linker /system/bin/linker64 ");
-                    ldArgs.Append($"\"{firstLib}/crtbegin_dynamic.o\" ");
+                    if (stdlib == StandardLibType.DotNet)
+                        ldArgs.Append($"\"{firstLib}/libbootstrapper.o\" ");
+
+                    if (result.GetValueForOption(NoPieOption))
+                        ldArgs.Append("--no-pie ");
+                    else
+                        ldArgs.Append("-pie ");
+                }
+
+                if (stdlib != StandardLibType.None)
+                {
+                    ldArgs.Append("-lSystem.Native ");
+                    if (stdlib == StandardLibType.DotNet)
+                    {
+                        ldArgs.Append("-latomic ");
+                        ldArgs.Append("-leventpipe-disabled ");
+                        ldArgs.Append("-laotminipal -lstandalonegc-disabled ");
+                        ldArgs.Append("-lstdc++compat -lRuntime.WorkstationGC -lSystem.IO.Compression.Native -lSystem.Security.Cryptography.Native.OpenSsl ");
+                        if (libc != "bionic")
+                            ldArgs.Append("-lSystem.Globalization.Native ");
+                    }
+                    else if (stdlib == StandardLibType.Zero)
+                    {
+                        if (targetArchitecture == TargetArchitecture.ARM64 || targetArchitecture == TargetArchitecture.RiscV64)
+                            ldArgs.Append($"\"{firstLib}/libzerolibnative.o\" ");
+                    }
+                }
+
+                ldArgs.Append("--as-needed -ldl -lm -lz -z relro -z now --discard-all --gc-sections ");
+                if (libc != "musl" && libc != "zisk" && libc != "zisk_sim")
+                {
+                    ldArgs.Append("-lc -lgcc ");
+                }
+
+                if (libc != "bionic" && libc != "musl" && libc != "zisk" &&
+                    libc != "zisk_sim")
+                {
+                    ldArgs.Append("-lrt --as-needed -lgcc_s --no-as-needed ");
+                    if (!result.GetValueForOption(CommonOptions.NoPthreadOption))
+                        ldArgs.Append("-lpthread ");
                 }
                 else if (libc == "musl" || libc == "zisk" || libc == "zisk_sim")
                 {
-                    ldArgs.Append("-static ");
-                    if (libc == "zisk" || libc == "zisk_sim")
+                    ldArgs.Append($"\"{firstLib}/libc.a\" ");
+                }
+
+                if (libc == "bionic")
+                {
+                    if (buildTargetType == BuildTargetType.Shared)
                     {
-                        ldArgs.Append($"\"{ziskLibPath}/crt1.o\" ");
-                        PatchRiscvAbi(ziskLibPath + "/crt1.o");
+                        ldArgs.Append($"\"{firstLib}/crtend_so.o\" ");
                     }
                     else
-                        ldArgs.Append($"\"{firstLib}/crt1.o\" ");
-                    ldArgs.Append($"\"{firstLib}/crti.o\" ");
-                    if (libc == "zisk" || libc == "zisk_sim")
                     {
-                        PatchRiscvAbi(firstLib + "/crti.o");
+                        ldArgs.Append($"\"{firstLib}/crtend_android.o\" ");
                     }
                 }
+                else if (libc == "musl" || libc == "zisk" || libc == "zisk_sim")
+                {
+                    ldArgs.Append($"\"{firstLib}/crtn.o\" ");
+                }
                 else
                 {
-                    if (targetArchitecture == TargetArchitecture.ARM64)
-                        ldArgs.Append("-dynamic-linker /lib/ld-linux-aarch64.so.1 ");
-                    else if (targetArchitecture == TargetArchitecture.RiscV64)
-                        ldArgs.Append("-dynamic-linker /lib/ld-linux-riscv64-lp64d.so.1 ");
-                    else
-                        ldArgs.Append("-dynamic-linker /lib64/ld-linux-x86-64.so.2 ");
-                    ldArgs.Append($"\"{firstLib}/Scrt1.o\" ");
+                    ldArgs.Append($"\"{firstLib}/crtendS.o\" ");
+                    ldArgs.Append($"\"{firstLib}/crtn.o\" ");
                 }
-                if (stdlib != StandardLibType.DotNet)
-                    ldArgs.Append("--defsym=main=__managed__Main ");
-            }
-            else
-            {
-                if (libc == "bionic")
+
+                foreach (var ldArg in extraLd)
                 {
-                    ldArgs.Append($"\"{firstLib}/crtbegin_so.o\" ");
+                    ldArgs.Append(ldArg.Replace("{libpath}", firstLib) + " ");
                 }
-            }
 
-            ldArgs.AppendFormat("-o \"{0}\" ", outputFilePath);
+                // Add downloaded external libraries for Linux
+                foreach (var (extLibc, extLibPath) in downloadedLibPaths)
+                {
+                    if (extLibc == libc)
+                        ldArgs.Append($"\"{extLibPath}\" ");
+                }
 
-            if (libc != "bionic" && libc != "musl" && libc != "zisk" &&
-                libc != "zisk_sim")
-            {
-                ldArgs.Append($"\"{firstLib}/crti.o\" ");
-                ldArgs.Append($"\"{firstLib}/crtbeginS.o\" ");
-            }
+                // Add --wrap flags for symbols requested by external libraries
+                foreach (var sym in extLibWrapSymbols)
+                {
+                    ldArgs.Append($"--wrap={sym} ");
+                }
+
+                if (libc == "musl")
+                {
+                    /* hack, no fp must be built properly */
+                    ldArgs.Append($"\"{Path.Combine(firstLib, "nofp.o")}\" ");
+                }
 
-            ldArgs.Append('"');
-            ldArgs.Append(objectFilePath);
-            ldArgs.Append('"');
-            ldArgs.Append(' ');
-            ldArgs.Append("--as-needed --gc-sections ");
-            ldArgs.Append("-rpath \"$ORIGIN\" ");
 
-            if (buildTargetType == BuildTargetType.Shared)
-            {
-                if (stdlib == StandardLibType.DotNet)
+                // zisk_sim links the sim flavour of a module (lib/.../zisk_sim/<name>)
+                // when one is shipped and falls back to the zisk object otherwise.
+                // Build options can ask for a module flavour (<name>.<variant>.o),
+                // which wins where it exists.
+                bool zkvmGc = result.GetValueForOption(ZkvmGcOption);
+                bool allocProfile = libc == "zisk_sim" && result.GetValueForOption(ZkvmAllocProfileOption);
+                if (!allocProfile && result.GetValueForOption(ZkvmAllocProfileOption))
+                    Console.Error.WriteLine("Warning: --zkvm-alloc-profile only applies to --libc zisk_sim; ignored");
+                if (allocProfile && zkvmGc)
                 {
-                    ldArgs.Append($"\"{firstLib}/libbootstrapperdll.o\" ");
+                    Console.Error.WriteLine("Warning: --zkvm-alloc-profile cannot be combined with --zkvm-gc; ignored");
+                    allocProfile = false;
                 }
 
-                ldArgs.Append("-shared ");
-                ldArgs.Append($"--version-script=\"{exportsFile}\" ");
-            }
-            else
-            {
-                if (stdlib == StandardLibType.DotNet)
-                    ldArgs.Append($"\"{firstLib}/libbootstrapper.o\" ");
+                bool freelist = result.GetValueForOption(ZkvmFreelistOption);
+                if (freelist && (zkvmGc || allocProfile))
+                {
+                    Console.Error.WriteLine("Warning: --zkvm-freelist cannot be combined with --zkvm-gc or --zkvm-alloc-profile; ignored");
+                    freelist = false;
+                }
 
-                if (result.GetValueForOption(NoPieOption))
-                    ldArgs.Append("--no-pie ");
-                else
-                    ldArgs.Append("-pie ");
-            }
+                var zkvmVariants = new List<string>();
+                if (allocProfile)
+                    zkvmVariants.Add("profile");
+                if (zkvmGc)
+                    zkvmVariants.Add("gc");
+                if (freelist)
+                    zkvmVariants.Add("freelist");
 
-            if (stdlib != StandardLibType.None)
-            {
-                ldArgs.Append("-lSystem.Native ");
-                if (stdlib == StandardLibType.DotNet)
+                string ZkvmObject(string name)
                 {
-                    ldArgs.Append("-latomic ");
-                    ldArgs.Append("-leventpipe-disabled ");
-                    ldArgs.Append("-laotminipal -lstandalonegc-disabled ");
-                    ldArgs.Append("-lstdc++compat -lRuntime.WorkstationGC -lSystem.IO.Compression.Native -lSystem.Security.Cryptography.Native.OpenSsl ");
-                    if (libc != "bionic")
-                        ldArgs.Append("-lSystem.Globalization.Native ");
+                    foreach (string variant in zkvmVariants)
+                    {
+                        string variantName = Path.ChangeExtension(name, "." + variant + ".o");
+                        if (libc == "zisk_sim" && File.Exists(Path.Combine(ziskSimLibPath, variantName)))
+                            return Path.Combine(ziskSimLibPath, variantName);
+                        if (File.Exists(Path.Combine(ziskLibPath, variantName)))
+                            return Path.Combine(ziskLibPath, variantName);
+                    }
+
+                    string simPath = Path.Combine(ziskSimLibPath, name);
+                    if (libc == "zisk_sim" && File.Exists(simPath))
+                        return simPath;
+                    return Path.Combine(ziskLibPath, name);
                 }
-                else if (stdlib == StandardLibType.Zero)
+
+                if (libc == "zisk" || libc == "zisk_sim")
                 {
-                    if (targetArchitecture == TargetArchitecture.ARM64 || targetArchitecture == TargetArchitecture.RiscV64)
-                        ldArgs.Append($"\"{firstLib}/libzerolibnative.o\" ");
+                    /* Zisk */
+                    if (libc == "zisk")
+                    {
+                        ldArgs.Append($"-T\"{Path.Combine(ziskLibPath, "script.ld")}\" ");
+                    }
+                    else
+                    {
+                        ldArgs.Append($"-T\"{Path.Combine(ziskSimLibPath, "script.ld")}\" ");
+                    }
+                    if (stackSizeStr != null)
+                    {
+                        /* Both scripts size the stack from __zk_stack_size and
+                         * only default it when it is not defined here. */
+                        ldArgs.Append($"--defsym=__zk_stack_size={stackSize} ");
+                    }
+                    if (cctorScheduleFile != null)
+                    {
+                        /* Placed after .rodata by its INSERT command; ubootstrap
+                         * walks it from a module initializer, before Main. */
+                        ldArgs.Append($"-T\"{cctorScheduleFile}\" ");
+                    }
+                    ldArgs.Append($"\"{ZkvmObject("entrypoint.o")}\" ");
+                    ldArgs.Append($"\"{ZkvmObject("nofp.o")}\" ");
+                    ldArgs.Append($"--whole-archive ");
+                    ldArgs.Append($"\"{ZkvmObject("ubootstrap.o")}\" ");
+                    ldArgs.Append($"\"{ZkvmObject("stdcppshim.o")}\" ");
+                    if (libc == "zisk")
+                    {
+                        ldArgs.Append($"--wrap=inline_bump_alloc_aligned ");
+                    }
+                    /* rhp */
+                    ldArgs.Append($"\"{ZkvmObject("rhp.o")}\" ");
+                    ldArgs.Append($"--wrap=RhpNewFast ");
+                    ldArgs.Append($"--wrap=RhpNewObject ");
+                    ldArgs.Append($"--wrap=RhpNewPtrArrayFast ");
+                    ldArgs.Append($"--wrap=RhpNewArrayFast ");
+                    ldArgs.Append($"--wrap=RhNewString ");
+                    ldArgs.Append($"--wrap=RhpPInvoke ");
+                    ldArgs.Append($"--wrap=RhpPInvokeReturn ");
+                    /* No-op the reverse P/Invoke transition: the real one parks the
+                     * thread at a GC-safe point, which deadlocks when a managed
+                     * exception handler is entered from __wrap_RhpThrowEx (thread
+                     * already cooperative, single-threaded zkVM never rendezvous). */
+                    ldArgs.Append($"--wrap=RhpReversePInvoke ");
+                    ldArgs.Append($"--wrap=RhpReversePInvokeReturn ");
+                    ldArgs.Append($"--wrap=RhBulkMoveWithWriteBarrier ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Runtime_TypeCast__CheckCastAny ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Diagnostics_Tracing_EventPipeEventProvider__Register ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Diagnostics_Tracing_EventSource__InitializeDefaultEventSources ");
+                    ldArgs.Append($"--wrap=GlobalizationNative_GetDefaultLocaleName ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_ProcessorIdCache__ProcessorNumberSpeedCheck ");
+                    ldArgs.Append($"--wrap=RhGetThreadStaticStorage ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_Internal_Runtime_ThreadStatics__GetUninlinedThreadStaticBaseForType ");
+                    ldArgs.Append($"--wrap=_Z16InitializeCGroupv ");
+                    ldArgs.Append($"--wrap=_Z19InitializeCpuCGroupv ");
+                    ldArgs.Append($"--wrap=__GetNonGCStaticBase_S_P_CoreLib_System_Environment ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Thread__WaitForForegroundThreads ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__Enter ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__EnterAndGetCurrentThreadId ");
+                    //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__EnterScope ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__TryEnterSlow_0 ");
+                    //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__TryEnter_0 ");
+                    //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__TryEnter_Outlined ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__Exit_0 ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__Exit_1 ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__ExitAll ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__get_IsHeldByCurrentThread ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Runtime_CompilerServices_ClassConstructorRunner__DeadlockAwareAcquire ");
+                    ldArgs.Append($"--wrap=S_P_TypeLoader_Internal_Runtime_TypeLoader_TypeLoaderEnvironment__VerifyTypeLoaderLockHeld ");
+                    //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_ManagedThreadId__get_Current ");
+                    //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Monitor__Enter ");
+                    //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Monitor__Exit ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_Number__UInt32ToDecStrForKnownSmallNumber ");
+                    ldArgs.Append($"--wrap=_ZN6Thread10IsDetachedEv ");
+                    ldArgs.Append($"--wrap=_Z24PalGetMaximumStackBoundsPPvS0_ ");
+                    if (libc == "zisk")
+                    {
+                        ldArgs.Append($"--wrap=System_Console_Interop_Sys__InitializeTerminalAndSignalHandling ");
+                        ldArgs.Append($"--wrap=SystemNative_SetTerminalInvalidationHandler ");
+                    }
+                    ldArgs.Append($"--wrap=RhpThrowEx ");
+                    ldArgs.Append($"--wrap=S_P_CoreLib_System_RuntimeExceptionHelpers__FailFast ");
+
+                    /* gs_cookie */
+                    ldArgs.Append($"\"{ZkvmObject("gs_cookie.o")}\" ");
+                    ldArgs.Append($"--wrap=__security_cookie ");
+
+                    /* rhp_native */
+                    ldArgs.Append($"\"{ZkvmObject("rhp_native.o")}\" ");
+                    ldArgs.Append($"--wrap=RhpAssignRefRiscV64 ");
+                    ldArgs.Append($"--wrap=RhpCheckedAssignRef ");
+                    ldArgs.Append($"--wrap=RhpByRefAssignRef ");
+                    ldArgs.Append($"--wrap=RhpAssignRef ");
+
+                    /* pal */
+                    ldArgs.Append($"\"{ZkvmObject("pal.o")}\" ");
+                    ldArgs.Append($"--wrap=getenv ");
+                    ldArgs.Append($"--wrap=getcwd ");
+                    ldArgs.Append($"--wrap=getpid ");
+                    ldArgs.Append($"--wrap=getegid ");
+                    ldArgs.Append($"--wrap=geteuid ");
+                    ldArgs.Append($"--wrap=sched_getaffinity ");
+                    ldArgs.Append($"--wrap=sched_getcpu ");
+                    ldArgs.Append($"--wrap=open ");
+                    ldArgs.Append($"--wrap=__libc_malloc_impl ");
+                    ldArgs.Append($"--wrap=__libc_realloc ");
+                    ldArgs.Append($"--wrap=__libc_free ");
+                    ldArgs.Append($"--wrap=calloc ");
+                    ldArgs.Append($"--wrap=pthread_create ");
+                    ldArgs.Append($"--wrap=pthread_sigmask ");
+                    ldArgs.Append($"--wrap=__clock_gettime ");
+                    ldArgs.Append($"--wrap=clock_gettime ");
+                    ldArgs.Append($"--wrap=__malloc_allzerop ");
+                    ldArgs.Append($"--wrap=mmap ");
+                    ldArgs.Append($"--wrap=munmap ");
+                    ldArgs.Append($"--wrap=mlock ");
+                    ldArgs.Append($"--wrap=munlock ");
+                    ldArgs.Append($"--wrap=mlockall ");
+                    ldArgs.Append($"--wrap=munlockall ");
+                    ldArgs.Append($"--wrap=sched_yield ");
+                    ldArgs.Append($"--wrap=sigaction ");
+                    ldArgs.Append($"--wrap=signal ");
+                    ldArgs.Append($"--wrap=syscall ");
+                    ldArgs.Append($"--wrap=sysconf ");
+                    if (zkvmGc)
+                    {
+                        /* GC.Collect() -> pal's mark-sweep collector */
+                        ldArgs.Append($"--wrap=RhpCollect ");
+                    }
+                    /* musl exit()/_Exit()/abort() issue exit_group (syscall 94),
+                     * which ZisK does not treat as program end. Redirect them to
+                     * pal's __wrap_* which emit the real ZisK exit ecall (a7=93). */
+                    ldArgs.Append($"--wrap=exit ");
+                    ldArgs.Append($"--wrap=_Exit ");
+                    ldArgs.Append($"--wrap=abort ");
+
+                    /* tls */
+                    ldArgs.Append($"\"{ZkvmObject("tls.o")}\" ");
+                    ldArgs.Append($"--wrap=__tls_get_addr ");
+                    ldArgs.Append($"--wrap=__init_tls ");
+                    ldArgs.Append($"--wrap=__init_tp ");
+                    ldArgs.Append($"--wrap=__copy_tls ");
+                    ldArgs.Append($"--no-whole-archive ");
+
+                    /* rng */
+                    ldArgs.Append($"\"{ZkvmObject("rng_drbg.o")}\" ");
+                    ldArgs.Append($"--wrap=minipal_get_cryptographically_secure_random_bytes ");
+                    ldArgs.Append($"--wrap=CryptoNative_EnsureOpenSslInitialized ");
+                    ldArgs.Append($"--wrap=CryptoNative_GetRandomBytes ");
+
+                    /* zkvm_zisk_precompiles: CSR-triggered circuits on zisk,
+                     * software fallbacks on zisk_sim */
+                    ldArgs.Append($"\"{ZkvmObject("zkvm_zisk_precompiles.o")}\" ");
+
+                    /* zkvm_zisk_input: the input region on zisk, a mapped
+                     * ZKVM_INPUT file on zisk_sim */
+                    ldArgs.Append($"\"{ZkvmObject("zkvm_zisk_input.o")}\" ");
+
+                    /* zkvm_zisk_output: console text and public outputs, buffered
+                     * in RAM and committed at exit */
+                    ldArgs.Append($"\"{ZkvmObject("zkvm_zisk_output.o")}\" ");
+                    ldArgs.Append($"--wrap=SystemNative_Write ");
+                    ldArgs.Append($"--wrap=__stdio_write ");
+
+                    /* rust_sys */
+                    ldArgs.Append($"\"{ZkvmObject("rust_sys.o")}\" ");
+                    ldArgs.Append($"--wrap=sys_alloc_aligned ");
+
+                    /* ugc */
+                    ldArgs.Append($"--wrap=GC_Initialize ");
+                    ldArgs.Append($"--wrap=GC_VersionInfo ");
+                    ldArgs.Append($"\"{ZkvmObject("uGC.cpp.obj")}\" ");
+                    ldArgs.Append($"\"{ZkvmObject("uGCHandleManager.cpp.obj")}\" ");
+                    ldArgs.Append($"\"{ZkvmObject("uGCHandleStore.cpp.obj")}\" ");
+                    ldArgs.Append($"\"{ZkvmObject("uGCHeap.cpp.obj")}\" ");
                 }
             }
 
-            ldArgs.Append("--as-needed -ldl -lm -lz -z relro -z now --discard-all --gc-sections ");
-            if (libc != "musl" && libc != "zisk" && libc != "zisk_sim")
-            {
-                ldArgs.Append("-lc -lgcc ");
-            }
+            ldArgs.AppendJoin(' ', result.GetValueForOption(LdFlagsOption));
 
-            if (libc != "bionic" && libc != "musl" && libc != "zisk" &&
-                libc != "zisk_sim")
-            {
-                ldArgs.Append("-lrt --as-needed -lgcc_s --no-as-needed ");
-                if (!result.GetValueForOption(CommonOptions.NoPthreadOption))
-                    ldArgs.Append("-lpthread ");
-            }
-            else if (libc == "musl" || libc == "zisk" || libc == "zisk_sim")
-            {
-                ldArgs.Append($"\"{firstLib}/libc.a\" ");
-            }
+            bool printCommands = result.GetValueForOption(PrintCommandsOption);
 
-            if (libc == "bionic")
+            static int RunCommand(string command, string args, bool print)
             {
-                if (buildTargetType == BuildTargetType.Shared)
+                if (print)
                 {
-                    ldArgs.Append($"\"{firstLib}/crtend_so.o\" ");
+                    Console.WriteLine($"{command} {args}");
                 }
-                else
+
+                if (!BuildServerCommand.Forwarding)
                 {
-                    ldArgs.Append($"\"{firstLib}/crtend_android.o\" ");
+                    var p = Process.Start(command, args);
+                    p.WaitForExit();
+                    return p.ExitCode;
                 }
-            }
-            else if (libc == "musl" || libc == "zisk" || libc == "zisk_sim")
-            {
-                ldArgs.Append($"\"{firstLib}/crtn.o\" ");
-            }
-            else
-            {
-                ldArgs.Append($"\"{firstLib}/crtendS.o\" ");
-                ldArgs.Append($"\"{firstLib}/crtn.o\" ");
-            }
 
-            foreach (var ldArg in extraLd)
-            {
-                ldArgs.Append(ldArg.Replace("{libpath}", firstLib) + " ");
+                // Under the build server the console belongs to the client.
+                var forwarded = Process.Start(new ProcessStartInfo(command, args)
+                {
+                    RedirectStandardOutput = true,
+                    RedirectStandardError = true,
+                });
+                forwarded.OutputDataReceived += (_, e) => { if (e.Data != null) Console.Out.WriteLine(e.Data); };
+                forwarded.ErrorDataReceived += (_, e) => { if (e.Data != null) Console.Error.WriteLine(e.Data); };
+                forwarded.BeginOutputReadLine();
+                forwarded.BeginErrorReadLine();
+                forwarded.WaitForExit();
+                return forwarded.ExitCode;
             }
 
-            // Add downloaded external libraries for Linux
-            foreach (var extLibPath in downloadedLibPaths)
+            if (targetOS == TargetOS.Linux && result.GetValueForOption(WrapCheckOption))
             {
-                ldArgs.Append($"\"{extLibPath}\" ");
+                PerfWatch wrapCheckWatch = new PerfWatch("Wrap check");
+                int checkExitCode = CheckWrapSymbols(ldArgs.ToString());
+                wrapCheckWatch.Complete();
+                if (checkExitCode != 0)
+                    return checkExitCode;
             }
 
-            // Add --wrap flags for symbols requested by external libraries
-            foreach (var sym in extLibWrapSymbols)
-            {
-                ldArgs.Append($"--wrap={sym} ");
-            }
+            PerfWatch linkWatch = new PerfWatch("Link");
+            int exitCode = RunCommand(ld, ldArgs.ToString(), printCommands);
+            linkWatch.Complete();
 
-            if (libc == "musl")
+            if (libc == "zisk" && exitCode == 0)
             {
-                /* hack, no fp must be built properly */
-                ldArgs.Append($"\"{Path.Combine(firstLib, "nofp.o")}\" ");
-            }
-
+                if (logger.IsVerbose)
+                    logger.LogMessage("Postprocessing ELF file");
 
-            if (libc == "zisk" || libc == "zisk_sim")
-            {
-                /* Zisk */
-                if (libc == "zisk")
+                PerfWatch postprocessWatch = new PerfWatch("Postprocess");
+                try
                 {
-                    ldArgs.Append($"-T\"{Path.Combine(ziskLibPath, "script.ld")}\" ");
+                    ElfPostProcessor.Run(outputFilePath, patchedFilePath, verbose ? Console.Out : null);
                 }
-                else
+                catch (Exception ex)
                 {
-                    ldArgs.Append($"-T\"{Path.Combine(ziskSimLibPath, "script.ld")}\" ");
+                    Console.Error.WriteLine($"error: post-processing {outputFilePath}: {ex.Message}");
+                    return 1;
                 }
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "entrypoint.o")}\" ");
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "nofp.o")}\" ");
-                ldArgs.Append($"--whole-archive ");
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "ubootstrap.o")}\" ");
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "stdcppshim.o")}\" ");
-                if (libc == "zisk")
+                postprocessWatch.Complete();
+            }
+            if (exitCode == 0 && (libc == "zisk" || libc == "zisk_sim") && result.GetValueForOption(ZkvmStackReportOption))
+            {
+                string stackReportFile = Path.ChangeExtension(outputFilePath, ".stack.txt");
+                // The report is advisory: a binary the scanner cannot handle
+                // is still a good build.
+                long stackDepth = -1;
+                try
                 {
-                    ldArgs.Append($"--wrap=inline_bump_alloc_aligned ");
+                    stackDepth = StackDepthAnalysis.Write(outputFilePath, stackReportFile, stackSize);
                 }
-                /* rhp */
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "rhp.o")}\" ");
-                ldArgs.Append($"--wrap=RhpNewFast ");
-                ldArgs.Append($"--wrap=RhpNewObject ");
-                ldArgs.Append($"--wrap=RhpNewPtrArrayFast ");
-                ldArgs.Append($"--wrap=RhpNewArrayFast ");
-                ldArgs.Append($"--wrap=RhNewString ");
-                ldArgs.Append($"--wrap=RhpPInvoke ");
-                ldArgs.Append($"--wrap=RhpPInvokeReturn ");
-                /* No-op the reverse P/Invoke transition: the real one parks the
-                 * thread at a GC-safe point, which deadlocks when a managed
-                 * exception handler is entered from __wrap_RhpThrowEx (thread
-                 * already cooperative, single-threaded zkVM never rendezvous). */
-                ldArgs.Append($"--wrap=RhpReversePInvoke ");
-                ldArgs.Append($"--wrap=RhpReversePInvokeReturn ");
-                ldArgs.Append($"--wrap=RhBulkMoveWithWriteBarrier ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Runtime_TypeCast__CheckCastAny ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Diagnostics_Tracing_EventPipeEventProvider__Register ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Diagnostics_Tracing_EventSource__InitializeDefaultEventSources ");
-                ldArgs.Append($"--wrap=GlobalizationNative_GetDefaultLocaleName ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_ProcessorIdCache__ProcessorNumberSpeedCheck ");
-                ldArgs.Append($"--wrap=RhGetThreadStaticStorage ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_Internal_Runtime_ThreadStatics__GetUninlinedThreadStaticBaseForType ");
-                ldArgs.Append($"--wrap=_Z16InitializeCGroupv ");
-                ldArgs.Append($"--wrap=_Z19InitializeCpuCGroupv ");
-                ldArgs.Append($"--wrap=__GetNonGCStaticBase_S_P_CoreLib_System_Environment ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Thread__WaitForForegroundThreads ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__Enter ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__EnterAndGetCurrentThreadId ");
-                //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__EnterScope ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__TryEnterSlow_0 ");
-                //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__TryEnter_0 ");
-                //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__TryEnter_Outlined ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__Exit_0 ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__Exit_1 ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__ExitAll ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Lock__get_IsHeldByCurrentThread ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Runtime_CompilerServices_ClassConstructorRunner__DeadlockAwareAcquire ");
-                ldArgs.Append($"--wrap=S_P_TypeLoader_Internal_Runtime_TypeLoader_TypeLoaderEnvironment__VerifyTypeLoaderLockHeld ");
-                //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_ManagedThreadId__get_Current ");
-                //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Monitor__Enter ");
-                //ldArgs.Append($"--wrap=S_P_CoreLib_System_Threading_Monitor__Exit ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_Number__UInt32ToDecStrForKnownSmallNumber ");
-                ldArgs.Append($"--wrap=_ZN6Thread10IsDetachedEv ");
-                ldArgs.Append($"--wrap=_Z24PalGetMaximumStackBoundsPPvS0_ ");
-                if (libc == "zisk")
+                catch (Exception ex)
                 {
-                    ldArgs.Append($"--wrap=System_Console_Interop_Sys__InitializeTerminalAndSignalHandling ");
-                    ldArgs.Append($"--wrap=SystemNative_SetTerminalInvalidationHandler ");
-                    ldArgs.Append($"--wrap=SystemNative_Write ");
+                    Console.Error.WriteLine($"Warning: stack analysis of {outputFilePath} failed: {ex.Message}");
                 }
-                ldArgs.Append($"--wrap=RhpThrowEx ");
-                ldArgs.Append($"--wrap=S_P_CoreLib_System_RuntimeExceptionHelpers__FailFast ");
-
-                /* gs_cookie */
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "gs_cookie.o")}\" ");
-                ldArgs.Append($"--wrap=__security_cookie ");
-
-                /* rhp_native */
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "rhp_native.o")}\" ");
-                ldArgs.Append($"--wrap=RhpAssignRefRiscV64 ");
-                ldArgs.Append($"--wrap=RhpCheckedAssignRef ");
-                ldArgs.Append($"--wrap=RhpByRefAssignRef ");
-                ldArgs.Append($"--wrap=RhpAssignRef ");
-
-                /* pal */
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "pal.o")}\" ");
-                ldArgs.Append($"--wrap=getenv ");
-                ldArgs.Append($"--wrap=getcwd ");
-                ldArgs.Append($"--wrap=getpid ");
-                ldArgs.Append($"--wrap=getegid ");
-                ldArgs.Append($"--wrap=geteuid ");
-                ldArgs.Append($"--wrap=sched_getaffinity ");
-                ldArgs.Append($"--wrap=sched_getcpu ");
-                ldArgs.Append($"--wrap=open ");
-                ldArgs.Append($"--wrap=__libc_malloc_impl ");
-                ldArgs.Append($"--wrap=__libc_realloc ");
-                ldArgs.Append($"--wrap=__libc_free ");
-                ldArgs.Append($"--wrap=calloc ");
-                ldArgs.Append($"--wrap=pthread_create ");
-                ldArgs.Append($"--wrap=pthread_sigmask ");
-                ldArgs.Append($"--wrap=__clock_gettime ");
-                ldArgs.Append($"--wrap=clock_gettime ");
-                ldArgs.Append($"--wrap=__malloc_allzerop ");
-                ldArgs.Append($"--wrap=mmap ");
-                ldArgs.Append($"--wrap=munmap ");
-                ldArgs.Append($"--wrap=mlock ");
-                ldArgs.Append($"--wrap=munlock ");
-                ldArgs.Append($"--wrap=mlockall ");
-                ldArgs.Append($"--wrap=munlockall ");
-                ldArgs.Append($"--wrap=sched_yield ");
-                ldArgs.Append($"--wrap=sigaction ");
-                ldArgs.Append($"--wrap=signal ");
-                ldArgs.Append($"--wrap=syscall ");
-                ldArgs.Append($"--wrap=sysconf ");
-                /* musl exit()/_Exit()/abort() issue exit_group (syscall 94),
-                 * which ZisK does not treat as program end. Redirect them to
-                 * pal's __wrap_* which emit the real ZisK exit ecall (a7=93). */
-                ldArgs.Append($"--wrap=exit ");
-                ldArgs.Append($"--wrap=_Exit ");
-                ldArgs.Append($"--wrap=abort ");
-                if (libc == "zisk")
+                if (stackDepth >= 0)
                 {
-                    /* Hide write() in Zisk */
-                    ldArgs.Append($"--wrap=__stdio_write ");
+                    Console.WriteLine($"Stack depth: {stackDepth} of {stackSize} bytes on the deepest path, report in {stackReportFile}");
+                    if (stackDepth > stackSize)
+                        Console.Error.WriteLine($"Warning: the deepest call path needs {stackDepth} bytes of stack but only {stackSize} are reserved; raise --stack-size");
                 }
+            }
 
-                /* tls */
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "tls.o")}\" ");
-                ldArgs.Append($"--wrap=__tls_get_addr ");
-                ldArgs.Append($"--wrap=__init_tls ");
-                ldArgs.Append($"--wrap=__init_tp ");
-                ldArgs.Append($"--wrap=__copy_tls ");
-                ldArgs.Append($"--no-whole-archive ");
-
-                /* rng */
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "rng_stupid.o")}\" ");
-                ldArgs.Append($"--wrap=minipal_get_cryptographically_secure_random_bytes ");
-                ldArgs.Append($"--wrap=CryptoNative_EnsureOpenSslInitialized ");
-                ldArgs.Append($"--wrap=CryptoNative_GetRandomBytes ");
-
-                /* rust_sys */
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "rust_sys.o")}\" ");
-                ldArgs.Append($"--wrap=sys_alloc_aligned ");
-
-                /* ugc */
-                ldArgs.Append($"--wrap=GC_Initialize ");
-                ldArgs.Append($"--wrap=GC_VersionInfo ");
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "uGC.cpp.obj")}\" ");
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "uGCHandleManager.cpp.obj")}\" ");
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "uGCHandleStore.cpp.obj")}\" ");
-                ldArgs.Append($"\"{Path.Combine(ziskLibPath, "uGCHeap.cpp.obj")}\" ");
+            if (exitCode == 0 && result.GetValueForOption(SymChartOption))
+            {
+                RunSymbolChart(outputFilePath, verbose, logger);
             }
-        }
 
-        ldArgs.AppendJoin(' ', result.GetValueForOption(LdFlagsOption));
+            if (exitCode == 0
+                && targetOS is not TargetOS.Windows and not TargetOS.UEFI
+                && result.GetValueForOption(SeparateSymbolsOption))
+            {
+                if (logger.IsVerbose)
+                    logger.LogMessage("Running objcopy");
 
-        bool printCommands = result.GetValueForOption(PrintCommandsOption);
+                string objcopy = Environment.GetEnvironmentVariable("BFLAT_OBJCOPY");
+                if (objcopy == null)
+                {
+                    string toolSuffix = RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ".exe" : "";
+                    objcopy = Path.Combine(homePath, "bin", "llvm-objcopy" + toolSuffix);
+                }
 
-        static int RunCommand(string command, string args, bool print)
-        {
-            if (print)
-            {
-                Console.WriteLine($"{command} {args}");
+                PerfWatch objCopyWatch = new PerfWatch("Objcopy");
+                exitCode = RunCommand(objcopy, $"--only-keep-debug \"{outputFilePath}\" \"{outputFilePath}.dwo\"", printCommands);
+                if (exitCode != 0) return exitCode;
+                RunCommand(objcopy, $"--strip-debug --strip-unneeded \"{outputFilePath}\"", printCommands);
+                if (exitCode != 0) return exitCode;
+                RunCommand(objcopy, $"--add-gnu-debuglink=\"{outputFilePath}.dwo\" \"{outputFilePath}\"", printCommands);
+                if (exitCode != 0) return exitCode;
+                objCopyWatch.Complete();
             }
 
-            var p = Process.Start(command, args);
-            p.WaitForExit();
-            return p.ExitCode;
+            return exitCode;
         }
+    }
 
-        if (targetOS == TargetOS.Linux && result.GetValueForOption(WrapCheckOption))
-        {
-            string checkWrapPath = Path.Combine(homePath, "check_wrap_symbols.py");
-            int checkExitCode = RunCommand(checkWrapPath, "-- " + ldArgs.ToString(), printCommands);
-            if (checkExitCode != 0)
-                return checkExitCode;
-        }
-
-        PerfWatch linkWatch = new PerfWatch("Link");
-        int exitCode = RunCommand(ld, ldArgs.ToString(), printCommands);
-        linkWatch.Complete();
-
-        if (libc == "zisk" && exitCode == 0)
+    // Implementations an interface may have for its call sites to be
+    // resolved at build time: RyuJIT's cap on type checks per call site
+    // (MAX_GDV_TYPE_CHECKS). NativeAOT's own default is 3.
+    private const int ExactDispatchMaxTypeChecks = 5;
+
+    // What the compile actually did with interface calls, read back from the
+    // object: every call site the JIT did not devirtualize keeps a dispatch
+    // cell, whose symbol names the interface method it dispatches. Interfaces
+    // that have constructed implementations but no cell left are listed as
+    // direct: each of their call sites, if any, was compiled to direct calls.
+    private static void WriteDispatchReport(string reportPath, string objectFile, NodeFactory factory,
+        IEnumerable<TypeDesc> constructedTypes)
+    {
+        var implementations = new Dictionary<TypeDesc, SortedSet<string>>();
+        foreach (TypeDesc type in constructedTypes)
         {
-            var patchElfArgs = " --fix-init-array --fix-tdata --remove-eh --trim-bss ";
-            if (verbose)
-                patchElfArgs += "--print-fn-boundaries ";
+            if (type.IsInterface || type.IsCanonicalSubtype(CanonicalFormKind.Any))
+                continue;
 
-            int patchExitCode = RunCommand(patchElfPath,
-                outputFilePath + " " + patchedFilePath +
-                patchElfArgs,
-                printCommands);
+            foreach (DefType iface in type.RuntimeInterfaces)
+            {
+                if (!implementations.TryGetValue(iface, out SortedSet<string> set))
+                    implementations.Add(iface, set = new SortedSet<string>(StringComparer.Ordinal));
+                set.Add(type.ToString());
+            }
         }
-        if (!result.GetValueForOption(CommonOptions.KeepObjectOption))
+
+        // Cell symbols are <prefix>__InterfaceDispatchCell_<target method>[_<call site>].
+        const string CellMarker = "__InterfaceDispatchCell_";
+        var cellTargets = new List<string>();
+        foreach (ElfSymbol symbol in ElfSymbolReader.ReadBinary(objectFile) ?? [])
         {
-            try { File.Delete(objectFilePath); } catch { }
+            int at = symbol.Name.IndexOf(CellMarker, StringComparison.Ordinal);
+            if (at >= 0 && symbol.SectionIndex != "UND")
+                cellTargets.Add(symbol.Name.Substring(at + CellMarker.Length));
         }
+        cellTargets.Sort(StringComparer.Ordinal);
 
-        if (exportsFile != null)
-            try { File.Delete(exportsFile); } catch { }
-
-        if (exitCode == 0 && result.GetValueForOption(SymChartOption))
+        int CallSitesThroughCells(MethodDesc method)
         {
-            RunSymbolChart(outputFilePath, homePath, verbose, logger);
+            string target = factory.NameMangler.GetMangledMethodName(method).ToString();
+            int first = cellTargets.BinarySearch(target, StringComparer.Ordinal);
+            if (first < 0)
+                first = ~first;
+            int count = 0;
+            for (int i = first; i < cellTargets.Count && cellTargets[i].StartsWith(target, StringComparison.Ordinal); i++)
+            {
+                if (cellTargets[i].Length == target.Length || cellTargets[i][target.Length] == '_')
+                    count++;
+            }
+            return count;
         }
 
-        if (exitCode == 0
-            && targetOS is not TargetOS.Windows and not TargetOS.UEFI
-            && result.GetValueForOption(SeparateSymbolsOption))
+        var direct = new List<(TypeDesc Interface, SortedSet<string> Implementations)>();
+        var viaCells = new List<(string Method, int CallSites, int Implementations)>();
+        foreach (var (iface, set) in implementations)
         {
-            if (logger.IsVerbose)
-                logger.LogMessage("Running objcopy");
-
-            string objcopy = Environment.GetEnvironmentVariable("BFLAT_OBJCOPY");
-            if (objcopy == null)
+            bool anyCell = false;
+            foreach (MethodDesc method in iface.GetMethods())
             {
-                string toolSuffix = RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ".exe" : "";
-                objcopy = Path.Combine(homePath, "bin", "llvm-objcopy" + toolSuffix);
+                if (!method.IsVirtual)
+                    continue;
+                int callSites = CallSitesThroughCells(method);
+                if (callSites == 0)
+                    continue;
+                anyCell = true;
+                viaCells.Add(($"{iface}.{method.Name}", callSites, set.Count));
             }
-
-            PerfWatch objCopyWatch = new PerfWatch("Objcopy");
-            exitCode = RunCommand(objcopy, $"--only-keep-debug \"{outputFilePath}\" \"{outputFilePath}.dwo\"", printCommands);
-            if (exitCode != 0) return exitCode;
-            RunCommand(objcopy, $"--strip-debug --strip-unneeded \"{outputFilePath}\"", printCommands);
-            if (exitCode != 0) return exitCode;
-            RunCommand(objcopy, $"--add-gnu-debuglink=\"{outputFilePath}.dwo\" \"{outputFilePath}\"", printCommands);
-            if (exitCode != 0) return exitCode;
-            objCopyWatch.Complete();
+            if (!anyCell)
+                direct.Add((iface, set));
         }
 
-        return exitCode;
+        direct.Sort((a, b) => StringComparer.Ordinal.Compare(a.Interface.ToString(), b.Interface.ToString()));
+        viaCells.Sort((a, b) => b.CallSites != a.CallSites
+            ? b.CallSites.CompareTo(a.CallSites)
+            : StringComparer.Ordinal.Compare(a.Method, b.Method));
+
+        var report = new StringBuilder();
+        report.AppendLine($"# {cellTargets.Count} call sites dispatch through cells; " +
+            $"{direct.Count} implemented interfaces have none left");
+        report.AppendLine("# direct: no call site of the interface kept a cell (each was devirtualized, or it has none)");
+        foreach (var (iface, set) in direct)
+            report.AppendLine($"direct  {iface}: {string.Join(", ", set)}");
+        foreach (var (method, callSites, count) in viaCells)
+            report.AppendLine($"cell    {method}: {callSites} call sites, {count} implementations");
+        File.WriteAllText(reportPath, report.ToString());
+
+        Console.WriteLine($"Interface dispatch: {cellTargets.Count} call sites through dispatch cells, report in {reportPath}");
     }
 
-    private static void RunSymbolChart(string binaryPath, string homePath, bool verbose, Logger logger)
+    // Every --wrap=SYMBOL on the link line must name a symbol that one of the
+    // object or archive inputs defines or references; otherwise the wrap
+    // silently does nothing. Libraries found through -L/-l are not searched.
+    private static int CheckWrapSymbols(string ldArgs)
     {
-        // ── Locate readelf ────────────────────────────────────────────────
-        string readelf = Environment.GetEnvironmentVariable("BFLAT_READELF");
-        if (readelf == null)
+        var wrapped = new SortedSet<string>(StringComparer.Ordinal);
+        var inputs = new List<string>();
+        foreach (string token in SplitArguments(ldArgs))
         {
-            string toolSuffix = RuntimeInformation.IsOSPlatform(OSPlatform.Windows) ? ".exe" : "";
-            string candidate = Path.Combine(homePath, "bin", "llvm-readelf" + toolSuffix);
-            readelf = File.Exists(candidate) ? candidate : "readelf";
+            if (token.StartsWith("--wrap=", StringComparison.Ordinal))
+            {
+                wrapped.Add(token.Substring("--wrap=".Length));
+            }
+            else if (token.EndsWith(".o", StringComparison.OrdinalIgnoreCase)
+                || token.EndsWith(".obj", StringComparison.OrdinalIgnoreCase)
+                || token.EndsWith(".a", StringComparison.OrdinalIgnoreCase))
+            {
+                if (File.Exists(token))
+                    inputs.Add(token);
+                else
+                    Console.Error.WriteLine($"Warning: wrap check: input not on disk: {token}");
+            }
         }
 
-        if (verbose)
-            logger.LogMessage($"Running readelf on {binaryPath}");
+        if (wrapped.Count == 0)
+            return 0;
+        if (inputs.Count == 0)
+        {
+            Console.Error.WriteLine("Error: wrap check: no object files or archives in the linker arguments");
+            return 2;
+        }
 
-        string readelfOutput;
-        try
+        HashSet<string> known = ElfSymbolReader.ReadNames(inputs);
+        var missing = wrapped.Where(s => !known.Contains(s)).ToList();
+        if (missing.Count != 0)
         {
-            var psi = new System.Diagnostics.ProcessStartInfo(readelf, $"-sW \"{binaryPath}\"")
-            {
-                RedirectStandardOutput = true,
-                RedirectStandardError  = true,
-                UseShellExecute        = false,
-            };
-            using var proc = System.Diagnostics.Process.Start(psi);
-            readelfOutput = proc.StandardOutput.ReadToEnd();
-            proc.WaitForExit();
+            Console.Error.WriteLine("Error: --wrap= targets not found in any linker input:");
+            foreach (string symbol in missing)
+                Console.Error.WriteLine($"  {symbol}");
+            return 1;
+        }
 
-            if (proc.ExitCode != 0)
+        Console.WriteLine($"Wrap check: all {wrapped.Count} --wrap= targets resolve to real symbols");
+        return 0;
+    }
+
+    // Splits a command line built for RunCommand: whitespace separates,
+    // double quotes group.
+    private static IEnumerable<string> SplitArguments(string commandLine)
+    {
+        var token = new StringBuilder();
+        bool quoted = false, any = false;
+        foreach (char c in commandLine)
+        {
+            if (c == '"')
             {
-                string err = proc.StandardError.ReadToEnd().Trim();
-                Console.Error.WriteLine($"Warning: readelf exited with code {proc.ExitCode}: {err}");
-                return;
+                quoted = !quoted;
+                any = true;
+            }
+            else if (char.IsWhiteSpace(c) && !quoted)
+            {
+                if (any)
+                    yield return token.ToString();
+                token.Clear();
+                any = false;
+            }
+            else
+            {
+                token.Append(c);
+                any = true;
             }
         }
-        catch (Exception ex)
-        {
-            Console.Error.WriteLine($"Warning: could not run readelf ({readelf}): {ex.Message}");
+        if (any)
+            yield return token.ToString();
+    }
+
+    private static void RunSymbolChart(string binaryPath, bool verbose, Logger logger)
+    {
+        if (verbose)
+            logger.LogMessage($"Reading the symbols of {binaryPath}");
+
+        var symbols = ElfSymbolReader.ReadBinary(binaryPath);
+        if (symbols == null)
             return;
-        }
 
-        // ── Parse & generate ──────────────────────────────────────────────
-        var symbols  = ElfSymbolParser.Parse(readelfOutput);
+        // ── Generate ──────────────────────────────────────────────────────
         string htmlPath = binaryPath + ".symbols.html";
 
         try
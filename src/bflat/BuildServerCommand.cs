@@ -0,0 +1,474 @@
+// bflat C# compiler
+// Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.CommandLine;
+using System.CommandLine.Parsing;
+using System.IO;
+using System.Linq;
+using System.Net.Sockets;
+using System.Reflection;
+using System.Runtime.InteropServices;
+using System.Runtime.Versioning;
+using System.Text.Json;
+
+// A long-lived bflat that runs builds for `bflat build --server`.
+//
+// Every build otherwise pays for process start, JIT-compiling Roslyn and
+// ILCompiler, and reading the framework reference assemblies into Roslyn
+// metadata. The server pays that once: its code stays jitted and
+// ILBuildCommand keeps the reference metadata between builds. The ILC type
+// system itself is per build (its modules belong to one context), but the
+// files it maps stay in the page cache.
+//
+// The client sends its working directory, arguments and environment over a
+// Unix socket, one build per connection; the server streams stdout and
+// stderr back as frames and ends with the exit code. Builds run one at a time,
+// because the working directory, the environment and the console are
+// process-wide. Tools the build starts (lld, objcopy) have their output
+// forwarded too, see Forwarding. With no server listening the client builds in
+// its own process, so `--server` is always safe to pass.
+//
+// The socket sits in a directory only its user can enter, and each end checks
+// that the other runs as the same user (SO_PEERCRED) before trusting it. Linux
+// only, for that check.
+//
+// Each request names the bflat that sent it (see CompilerIdentity). A server
+// started from another bflat, e.g. before a rebuild or an upgrade, would
+// compile with its own ILC, libraries and modules; it refuses the request and
+// exits, and the client builds in its own process.
+internal class BuildServerCommand : CommandBase
+{
+    private const byte FrameStdout = (byte)'o';
+    private const byte FrameStderr = (byte)'e';
+    private const byte FrameExit = (byte)'x';
+    private const byte FrameRefused = (byte)'r';
+
+    private const int SolSocket = 1, SoPeercred = 17;  // Linux <sys/socket.h>
+
+    // Longer frames are a protocol error; output is split to stay below it.
+    private const int MaxFrameLength = 16 << 20;
+
+    private static readonly TimeSpan IdleTimeout = TimeSpan.FromMinutes(30);
+
+    private static readonly Lazy<string> s_compilerIdentity = new Lazy<string>(CompilerIdentity);
+
+    private readonly Func<string[], int> _invoke;
+
+    private BuildServerCommand(Func<string[], int> invoke) => _invoke = invoke;
+
+    /// <summary>
+    /// True while the server runs a client's build: child processes must
+    /// have their output forwarded instead of inheriting the server's console.
+    /// </summary>
+    public static bool Forwarding { get; private set; }
+
+    public static Command Create(Func<string[], int> invoke)
+    {
+        var command = new Command("build-server",
+            "Runs builds for 'bflat build --server' from one warm process, until idle for 30 minutes");
+        command.Handler = new BuildServerCommand(invoke);
+        return command;
+    }
+
+    // $BFLAT_SERVER_SOCKET, else in $XDG_RUNTIME_DIR (0700 by specification),
+    // else in a private per-user directory under /tmp.
+    [SupportedOSPlatform("linux")]
+    private static string SocketPath()
+    {
+        string path = Environment.GetEnvironmentVariable("BFLAT_SERVER_SOCKET");
+        if (!string.IsNullOrEmpty(path))
+            return path;
+
+        string runtimeDir = Environment.GetEnvironmentVariable("XDG_RUNTIME_DIR");
+        if (!string.IsNullOrEmpty(runtimeDir) && Directory.Exists(runtimeDir))
+            return Path.Combine(runtimeDir, "bflat-build.sock");
+
+        string directory = Path.Combine(Path.GetTempPath(), $"bflat-{geteuid()}");
+        return Path.Combine(PrivateDirectory(directory), "bflat-build.sock");
+    }
+
+    // Creates `path` with mode 0700, or makes sure the existing entry is a real
+    // directory of ours with that mode. Only a file's owner may chmod it, so
+    // the chmod succeeding is the ownership check.
+    [SupportedOSPlatform("linux")]
+    private static string PrivateDirectory(string path)
+    {
+        const UnixFileMode userOnly = UnixFileMode.UserRead | UnixFileMode.UserWrite | UnixFileMode.UserExecute;
+
+        DirectoryInfo directory = Directory.CreateDirectory(path, userOnly);
+        if (directory.LinkTarget != null)
+            throw new IOException($"{path} is a symbolic link, not a private directory");
+        try
+        {
+            File.SetUnixFileMode(path, userOnly);
+        }
+        catch (UnauthorizedAccessException)
+        {
+            throw new IOException($"{path} belongs to another user");
+        }
+        return path;
+    }
+
+    // Whether the process at the other end of `socket` runs as this user.
+    private static bool PeerIsCurrentUser(Socket socket)
+    {
+        Span<byte> credentials = stackalloc byte[12];   // struct ucred { pid; uid; gid; }
+        if (socket.GetRawSocketOption(SolSocket, SoPeercred, credentials) < credentials.Length)
+            return false;
+        return BitConverter.ToUInt32(credentials.Slice(4)) == geteuid();
+    }
+
+    [DllImport("libc")]
+    private static extern uint geteuid();
+
+    // The executable and the bflat assembly, with the assembly's MVID and
+    // timestamp: a rebuild or reinstall changes at least one of them.
+    private static string CompilerIdentity()
+    {
+        Assembly assembly = typeof(BuildServerCommand).Assembly;
+        string location = string.IsNullOrEmpty(assembly.Location) ? Environment.ProcessPath : assembly.Location;
+        long modified = File.Exists(location) ? File.GetLastWriteTimeUtc(location).Ticks : 0;
+        return $"{Environment.ProcessPath}|{location}|{assembly.ManifestModule.ModuleVersionId}|{modified}";
+    }
+
+    /// <summary>
+    /// Runs <paramref name="args"/> (a build command line) on the server.
+    /// Returns false when no server is listening or the one listening is
+    /// another bflat; the caller then builds in its own process.
+    /// </summary>
+    public static bool TryForward(string[] args, out int exitCode)
+    {
+        exitCode = 1;
+        if (!OperatingSystem.IsLinux())
+            return false;
+
+        string socketPath;
+        var socket = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+        try
+        {
+            socketPath = SocketPath();
+            socket.Connect(new UnixDomainSocketEndPoint(socketPath));
+        }
+        catch (Exception ex) when (ex is IOException or SocketException)
+        {
+            socket.Dispose();
+            return false;
+        }
+
+        if (!PeerIsCurrentUser(socket))
+        {
+            Console.Error.WriteLine($"Warning: the build server on {socketPath} runs as another user; building here");
+            socket.Dispose();
+            return false;
+        }
+
+        using var stream = new NetworkStream(socket, ownsSocket: true);
+        byte[] request = JsonSerializer.SerializeToUtf8Bytes(new Request
+        {
+            WorkingDirectory = Environment.CurrentDirectory,
+            Arguments = args,
+            Environment = CurrentEnvironment(),
+            Compiler = s_compilerIdentity.Value,
+        });
+        WriteFrame(stream, FrameStdout, request);
+
+        using Stream stdout = Console.OpenStandardOutput();
+        using Stream stderr = Console.OpenStandardError();
+        while (ReadFrame(stream, out byte kind, out byte[] payload))
+        {
+            switch (kind)
+            {
+                case FrameStdout: stdout.Write(payload); break;
+                case FrameStderr: stderr.Write(payload); break;
+                case FrameExit when payload.Length == sizeof(int):
+                    exitCode = BitConverter.ToInt32(payload);
+                    return true;
+                case FrameRefused:
+                    Console.Error.WriteLine($"Warning: the build server on {socketPath} runs another bflat and is exiting; building here");
+                    return false;
+            }
+        }
+
+        Console.Error.WriteLine("Error: the build server closed the connection mid-build");
+        return true;
+    }
+
+    public override int Handle(ParseResult result)
+    {
+        if (!OperatingSystem.IsLinux())
+        {
+            Console.Error.WriteLine("The build server is only supported on Linux");
+            return 1;
+        }
+
+        string socketPath;
+        try
+        {
+            socketPath = SocketPath();
+        }
+        catch (IOException ex)
+        {
+            Console.Error.WriteLine($"Cannot place the build server socket: {ex.Message}");
+            return 1;
+        }
+
+        if (TryConnect(socketPath))
+        {
+            Console.Error.WriteLine($"A build server is already listening on {socketPath}");
+            return 1;
+        }
+        File.Delete(socketPath);    // left behind by a server that died
+
+        using var listener = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+        listener.Bind(new UnixDomainSocketEndPoint(socketPath));
+        File.SetUnixFileMode(socketPath, UnixFileMode.UserRead | UnixFileMode.UserWrite);
+        listener.Listen(16);
+        Console.WriteLine($"bflat build server listening on {socketPath}");
+
+        try
+        {
+            while (listener.Poll(IdleTimeout, SelectMode.SelectRead))
+            {
+                using Socket client = listener.Accept();
+                if (!PeerIsCurrentUser(client))
+                    continue;
+
+                using var stream = new NetworkStream(client);
+                try
+                {
+                    if (!Serve(stream))
+                        break;
+                }
+                catch (Exception ex) when (ex is IOException or SocketException)
+                {
+                    // The client went away or broke the protocol; either way
+                    // only this connection ends.
+                }
+            }
+        }
+        finally
+        {
+            File.Delete(socketPath);
+        }
+        return 0;
+    }
+
+    // Runs one client's build. Returns false when the client is another bflat:
+    // this server is stale and stops listening.
+    private bool Serve(NetworkStream stream)
+    {
+        if (!ReadFrame(stream, out _, out byte[] payload))
+            return true;
+        Request request = ParseRequest(payload);
+        if (request.Compiler != s_compilerIdentity.Value)
+        {
+            Console.WriteLine("A client runs another bflat; exiting so that a current server can start");
+            WriteFrame(stream, FrameRefused, ReadOnlySpan<byte>.Empty);
+            return false;
+        }
+
+        var streamLock = new object();
+        TextWriter savedOut = Console.Out, savedError = Console.Error;
+        string savedDirectory = Environment.CurrentDirectory;
+        Dictionary<string, string> savedEnvironment = SwapEnvironment(request.Environment);
+
+        int exitCode;
+        try
+        {
+            Console.SetOut(new StreamWriter(new FrameStream(stream, FrameStdout, streamLock)) { AutoFlush = true });
+            Console.SetError(new StreamWriter(new FrameStream(stream, FrameStderr, streamLock)) { AutoFlush = true });
+            Forwarding = true;
+
+            string command = request.Arguments.FirstOrDefault();
+            if (command != "build" && command != "build-il")
+            {
+                Console.Error.WriteLine($"Error: the build server only runs 'build' and 'build-il', not '{command}'");
+                exitCode = 1;
+            }
+            else
+            {
+                try
+                {
+                    Environment.CurrentDirectory = request.WorkingDirectory;
+                    exitCode = _invoke(request.Arguments);
+                }
+                catch (Exception e)
+                {
+                    Console.Error.WriteLine("Error: " + e.Message);
+                    Console.Error.WriteLine(e.ToString());
+                    exitCode = 1;
+                }
+            }
+        }
+        finally
+        {
+            Forwarding = false;
+            Console.SetOut(savedOut);
+            Console.SetError(savedError);
+            Environment.CurrentDirectory = savedDirectory;
+            SwapEnvironment(savedEnvironment);
+        }
+
+        lock (streamLock)
+            WriteFrame(stream, FrameExit, BitConverter.GetBytes(exitCode));
+
+        // Hand the previous build's type system back before the next one.
+        GC.Collect();
+        return true;
+    }
+
+    // A request the client could have sent, or an IOException that ends the
+    // connection.
+    private static Request ParseRequest(byte[] payload)
+    {
+        Request request;
+        try
+        {
+            request = JsonSerializer.Deserialize<Request>(payload);
+        }
+        catch (JsonException ex)
+        {
+            throw new IOException("malformed build request", ex);
+        }
+
+        if (request == null || request.Arguments == null || request.Arguments.Any(a => a == null) ||
+            string.IsNullOrEmpty(request.WorkingDirectory) || request.Environment == null ||
+            request.Environment.Any(v => !IsVariable(v.Key, v.Value)))
+            throw new IOException("incomplete build request");
+        return request;
+    }
+
+    private static bool IsVariable(string name, string value) =>
+        !string.IsNullOrEmpty(name) && name.IndexOfAny(['=', '\0']) < 0 && value != null && !value.Contains('\0');
+
+    private static Dictionary<string, string> CurrentEnvironment()
+    {
+        var environment = new Dictionary<string, string>();
+        foreach (DictionaryEntry variable in Environment.GetEnvironmentVariables())
+            environment[(string)variable.Key] = (string)variable.Value;
+        return environment;
+    }
+
+    // Makes the process environment exactly `environment` (HOME, PATH,
+    // TMPDIR, XDG_CACHE_HOME and BFLAT_* all decide where a build looks and
+    // writes); returns the old one.
+    private static Dictionary<string, string> SwapEnvironment(Dictionary<string, string> environment)
+    {
+        Dictionary<string, string> previous = CurrentEnvironment();
+        foreach (string name in previous.Keys)
+        {
+            if (!environment.ContainsKey(name))
+                Environment.SetEnvironmentVariable(name, null);
+        }
+        foreach (var (name, value) in environment)
+            Environment.SetEnvironmentVariable(name, value);
+        return previous;
+    }
+
+    private static bool TryConnect(string socketPath)
+    {
+        using var socket = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+        try
+        {
+            socket.Connect(new UnixDomainSocketEndPoint(socketPath));
+            return true;
+        }
+        catch (SocketException)
+        {
+            return false;
+        }
+    }
+
+    // Frame: kind byte, little-endian int32 length (at most MaxFrameLength),
+    // payload.
+    private static void WriteFrame(Stream stream, byte kind, ReadOnlySpan<byte> payload)
+    {
+        if (payload.Length > MaxFrameLength)
+            throw new IOException($"frame of {payload.Length} bytes exceeds the protocol limit");
+
+        Span<byte> header = stackalloc byte[5];
+        header[0] = kind;
+        BitConverter.TryWriteBytes(header.Slice(1), payload.Length);
+        stream.Write(header);
+        stream.Write(payload);
+        stream.Flush();
+    }
+
+    private static bool ReadFrame(Stream stream, out byte kind, out byte[] payload)
+    {
+        kind = 0;
+        payload = null;
+        byte[] header = new byte[5];
+        if (stream.ReadAtLeast(header, header.Length, throwOnEndOfStream: false) < header.Length)
+            return false;
+
+        kind = header[0];
+        int length = BitConverter.ToInt32(header, 1);
+        if (length < 0 || length > MaxFrameLength)
+            throw new IOException($"bad frame length {length}");
+
+        payload = new byte[length];
+        return stream.ReadAtLeast(payload, payload.Length, throwOnEndOfStream: false) == payload.Length;
+    }
+
+    private sealed class Request
+    {
+        public string WorkingDirectory { get; set; }
+        public string[] Arguments { get; set; }
+        public Dictionary<string, string> Environment { get; set; }
+        public string Compiler { get; set; }
+    }
+
+    // Each write becomes one frame of its channel. Tools' output arrives on
+    // other threads, hence the lock shared by both channels.
+    private sealed class FrameStream : Stream
+    {
+        private readonly Stream _inner;
+        private readonly byte _kind;
+        private readonly object _lock;
+
+        public FrameStream(Stream inner, byte kind, object streamLock)
+        {
+            _inner = inner;
+            _kind = kind;
+            _lock = streamLock;
+        }
+
+        public override void Write(byte[] buffer, int offset, int count) => Write(buffer.AsSpan(offset, count));
+
+        public override void Write(ReadOnlySpan<byte> buffer)
+        {
+            lock (_lock)
+            {
+                for (int at = 0; at < buffer.Length; at += MaxFrameLength)
+                    WriteFrame(_inner, _kind, buffer.Slice(at, Math.Min(MaxFrameLength, buffer.Length - at)));
+            }
+        }
+
+        public override void Flush() { }
+        public override bool CanRead => false;
+        public override bool CanSeek => false;
+        public override bool CanWrite => true;
+        public override long Length => throw new NotSupportedException();
+        public override long Position { get => throw new NotSupportedException(); set => throw new NotSupportedException(); }
+        public override int Read(byte[] buffer, int offset, int count) => throw new NotSupportedException();
+        public override long Seek(long offset, SeekOrigin origin) => throw new NotSupportedException();
+        public override void SetLength(long value) => throw new NotSupportedException();
+    }
+}
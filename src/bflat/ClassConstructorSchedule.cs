@@ -0,0 +1,361 @@
+// bflat C# compiler
+// Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+
+using ILCompiler;
+using ILCompiler.DependencyAnalysis;
+
+using Internal.IL;
+using Internal.TypeSystem;
+
+// Eager class-constructor schedule for zkVM builds.
+//
+// Every type whose cctor the compiler could not preinitialize keeps a
+// StaticClassConstructionContext (one word: the cctor address, zeroed by the
+// runtime once it has run) just below its non-GC statics. The schedule lists
+// those contexts for the beforefieldinit types in dependency order, as a
+// linker-script fragment that lld places after .rodata between
+// __start_zk_cctors and __stop_zk_cctors. ubootstrap runs them from a module
+// initializer, after the library initializers, command-line arguments and
+// AppContext are set up and right before Main, so the lazy check at each
+// access finds a zero word and never reaches ClassConstructorRunner. A cctor
+// that throws there is put back and stays lazy.
+//
+// Types with a precise cctor (no beforefieldinit) must run at first access
+// and stay lazy, as do generic instantiations, whose cctor bodies are shared.
+// So do cctors that no code reachable from the entry point can trigger:
+// compiled is not the same as used, and running an unused cctor eagerly only
+// adds cycles to every proof. Whatever the library initializers trigger has
+// already run lazily by the time the schedule does.
+//
+// Reachability and cost come from one IL call graph over typical method
+// definitions. A virtual call reaches every compiled override with the same
+// name, which over-approximates in the safe direction.
+internal static class ClassConstructorSchedule
+{
+    private sealed class Entry
+    {
+        public MetadataType Type;
+        public string Symbol;
+        public string LazyReason;
+        public readonly List<Entry> Dependencies = new List<Entry>();
+    }
+
+    /// <summary>
+    /// Writes the schedule to <paramref name="scriptPath"/> and a report of
+    /// every class constructor that survived preinitialization to
+    /// <paramref name="reportPath"/>. Only cctors reachable from
+    /// <paramref name="entryPoints"/> are scheduled. Returns the number of
+    /// scheduled cctors.
+    /// </summary>
+    public static int Write(string scriptPath, string reportPath, NodeFactory factory,
+        IEnumerable<MethodDesc> compiledMethods, IEnumerable<MethodDesc> entryPoints,
+        PreinitializationManager preinitManager, ILProvider ilProvider)
+    {
+        var entries = new Dictionary<TypeDesc, Entry>();
+        foreach (MethodDesc method in compiledMethods)
+        {
+            if (!method.IsStaticConstructor || method.OwningType is not MetadataType type)
+                continue;
+            if (entries.ContainsKey(type) || !preinitManager.HasLazyStaticConstructor(type))
+                continue;
+
+            var entry = new Entry { Type = type };
+            if (type.HasInstantiation || type.IsCanonicalSubtype(CanonicalFormKind.Any))
+                entry.LazyReason = "generic instantiation";
+            else if (!type.IsBeforeFieldInit)
+                entry.LazyReason = "precise cctor (not beforefieldinit)";
+            entries.Add(type, entry);
+        }
+
+        var graph = new CallGraph(ilProvider, compiledMethods);
+        HashSet<TypeDesc> reached = graph.TypesReachedFrom(entryPoints, entries.Keys);
+        foreach (Entry entry in entries.Values)
+        {
+            if (entry.LazyReason == null && !reached.Contains(entry.Type.GetTypeDefinition()))
+                entry.LazyReason = "not reachable from the entry point";
+            if (entry.LazyReason == null)
+                entry.Symbol = factory.TypeNonGCStaticsSymbol(entry.Type).GetMangledName(factory.NameMangler);
+        }
+
+        // An edge A -> B means A's cctor touches B's statics or static
+        // methods directly, so B runs first and A's access is a flag test.
+        foreach (Entry entry in entries.Values)
+        {
+            if (entry.Symbol == null)
+                continue;
+            foreach (TypeDesc dependency in graph.Facts(entry.Type.GetStaticConstructor()).Statics)
+            {
+                if (dependency != entry.Type && entries.TryGetValue(dependency, out Entry target) && target.Symbol != null)
+                    entry.Dependencies.Add(target);
+            }
+        }
+
+        // Post-order DFS over a name-sorted list keeps the schedule stable
+        // across runs; cycles are cut where they are first met, exactly as
+        // the lazy path would cut them.
+        var ordered = new List<Entry>();
+        var visited = new HashSet<Entry>();
+        void Visit(Entry entry)
+        {
+            if (!visited.Add(entry))
+                return;
+            foreach (Entry dependency in entry.Dependencies.OrderBy(e => e.Symbol, StringComparer.Ordinal))
+                Visit(dependency);
+            ordered.Add(entry);
+        }
+        foreach (Entry entry in entries.Values.Where(e => e.Symbol != null).OrderBy(e => e.Symbol, StringComparer.Ordinal))
+            Visit(entry);
+
+        int contextSize = NonGCStaticsNode.GetClassConstructorContextSize(factory.Target);
+
+        var script = new StringBuilder();
+        script.AppendLine("/* Generated by bflat: eager class-constructor schedule, run by ubootstrap. */");
+        script.AppendLine("SECTIONS");
+        script.AppendLine("{");
+        script.AppendLine("  .zk_cctors : ALIGN(8)");
+        script.AppendLine("  {");
+        script.AppendLine("    __start_zk_cctors = .;");
+        foreach (Entry entry in ordered)
+            script.AppendLine($"    QUAD({entry.Symbol} - {contextSize})");
+        script.AppendLine("    __stop_zk_cctors = .;");
+        script.AppendLine("  }");
+        script.AppendLine("}");
+        script.AppendLine("INSERT AFTER .rodata;");
+        File.WriteAllText(scriptPath, script.ToString());
+
+        var report = new StringBuilder();
+        report.AppendLine($"# {ordered.Count} eager, {entries.Count - ordered.Count} lazy class constructors");
+        report.AppendLine("# Neither kind could be preinitialized; eager ones run in this order before Main.");
+        report.AppendLine("# cost: IL bytes in the cctor and every method it can call, excluding other cctors.");
+        foreach (Entry entry in ordered)
+        {
+            (int methods, long ilBytes) = graph.Cost(entry.Type.GetStaticConstructor());
+            report.AppendLine($"eager  {entry.Type}: cost {ilBytes} IL bytes in {methods} methods; {GetFailureReason(preinitManager, entry.Type)}");
+        }
+        foreach (Entry entry in entries.Values.Where(e => e.Symbol == null).OrderBy(e => e.Type.ToString(), StringComparer.Ordinal))
+            report.AppendLine($"lazy   {entry.Type}: {entry.LazyReason}; {GetFailureReason(preinitManager, entry.Type)}");
+        File.WriteAllText(reportPath, report.ToString());
+
+        return ordered.Count;
+    }
+
+    private static string GetFailureReason(PreinitializationManager preinitManager, MetadataType type)
+    {
+        try
+        {
+            return preinitManager.GetPreinitializationInfo(type).FailureReason ?? "not preinitialized";
+        }
+        catch (Exception)
+        {
+            return "not preinitialized";
+        }
+    }
+
+    // What one method body references, read from its IL.
+    private sealed class MethodFacts
+    {
+        public int ILSize;
+        public readonly List<TypeDesc> Statics = new List<TypeDesc>();     // statics or static methods touched
+        public readonly List<MethodDesc> Callees = new List<MethodDesc>(); // typical definitions
+    }
+
+    private sealed class CallGraph
+    {
+        private readonly ILProvider _ilProvider;
+        private readonly Dictionary<MethodDesc, MethodFacts> _facts = new Dictionary<MethodDesc, MethodFacts>();
+        private readonly ILookup<string, MethodDesc> _overrides;
+
+        public CallGraph(ILProvider ilProvider, IEnumerable<MethodDesc> compiledMethods)
+        {
+            _ilProvider = ilProvider;
+            _overrides = compiledMethods
+                .Where(m => m.IsVirtual)
+                .Select(m => m.GetTypicalMethodDefinition())
+                .Distinct()
+                .ToLookup(m => SlotName(m));
+        }
+
+        // Explicit implementations are named "Namespace.IFoo.Bar".
+        private static string SlotName(MethodDesc method) => method.Name.Substring(method.Name.LastIndexOf('.') + 1);
+
+        /// <summary>
+        /// Type definitions among <paramref name="candidates"/> whose cctor
+        /// code reachable from <paramref name="roots"/> can trigger; the
+        /// bodies of those cctors count as reachable too.
+        /// </summary>
+        public HashSet<TypeDesc> TypesReachedFrom(IEnumerable<MethodDesc> roots, IEnumerable<TypeDesc> candidates)
+        {
+            ILookup<TypeDesc, TypeDesc> byDefinition = candidates.ToLookup(t => t.GetTypeDefinition());
+            var reached = new HashSet<TypeDesc>();
+            var visited = new HashSet<MethodDesc>();
+            var pending = new Stack<MethodDesc>(roots.Where(m => m != null).Select(m => m.GetTypicalMethodDefinition()));
+            while (pending.Count > 0)
+            {
+                MethodDesc method = pending.Pop();
+                if (!visited.Add(method))
+                    continue;
+
+                MethodFacts facts = Facts(method);
+                foreach (MethodDesc callee in facts.Callees)
+                    pending.Push(callee);
+                foreach (TypeDesc type in facts.Statics)
+                {
+                    TypeDesc definition = type.GetTypeDefinition();
+                    if (!byDefinition.Contains(definition) || !reached.Add(definition))
+                        continue;
+                    if (definition.GetStaticConstructor() is MethodDesc cctor)
+                        pending.Push(cctor.GetTypicalMethodDefinition());
+                }
+            }
+            return reached;
+        }
+
+        /// <summary>
+        /// Methods and IL bytes reachable from <paramref name="cctor"/>,
+        /// itself included, without entering other class constructors.
+        /// </summary>
+        public (int Methods, long ILBytes) Cost(MethodDesc cctor)
+        {
+            var visited = new HashSet<MethodDesc>();
+            var pending = new Stack<MethodDesc>();
+            pending.Push(cctor.GetTypicalMethodDefinition());
+            long ilBytes = 0;
+            while (pending.Count > 0)
+            {
+                MethodDesc method = pending.Pop();
+                if (!visited.Add(method))
+                    continue;
+
+                MethodFacts facts = Facts(method);
+                ilBytes += facts.ILSize;
+                foreach (MethodDesc callee in facts.Callees)
+                {
+                    if (!callee.IsStaticConstructor)
+                        pending.Push(callee);
+                }
+            }
+            return (visited.Count, ilBytes);
+        }
+
+        public MethodFacts Facts(MethodDesc method)
+        {
+            if (_facts.TryGetValue(method, out MethodFacts facts))
+                return facts;
+
+            facts = new MethodFacts();
+            _facts.Add(method, facts);
+
+            MethodIL methodIL;
+            try
+            {
+                methodIL = _ilProvider.GetMethodIL(method);
+            }
+            catch (TypeSystemException)
+            {
+                return facts;
+            }
+            if (methodIL == null)
+                return facts;
+
+            byte[] il = methodIL.GetILBytes();
+            facts.ILSize = il.Length;
+            int offset = 0;
+            while (offset < il.Length)
+            {
+                ILOpcode opcode = (ILOpcode)il[offset++];
+                if (opcode == ILOpcode.prefix1)
+                    opcode = (ILOpcode)(0x100 + il[offset++]);
+
+                switch (opcode)
+                {
+                    case ILOpcode.ldsfld:
+                    case ILOpcode.ldsflda:
+                    case ILOpcode.stsfld:
+                        if (ResolveToken(methodIL, il, offset) is FieldDesc field)
+                            facts.Statics.Add(field.OwningType);
+                        break;
+                    case ILOpcode.call:
+                    case ILOpcode.callvirt:
+                    case ILOpcode.newobj:
+                    case ILOpcode.ldftn:
+                    case ILOpcode.ldvirtftn:
+                        if (ResolveToken(methodIL, il, offset) is not MethodDesc callee)
+                            break;
+                        if (callee.Signature.IsStatic || opcode == ILOpcode.newobj)
+                            facts.Statics.Add(callee.OwningType);
+                        facts.Callees.Add(callee.GetTypicalMethodDefinition());
+                        if (callee.IsVirtual && (opcode == ILOpcode.callvirt || opcode == ILOpcode.ldvirtftn))
+                            facts.Callees.AddRange(_overrides[SlotName(callee)]);
+                        break;
+                }
+
+                offset += GetOperandSize(opcode, il, offset);
+            }
+            return facts;
+        }
+    }
+
+    private static object ResolveToken(MethodIL methodIL, byte[] il, int offset)
+    {
+        try
+        {
+            return methodIL.GetObject(BitConverter.ToInt32(il, offset));
+        }
+        catch (TypeSystemException)
+        {
+            return null;
+        }
+    }
+
+    private static int GetOperandSize(ILOpcode opcode, byte[] il, int offset)
+    {
+        switch (opcode)
+        {
+            case >= ILOpcode.br_s and <= ILOpcode.blt_un_s:
+            case ILOpcode.ldarg_s or ILOpcode.ldarga_s or ILOpcode.starg_s:
+            case ILOpcode.ldloc_s or ILOpcode.ldloca_s or ILOpcode.stloc_s:
+            case ILOpcode.ldc_i4_s or ILOpcode.leave_s or ILOpcode.unaligned or ILOpcode.no:
+                return 1;
+            case ILOpcode.ldarg or ILOpcode.ldarga or ILOpcode.starg:
+            case ILOpcode.ldloc or ILOpcode.ldloca or ILOpcode.stloc:
+                return 2;
+            case ILOpcode.ldc_i8 or ILOpcode.ldc_r8:
+                return 8;
+            case ILOpcode.@switch:
+                return 4 + 4 * BitConverter.ToInt32(il, offset);
+            case >= ILOpcode.br and <= ILOpcode.blt_un:
+            case ILOpcode.ldc_i4 or ILOpcode.ldc_r4 or ILOpcode.leave:
+            case ILOpcode.jmp or ILOpcode.call or ILOpcode.calli or ILOpcode.callvirt:
+            case ILOpcode.cpobj or ILOpcode.ldobj or ILOpcode.ldstr or ILOpcode.newobj:
+            case ILOpcode.castclass or ILOpcode.isinst or ILOpcode.unbox:
+            case >= ILOpcode.ldfld and <= ILOpcode.stobj:
+            case ILOpcode.box or ILOpcode.newarr or ILOpcode.ldelema:
+            case ILOpcode.ldelem or ILOpcode.stelem or ILOpcode.unbox_any:
+            case ILOpcode.refanyval or ILOpcode.mkrefany or ILOpcode.ldtoken:
+            case ILOpcode.ldftn or ILOpcode.ldvirtftn or ILOpcode.initobj:
+            case ILOpcode.constrained or ILOpcode.@sizeof:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+}
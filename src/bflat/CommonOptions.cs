@@ -61,6 +61,10 @@ internal static class CommonOptions
             ArgumentHelpName = "file"
         };
 
+    public static Option<bool> ServerOption =
+        new Option<bool>("--server",
+            "Run the build on the 'bflat build-server' daemon if one is listening, else in this process");
+
     public static Option<string[]> DefinedSymbolsOption =
         new Option<string[]>(new string[] { "-d", "--define" },
             "Define conditional compilation symbol(s)");
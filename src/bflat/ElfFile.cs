@@ -0,0 +1,256 @@
+// bflat C# compiler
+// Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+// A little-endian ELF64 image held in memory, for the tools that read or
+// patch a linked guest after lld: rebake, the zisk post-processor and the
+// stack-depth analysis.
+//
+// Only the section header table is modelled. Edits go to the Section objects
+// (and, for contents, straight to Image); WriteSectionHeaders puts the table
+// back in place, so everything the edits do not touch stays byte-identical.
+internal sealed class ElfFile
+{
+    public const uint ShtProgbits = 1, ShtSymtab = 2, ShtRela = 4, ShtNobits = 8, ShtRel = 9, ShtDynsym = 11;
+    public const ulong ShfWrite = 0x1, ShfAlloc = 0x2, ShfExecinstr = 0x4, ShfInfoLink = 0x40, ShfTls = 0x400;
+    public const ushort ShnAbs = 0xFFF1, ShnLoreserve = 0xFF00;
+    public const int SttNotype = 0, SttObject = 1, SttFunc = 2, SttSection = 3, SttFile = 4;
+    public const int StbLocal = 0;
+
+    public const int SectionHeaderSize = 64;
+
+    public sealed class Section
+    {
+        public string Name;
+        public uint NameOffset;
+        public uint Type;
+        public ulong Flags, Addr, Offset, Size, Align, Entsize;
+        public uint Link, Info;
+    }
+
+    public readonly record struct Symbol(string Name, ulong Value, ulong Size, byte Info, ushort SectionIndex)
+    {
+        public int Type => Info & 0xF;
+        public int Bind => Info >> 4;
+    }
+
+    public byte[] Image { get; }
+    public List<Section> Sections { get; }
+    public int SectionHeaderOffset { get; }
+    private int _shstrndx;
+
+    public ElfFile(byte[] image)
+    {
+        if (image.Length < 64 || image[0] != 0x7F || image[1] != (byte)'E' ||
+            image[2] != (byte)'L' || image[3] != (byte)'F' || image[4] != 2 || image[5] != 1)
+            throw new Exception("not a little-endian 64-bit ELF");
+
+        Image = image;
+        SectionHeaderOffset = (int)RdU64(image, 0x28);
+        int shentsize = RdU16(image, 0x3A);
+        int shnum = RdU16(image, 0x3C);
+        _shstrndx = RdU16(image, 0x3E);
+        if (shnum != 0 && shentsize != SectionHeaderSize)
+            throw new Exception($"unexpected section header size {shentsize}");
+
+        Sections = new List<Section>(shnum);
+        for (int i = 0; i < shnum; i++)
+        {
+            int b = SectionHeaderOffset + i * SectionHeaderSize;
+            Sections.Add(new Section
+            {
+                NameOffset = RdU32(image, b),
+                Type = RdU32(image, b + 4),
+                Flags = RdU64(image, b + 8),
+                Addr = RdU64(image, b + 16),
+                Offset = RdU64(image, b + 24),
+                Size = RdU64(image, b + 32),
+                Link = RdU32(image, b + 40),
+                Info = RdU32(image, b + 44),
+                Align = RdU64(image, b + 48),
+                Entsize = RdU64(image, b + 56),
+            });
+        }
+
+        if (_shstrndx < Sections.Count)
+        {
+            int names = (int)Sections[_shstrndx].Offset;
+            foreach (Section s in Sections)
+                s.Name = ReadCString(image, names + (int)s.NameOffset);
+        }
+    }
+
+    public static ElfFile Read(string path) => new ElfFile(File.ReadAllBytes(path));
+
+    public Section Find(string name) => Sections.Find(s => s.Name == name);
+
+    public int IndexOf(Section section) => Sections.IndexOf(section);
+
+    /// <summary>File offset of <paramref name="vaddr"/>, or -1 outside the PROGBITS sections.</summary>
+    public int VaddrToFileOffset(ulong vaddr)
+    {
+        foreach (Section s in Sections)
+        {
+            if (s.Type == ShtProgbits && s.Size != 0 && vaddr >= s.Addr && vaddr < s.Addr + s.Size)
+                return (int)(s.Offset + (vaddr - s.Addr));
+        }
+        return -1;
+    }
+
+    public ReadOnlySpan<byte> Contents(Section section) =>
+        section.Type == ShtNobits ? default : Image.AsSpan((int)section.Offset, (int)section.Size);
+
+    /// <summary>Entries of a SYMTAB or DYNSYM section, index 0 (the null symbol) included.</summary>
+    public IEnumerable<Symbol> ReadSymbols(Section table)
+    {
+        if (table.Entsize == 0)
+            yield break;
+
+        int names = (int)Sections[(int)table.Link].Offset;
+        for (ulong o = table.Offset; o + table.Entsize <= table.Offset + table.Size; o += table.Entsize)
+        {
+            int e = (int)o;
+            yield return new Symbol(
+                ReadCString(Image, names + (int)RdU32(Image, e)),
+                RdU64(Image, e + 8),
+                RdU64(Image, e + 16),
+                Image[e + 4],
+                RdU16(Image, e + 6));
+        }
+    }
+
+    /// <summary>Symbols of .symtab, or of .dynsym when the image is stripped.</summary>
+    public IEnumerable<Symbol> ReadSymbols()
+    {
+        Section table = Sections.Find(s => s.Type == ShtSymtab) ?? Sections.Find(s => s.Type == ShtDynsym);
+        return table != null ? ReadSymbols(table) : Array.Empty<Symbol>();
+    }
+
+    public ulong FindSymbolVaddr(string name)
+    {
+        foreach (Section s in Sections)
+        {
+            if (s.Type != ShtSymtab)
+                continue;
+            foreach (Symbol symbol in ReadSymbols(s))
+            {
+                if (symbol.Name == name)
+                    return symbol.Value;
+            }
+        }
+        throw new Exception($"symbol {name} not found");
+    }
+
+    /// <summary>
+    /// Drops the headers of the matching sections; their bytes stay where they
+    /// are. Section links, relocation targets and symbol section indices are
+    /// renumbered, and symbols of a dropped section become absolute.
+    /// </summary>
+    public int RemoveSections(Predicate<Section> match)
+    {
+        var newIndex = new int[Sections.Count];
+        var kept = new List<Section>();
+        for (int i = 0; i < Sections.Count; i++)
+        {
+            bool drop = i != 0 && i != _shstrndx && match(Sections[i]);
+            newIndex[i] = drop ? -1 : kept.Count;
+            if (!drop)
+                kept.Add(Sections[i]);
+        }
+        int removed = Sections.Count - kept.Count;
+        if (removed == 0)
+            return 0;
+
+        uint Renumber(uint index) => index < newIndex.Length && newIndex[index] >= 0 ? (uint)newIndex[index] : 0;
+
+        foreach (Section s in kept)
+        {
+            if (s.Link != 0)
+                s.Link = Renumber(s.Link);
+            if (s.Info != 0 && ((s.Flags & ShfInfoLink) != 0 || s.Type == ShtRel || s.Type == ShtRela))
+                s.Info = Renumber(s.Info);
+
+            if ((s.Type == ShtSymtab || s.Type == ShtDynsym) && s.Entsize != 0)
+            {
+                for (ulong o = s.Offset; o + s.Entsize <= s.Offset + s.Size; o += s.Entsize)
+                {
+                    Span<byte> shndx = Image.AsSpan((int)o + 6, 2);
+                    ushort index = BinaryPrimitives.ReadUInt16LittleEndian(shndx);
+                    if (index == 0 || index >= ShnLoreserve || index >= newIndex.Length)
+                        continue;
+                    ushort renumbered = newIndex[index] >= 0 ? (ushort)newIndex[index] : ShnAbs;
+                    BinaryPrimitives.WriteUInt16LittleEndian(shndx, renumbered);
+                }
+            }
+        }
+
+        _shstrndx = newIndex[_shstrndx];
+        Sections.Clear();
+        Sections.AddRange(kept);
+
+        // The shorter table is written over the start of the old one.
+        Image.AsSpan(SectionHeaderOffset + kept.Count * SectionHeaderSize, removed * SectionHeaderSize).Clear();
+        return removed;
+    }
+
+    /// <summary>Writes the section table back over the original one.</summary>
+    public void WriteSectionHeaders()
+    {
+        for (int i = 0; i < Sections.Count; i++)
+            PackSectionHeader(Sections[i]).CopyTo(Image, SectionHeaderOffset + i * SectionHeaderSize);
+        BinaryPrimitives.WriteUInt16LittleEndian(Image.AsSpan(0x3C), (ushort)Sections.Count);  // e_shnum
+        BinaryPrimitives.WriteUInt16LittleEndian(Image.AsSpan(0x3E), (ushort)_shstrndx);       // e_shstrndx
+    }
+
+    public void Write(string path)
+    {
+        WriteSectionHeaders();
+        File.WriteAllBytes(path, Image);
+    }
+
+    public static byte[] PackSectionHeader(Section s)
+    {
+        var h = new byte[SectionHeaderSize];
+        BinaryPrimitives.WriteUInt32LittleEndian(h.AsSpan(0), s.NameOffset);   // sh_name
+        BinaryPrimitives.WriteUInt32LittleEndian(h.AsSpan(4), s.Type);         // sh_type
+        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(8), s.Flags);        // sh_flags
+        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(16), s.Addr);        // sh_addr
+        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(24), s.Offset);      // sh_offset
+        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(32), s.Size);        // sh_size
+        BinaryPrimitives.WriteUInt32LittleEndian(h.AsSpan(40), s.Link);        // sh_link
+        BinaryPrimitives.WriteUInt32LittleEndian(h.AsSpan(44), s.Info);        // sh_info
+        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(48), s.Align);       // sh_addralign
+        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(56), s.Entsize);     // sh_entsize
+        return h;
+    }
+
+    public static string ReadCString(byte[] b, int off)
+    {
+        int end = off;
+        while (end < b.Length && b[end] != 0)
+            end++;
+        return Encoding.ASCII.GetString(b, off, end - off);
+    }
+
+    public static ulong RdU64(byte[] b, int o) => BinaryPrimitives.ReadUInt64LittleEndian(b.AsSpan(o));
+    public static uint RdU32(byte[] b, int o) => BinaryPrimitives.ReadUInt32LittleEndian(b.AsSpan(o));
+    public static ushort RdU16(byte[] b, int o) => BinaryPrimitives.ReadUInt16LittleEndian(b.AsSpan(o));
+}
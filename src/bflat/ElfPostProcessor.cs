@@ -0,0 +1,377 @@
+// bflat C# compiler
+// Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+
+// Turns the ELF lld produced for `--libc zisk` into one the Zisk loader
+// accepts (the `.patched` file). The Zisk loader works from section headers,
+// so every pass is a section-header edit:
+//
+//   - .init_array becomes PROGBITS with 8-byte alignment;
+//   - .tdata gets ALLOC|WRITE|TLS and at least 8-byte alignment;
+//   - the headers of .dotnet_eh_table, .eh_frame_hdr and .eh_frame go, so
+//     the unwind tables are not loaded (their bytes stay in the file);
+//   - the .bss header goes; the guest RAM starts zeroed anyway.
+//
+// The image is read once, edited in memory and written once. This replaces
+// scripts/patch_elf.py, which needed Python with LIEF and pyelftools, and
+// objdump for the function boundary report.
+internal static class ElfPostProcessor
+{
+    private static readonly string[] EhSections = { ".dotnet_eh_table", ".eh_frame_hdr", ".eh_frame" };
+
+    /// <summary>
+    /// Post-processes <paramref name="inputPath"/> into <paramref name="outputPath"/>.
+    /// With a <paramref name="boundaryReport"/>, also writes the function
+    /// boundary report for the input image to it.
+    /// </summary>
+    public static void Run(string inputPath, string outputPath, TextWriter boundaryReport)
+    {
+        ElfFile elf = ElfFile.Read(inputPath);
+
+        // Before the EH headers go: the report reads .eh_frame.
+        if (boundaryReport != null)
+            WriteFunctionBoundaries(elf, boundaryReport);
+
+        ElfFile.Section initArray = elf.Find(".init_array");
+        if (initArray != null)
+        {
+            initArray.Type = ElfFile.ShtProgbits;
+            initArray.Align = 8;
+        }
+
+        ElfFile.Section tdata = elf.Find(".tdata");
+        if (tdata != null)
+        {
+            tdata.Flags |= ElfFile.ShfAlloc | ElfFile.ShfWrite | ElfFile.ShfTls;
+            tdata.Align = Math.Max(8, tdata.Align);
+        }
+
+        elf.RemoveSections(s => Array.IndexOf(EhSections, s.Name) >= 0 || s.Name == ".bss");
+        elf.Write(outputPath);
+    }
+
+    // Where each function in .text starts and ends, from three sources: the
+    // .eh_frame FDEs, the symbol sizes, and a scan of the code itself (from
+    // each symbol to the next, stopping at unimp). FDEs win, then the scan,
+    // then symbols; code the scan finds past the end of an FDE is listed on
+    // its own, and anything still without a size runs to the next start.
+    private static void WriteFunctionBoundaries(ElfFile elf, TextWriter report)
+    {
+        ElfFile.Section text = elf.Find(".text");
+        ulong t0 = text?.Addr ?? 0;
+        ulong t1 = text != null ? text.Addr + text.Size : ulong.MaxValue;
+        int textIndex = text != null ? elf.IndexOf(text) : -1;
+
+        Dictionary<ulong, ulong> ehSizes = ReadEhFrame(elf, t0, t1);
+
+        var symSizes = new Dictionary<ulong, ulong>();
+        var labels = new SortedSet<ulong> { t0 };
+        foreach (ElfFile.Section table in elf.Sections.Where(s => s.Type == ElfFile.ShtSymtab || s.Type == ElfFile.ShtDynsym))
+        {
+            foreach (ElfFile.Symbol symbol in elf.ReadSymbols(table))
+            {
+                if (symbol.SectionIndex == textIndex && symbol.Type <= ElfFile.SttFunc && !symbol.Name.StartsWith('$'))
+                    labels.Add(symbol.Value);
+
+                if (symbol.Type != ElfFile.SttFunc || symbol.SectionIndex == 0 || symbol.Value < t0 || symbol.Value >= t1)
+                    continue;
+                ulong s = symbol.Value;
+                ulong size = Math.Min(symbol.Value + symbol.Size, t1) - s;
+                // the smallest among duplicates
+                symSizes[s] = symSizes.TryGetValue(s, out ulong previous) && previous != 0 ? Math.Min(previous, size) : size;
+            }
+        }
+
+        Dictionary<ulong, ulong> codeSizes = text != null && text.Type != ElfFile.ShtNobits
+            ? ScanCode(elf, text, labels)
+            : new Dictionary<ulong, ulong>();
+
+        var merged = new SortedDictionary<ulong, ulong>();
+        var chosenBy = new Dictionary<ulong, string>();
+        foreach (ulong s in ehSizes.Keys.Union(symSizes.Keys).Union(codeSizes.Keys))
+        {
+            if (ehSizes.TryGetValue(s, out ulong eh))
+                (merged[s], chosenBy[s]) = (eh, "eh");
+            else if (codeSizes.TryGetValue(s, out ulong code) && code > 0)
+                (merged[s], chosenBy[s]) = (code, "code");
+            else if (symSizes.TryGetValue(s, out ulong sym))
+                (merged[s], chosenBy[s]) = (sym, "symtab");
+            else
+                (merged[s], chosenBy[s]) = (0, "none");
+        }
+
+        // Code the scan found past the end of an FDE that nothing else covers.
+        // Gaps under 16 bytes (four instructions) are padding or constants.
+        var ordered = merged.Keys.ToList();
+        var residual = new Dictionary<ulong, ulong>();
+        void AddResidual(ulong start, ulong end)
+        {
+            if (end >= start + 16)
+                residual[start] = Math.Max(residual.GetValueOrDefault(start), end - start);
+        }
+        foreach (ulong s in ordered)
+        {
+            if (chosenBy[s] != "eh")
+                continue;
+            ulong eh = ehSizes[s];
+            ulong code = codeSizes.GetValueOrDefault(s);
+            if (code <= eh)
+                continue;
+
+            ulong cur = s + eh, end = s + code;
+            foreach (ulong other in ordered)
+            {
+                if (other >= end)
+                    break;
+                if (other > cur)
+                    AddResidual(cur, Math.Min(other, end));
+                cur = Math.Max(cur, other + merged[other]);
+            }
+            AddResidual(cur, end);
+        }
+        foreach (var (s, size) in residual)
+        {
+            if (merged.GetValueOrDefault(s) == 0)
+                (merged[s], chosenBy[s]) = (size, "code+residual");
+        }
+
+        ordered = merged.Keys.ToList();
+        for (int i = 0; i + 1 < ordered.Count; i++)
+        {
+            ulong s = ordered[i];
+            if (merged[s] > 0)
+                continue;
+            ulong end = Math.Min(ordered[i + 1], t1);
+            if (end > Math.Max(s, t0))
+            {
+                merged[s] = end - Math.Max(s, t0);
+                chosenBy[s] += "+next_start";
+            }
+        }
+
+        report.WriteLine("== function boundary report ==");
+        report.WriteLine($".text: [0x{t0:x} .. 0x{t1:x}) size=0x{(t1 > t0 ? t1 - t0 : 0):x}");
+        report.WriteLine("columns: start  size  end   chosen  eh  sym  code");
+        foreach (var (s, size) in merged)
+        {
+            if (size == 0)
+                continue;
+            report.WriteLine($"0x{s:x16} 0x{size:x8} 0x{s + size:x16} {chosenBy[s],-12} " +
+                $"eh=0x{ehSizes.GetValueOrDefault(s):x8} sym=0x{symSizes.GetValueOrDefault(s):x8} code=0x{codeSizes.GetValueOrDefault(s):x8}");
+        }
+        report.WriteLine("== end function boundary report ==");
+    }
+
+    // Extent of the code from each label: instructions up to the next label,
+    // ending early at unimp (the zero halfword or "csrrw zero, cycle, zero").
+    // Code after an unimp starts a block of its own.
+    private static Dictionary<ulong, ulong> ScanCode(ElfFile elf, ElfFile.Section text, SortedSet<ulong> labels)
+    {
+        byte[] image = elf.Image;
+        ulong t0 = text.Addr, t1 = text.Addr + text.Size;
+        var sizes = new Dictionary<ulong, ulong>();
+        var starts = labels.Where(a => a >= t0 && a < t1).ToList();
+
+        for (int i = 0; i < starts.Count; i++)
+        {
+            ulong limit = i + 1 < starts.Count ? starts[i + 1] : t1;
+            ulong blockStart = starts[i], blockEnd = blockStart;
+            ulong pc = blockStart;
+            while (pc + 2 <= limit)
+            {
+                int at = (int)(text.Offset + (pc - t0));
+                ushort half = ElfFile.RdU16(image, at);
+                bool compressed = (half & 3) != 3;
+                if (!compressed && pc + 4 > limit)
+                    break;
+                uint length = compressed ? 2u : 4u;
+                bool unimp = compressed ? half == 0 : ElfFile.RdU32(image, at) == 0xC0001073;
+
+                if (unimp)
+                {
+                    Record(sizes, blockStart, blockEnd);
+                    blockStart = blockEnd = pc + length;
+                }
+                else
+                {
+                    blockEnd = pc + length;
+                }
+                pc += length;
+            }
+            Record(sizes, blockStart, blockEnd);
+        }
+        return sizes;
+
+        static void Record(Dictionary<ulong, ulong> sizes, ulong start, ulong end)
+        {
+            if (end > start)
+                sizes[start] = Math.Max(sizes.GetValueOrDefault(start), end - start);
+        }
+    }
+
+    // PC ranges of the FDEs in .eh_frame, clipped to [t0, t1).
+    private static Dictionary<ulong, ulong> ReadEhFrame(ElfFile elf, ulong t0, ulong t1)
+    {
+        var sizes = new Dictionary<ulong, ulong>();
+        ElfFile.Section ehFrame = elf.Find(".eh_frame");
+        if (ehFrame == null || ehFrame.Type == ElfFile.ShtNobits)
+            return sizes;
+
+        byte[] d = elf.Image;
+        int sectionStart = (int)ehFrame.Offset, sectionEnd = sectionStart + (int)ehFrame.Size;
+        ulong Address(int pos) => ehFrame.Addr + (ulong)(pos - sectionStart);
+        var cieEncodings = new Dictionary<int, byte>();
+
+        int pos = sectionStart;
+        while (pos + 4 <= sectionEnd)
+        {
+            ulong length = ElfFile.RdU32(d, pos);
+            pos += 4;
+            if (length == 0)
+                break;
+            bool is64 = length == 0xFFFFFFFF;
+            if (is64)
+            {
+                length = ElfFile.RdU64(d, pos);
+                pos += 8;
+            }
+            int idPos = pos;
+            int next = idPos + (int)length;
+            if (next > sectionEnd)
+                break;
+
+            ulong id = is64 ? ElfFile.RdU64(d, pos) : ElfFile.RdU32(d, pos);
+            pos += is64 ? 8 : 4;
+            if (id != 0)
+            {
+                int ciePos = idPos - (int)id;
+                if (!cieEncodings.TryGetValue(ciePos, out byte encoding))
+                    cieEncodings[ciePos] = encoding = ReadCieFdeEncoding(d, ciePos, Address);
+
+                ulong start = ReadEncoded(d, ref pos, encoding, Address(pos));
+                ulong range = ReadEncoded(d, ref pos, (byte)(encoding & 0x0F), 0);
+                ulong s = Math.Max(start, t0), e = Math.Min(start + range, t1);
+                if (range > 0 && e > s)
+                    sizes[s] = e - s;
+            }
+            pos = next;
+        }
+        return sizes;
+    }
+
+    // The pointer encoding ('R' augmentation) of the CIE at ciePos.
+    private static byte ReadCieFdeEncoding(byte[] d, int ciePos, Func<int, ulong> address)
+    {
+        const byte DwEhPeAbsptr = 0x00;
+
+        int pos = ciePos + 4;
+        if (ElfFile.RdU32(d, ciePos) == 0xFFFFFFFF)
+            pos += 8;
+        pos += 4;                                   // CIE id (4 or 8 bytes; the 64-bit form is never used here)
+        byte version = d[pos++];
+        string augmentation = ElfFile.ReadCString(d, pos);
+        pos += augmentation.Length + 1;
+        if (!augmentation.StartsWith('z'))
+            return DwEhPeAbsptr;
+
+        ReadUleb(d, ref pos);                       // code alignment
+        ReadUleb(d, ref pos);                       // data alignment (sleb, same length)
+        if (version == 1)
+            pos++;                                  // return register
+        else
+            ReadUleb(d, ref pos);
+        ReadUleb(d, ref pos);                       // augmentation data length
+
+        foreach (char c in augmentation.AsSpan(1))
+        {
+            switch (c)
+            {
+                case 'R':
+                    return d[pos];
+                case 'L':
+                    pos++;
+                    break;
+                case 'P':
+                    byte personality = d[pos++];
+                    ReadEncoded(d, ref pos, personality, address(pos));
+                    break;
+                case 'S':
+                case 'B':
+                    break;
+                default:
+                    return DwEhPeAbsptr;
+            }
+        }
+        return DwEhPeAbsptr;
+    }
+
+    // A DW_EH_PE_* encoded value. Only pc-relative application matters for
+    // PC ranges; indirection and the other bases are not used on RISC-V.
+    private static ulong ReadEncoded(byte[] d, ref int pos, byte encoding, ulong fieldAddress)
+    {
+        ulong value;
+        switch (encoding & 0x0F)
+        {
+            case 0x00: value = ElfFile.RdU64(d, pos); pos += 8; break;                 // absptr
+            case 0x01: value = ReadUleb(d, ref pos); break;                             // uleb128
+            case 0x02: value = ElfFile.RdU16(d, pos); pos += 2; break;                 // udata2
+            case 0x03: value = ElfFile.RdU32(d, pos); pos += 4; break;                 // udata4
+            case 0x04: value = ElfFile.RdU64(d, pos); pos += 8; break;                 // udata8
+            case 0x09: value = (ulong)ReadSleb(d, ref pos); break;                      // sleb128
+            case 0x0A: value = (ulong)(long)(short)ElfFile.RdU16(d, pos); pos += 2; break;  // sdata2
+            case 0x0B: value = (ulong)(long)(int)ElfFile.RdU32(d, pos); pos += 4; break;    // sdata4
+            case 0x0C: value = ElfFile.RdU64(d, pos); pos += 8; break;                 // sdata8
+            default: throw new Exception($"unsupported pointer encoding 0x{encoding:x2} in .eh_frame");
+        }
+        if ((encoding & 0x70) == 0x10)              // pcrel
+            value += fieldAddress;
+        return value;
+    }
+
+    private static ulong ReadUleb(byte[] d, ref int pos)
+    {
+        ulong result = 0;
+        int shift = 0;
+        byte b;
+        do
+        {
+            b = d[pos++];
+            result |= (ulong)(b & 0x7F) << shift;
+            shift += 7;
+        } while ((b & 0x80) != 0);
+        return result;
+    }
+
+    private static long ReadSleb(byte[] d, ref int pos)
+    {
+        long result = 0;
+        int shift = 0;
+        byte b;
+        do
+        {
+            b = d[pos++];
+            result |= (long)(b & 0x7F) << shift;
+            shift += 7;
+        } while ((b & 0x80) != 0);
+        if (shift < 64 && (b & 0x40) != 0)
+            result |= -1L << shift;
+        return result;
+    }
+}
@@ -0,0 +1,392 @@
+// bflat C# compiler
+// Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+using System;
+using System.Buffers.Binary;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Runtime.InteropServices;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading.Tasks;
+
+// Symbol tables of ELF files and ar archives, read in process for
+// --symchart, alloc-profile and --wrap-check.
+//
+// Inputs are memory-mapped and only the section headers, symbol tables and
+// their string tables are touched, so a 100+ MB managed object costs a page-in
+// of those tables rather than a readelf or nm run and a parse of its text.
+// Both 32- and 64-bit little-endian ELF are understood; archives are walked
+// member by member, plus their symbol index.
+//
+// ReadNames, which --wrap-check uses, reads its inputs in parallel and caches
+// each input's name set, on disk and in the process, so the runtime libraries
+// every build links are parsed once. An entry is keyed on the file's path,
+// size, modification time and inode, which a stat returns without reading
+// the file; a file rewritten in place or replaced by a rename gets a new key.
+internal static unsafe class ElfSymbolReader
+{
+    private static readonly ConcurrentDictionary<string, HashSet<string>> s_names = new();
+
+    private delegate T MappedReader<T>(ReadOnlySpan<byte> data);
+
+    /// <summary>
+    /// Every entry of the .symtab and .dynsym tables of <paramref name="binaryPath"/>,
+    /// in the form <c>readelf -sW</c> prints them. Returns <c>null</c> (after
+    /// printing a warning) if the file cannot be read as ELF.
+    /// </summary>
+    public static List<ElfSymbol> ReadBinary(string binaryPath)
+    {
+        try
+        {
+            return Map(binaryPath, data =>
+            {
+                if (!IsElf(data))
+                    throw new InvalidDataException("not an ELF file");
+                var symbols = new List<ElfSymbol>();
+                ReadElf(data, symbols, null);
+                return symbols;
+            });
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException or InvalidDataException or ArgumentOutOfRangeException)
+        {
+            Console.Error.WriteLine($"Warning: could not read the symbols of {binaryPath}: {ex.Message}");
+            return null;
+        }
+    }
+
+    /// <summary>
+    /// The names of all symbols, defined or referenced, in the objects and
+    /// archives <paramref name="paths"/> (what <c>nm --print-armap</c> lists).
+    /// Inputs that cannot be read are reported and skipped.
+    /// </summary>
+    public static HashSet<string> ReadNames(IReadOnlyList<string> paths)
+    {
+        var perInput = new HashSet<string>[paths.Count];
+        string cacheRoot = CacheRoot();
+        Parallel.For(0, paths.Count, i =>
+        {
+            try
+            {
+                perInput[i] = ReadNames(paths[i], cacheRoot);
+            }
+            catch (Exception ex) when (ex is IOException or UnauthorizedAccessException or InvalidDataException or ArgumentOutOfRangeException)
+            {
+                Console.Error.WriteLine($"Warning: could not read the symbols of {paths[i]}: {ex.Message}");
+            }
+        });
+
+        var names = new HashSet<string>(StringComparer.Ordinal);
+        foreach (HashSet<string> set in perInput)
+        {
+            if (set != null)
+                names.UnionWith(set);
+        }
+        return names;
+    }
+
+    // $BFLAT_SYMBOL_CACHE, else $XDG_CACHE_HOME/bflat/symbols, else ~/.cache/bflat/symbols.
+    private static string CacheRoot()
+    {
+        string root = Environment.GetEnvironmentVariable("BFLAT_SYMBOL_CACHE");
+        if (!string.IsNullOrEmpty(root))
+            return root;
+
+        string cacheHome = Environment.GetEnvironmentVariable("XDG_CACHE_HOME");
+        if (string.IsNullOrEmpty(cacheHome))
+            cacheHome = Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.UserProfile), ".cache");
+        return Path.Combine(cacheHome, "bflat", "symbols");
+    }
+
+    private static HashSet<string> ReadNames(string path, string cacheRoot)
+    {
+        string identity = Identity(path);
+        if (s_names.TryGetValue(identity, out HashSet<string> names))
+            return names;
+
+        string entry = Path.Combine(cacheRoot, CacheKey(identity));
+        if (File.Exists(entry))
+        {
+            names = new HashSet<string>(File.ReadAllText(entry).Split('\n', StringSplitOptions.RemoveEmptyEntries), StringComparer.Ordinal);
+            s_names[identity] = names;
+            return names;
+        }
+
+        names = Map(path, data =>
+        {
+            var set = new HashSet<string>(StringComparer.Ordinal);
+            if (IsArchive(data, out bool thin))
+                ReadArchive(data, thin, set);
+            else if (IsElf(data))
+                ReadElf(data, null, set);
+            else
+                throw new InvalidDataException("neither an ELF object nor an archive");
+
+            return set;
+        });
+
+        Store(entry, names);
+        s_names[identity] = names;
+        return names;
+    }
+
+    /// <summary>
+    /// Full path, size, modification time and device:inode of
+    /// <paramref name="path"/>, one per line. Where statx is not available
+    /// the time has 100 ns ticks and the inode is 0.
+    /// </summary>
+    internal static string Identity(string path)
+    {
+        string fullPath = Path.GetFullPath(path);
+        if (OperatingSystem.IsLinux())
+        {
+            // struct statx: stx_ino at 32, stx_size at 40, stx_mtime at 112,
+            // stx_dev_major/minor at 136; the same layout on every architecture.
+            byte* buffer = stackalloc byte[256];
+            if (statx(AtFdcwd, fullPath, 0, StatxBasicStats, buffer) == 0)
+            {
+                var stat = new ReadOnlySpan<byte>(buffer, 256);
+                ulong inode = BinaryPrimitives.ReadUInt64LittleEndian(stat.Slice(32));
+                ulong size = BinaryPrimitives.ReadUInt64LittleEndian(stat.Slice(40));
+                long seconds = BinaryPrimitives.ReadInt64LittleEndian(stat.Slice(112));
+                uint nanoseconds = BinaryPrimitives.ReadUInt32LittleEndian(stat.Slice(120));
+                uint devMajor = BinaryPrimitives.ReadUInt32LittleEndian(stat.Slice(136));
+                uint devMinor = BinaryPrimitives.ReadUInt32LittleEndian(stat.Slice(140));
+                return $"{fullPath}\n{size}\n{seconds}.{nanoseconds:D9}\n{devMajor}:{devMinor}:{inode}";
+            }
+        }
+
+        var info = new FileInfo(fullPath);
+        return $"{fullPath}\n{info.Length}\n{info.LastWriteTimeUtc.Ticks}\n0";
+    }
+
+    // The identity is hashed only to make a file name of it.
+    internal static string CacheKey(string identity) =>
+        Convert.ToHexString(SHA256.HashData(Encoding.UTF8.GetBytes(identity))).ToLowerInvariant();
+
+    private const int AtFdcwd = -100;
+    private const uint StatxBasicStats = 0x7FF;
+
+    [DllImport("libc")]
+    private static extern int statx(int dirfd, [MarshalAs(UnmanagedType.LPUTF8Str)] string path, int flags, uint mask, byte* buffer);
+
+    // Written under a temporary name and renamed, so readers see all or nothing.
+    // A failure only costs the next build a parse.
+    private static void Store(string entry, HashSet<string> names)
+    {
+        string temp = entry + $".{Environment.ProcessId}.{Guid.NewGuid():N}.tmp";
+        try
+        {
+            Directory.CreateDirectory(Path.GetDirectoryName(entry));
+            File.WriteAllText(temp, string.Join('\n', names));
+            File.Move(temp, entry, overwrite: true);
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            try { File.Delete(temp); } catch { }
+        }
+    }
+
+    private static T Map<T>(string path, MappedReader<T> read)
+    {
+        using var file = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read);
+        if (file.Length == 0)
+            return read(default);
+
+        using var mapping = MemoryMappedFile.CreateFromFile(file, null, 0, MemoryMappedFileAccess.Read, HandleInheritability.None, leaveOpen: true);
+        using var view = mapping.CreateViewAccessor(0, 0, MemoryMappedFileAccess.Read);
+        byte* pointer = null;
+        view.SafeMemoryMappedViewHandle.AcquirePointer(ref pointer);
+        try
+        {
+            return read(new ReadOnlySpan<byte>(pointer + view.PointerOffset, checked((int)file.Length)));
+        }
+        finally
+        {
+            view.SafeMemoryMappedViewHandle.ReleasePointer();
+        }
+    }
+
+    private static bool IsElf(ReadOnlySpan<byte> data) =>
+        data.Length >= 52 && data[0] == 0x7F && data[1] == (byte)'E' && data[2] == (byte)'L' && data[3] == (byte)'F'
+        && (data[4] == 1 || data[4] == 2) && data[5] == 1;
+
+    private static bool IsArchive(ReadOnlySpan<byte> data, out bool thin)
+    {
+        thin = data.StartsWith("!<thin>\n"u8);
+        return thin || data.StartsWith("!<arch>\n"u8);
+    }
+
+    // The symbol index ("/" or "/SYM64/") names every defined global; the
+    // members' own tables add locals and undefined references. A thin
+    // archive's members live in other files, so only its index is read.
+    private static void ReadArchive(ReadOnlySpan<byte> data, bool thin, HashSet<string> names)
+    {
+        int pos = 8;
+        while (pos + 60 <= data.Length)
+        {
+            ReadOnlySpan<byte> header = data.Slice(pos, 60);
+            string name = Encoding.ASCII.GetString(header.Slice(0, 16)).TrimEnd(' ');
+            // A thin member's size is that of the file it names, not bytes here.
+            bool inline = !thin || name == "/" || name == "/SYM64/" || name == "//";
+            if (!long.TryParse(Encoding.ASCII.GetString(header.Slice(48, 10)).Trim(), out long size) ||
+                size < 0 || (inline && pos + 60 + size > data.Length))
+                throw new InvalidDataException($"bad archive member header at offset {pos}");
+            pos += 60;
+
+            ReadOnlySpan<byte> member = inline ? data.Slice(pos, (int)size) : default;
+
+            if (name == "/" || name == "/SYM64/")
+                ReadArchiveIndex(member, name == "/SYM64/" ? 8 : 4, names);
+            else if (!member.IsEmpty && IsElf(member))
+                ReadElf(member, null, names);
+
+            if (inline)
+                pos += (int)size + (int)(size & 1);
+        }
+    }
+
+    // Big-endian count, that many member offsets, then the names.
+    private static void ReadArchiveIndex(ReadOnlySpan<byte> index, int wordSize, HashSet<string> names)
+    {
+        if (index.Length < wordSize)
+            return;
+        long count = wordSize == 8
+            ? (long)BinaryPrimitives.ReadUInt64BigEndian(index)
+            : BinaryPrimitives.ReadUInt32BigEndian(index);
+        long start = wordSize * (count + 1);
+        if (count < 0 || start > index.Length)
+            throw new InvalidDataException("bad archive symbol index");
+
+        ReadOnlySpan<byte> strings = index.Slice((int)start);
+        for (long i = 0; i < count && !strings.IsEmpty; i++)
+        {
+            int end = strings.IndexOf((byte)0);
+            if (end < 0)
+                end = strings.Length;
+            if (end > 0)
+                names.Add(Encoding.UTF8.GetString(strings.Slice(0, end)));
+            strings = strings.Slice(Math.Min(end + 1, strings.Length));
+        }
+    }
+
+    // Walks the SYMTAB and DYNSYM sections, adding full entries to `symbols`
+    // and/or names to `names`.
+    private static void ReadElf(ReadOnlySpan<byte> elf, List<ElfSymbol> symbols, HashSet<string> names)
+    {
+        bool is64 = elf[4] == 2;
+        ulong shoff = is64 ? BinaryPrimitives.ReadUInt64LittleEndian(elf.Slice(0x28)) : BinaryPrimitives.ReadUInt32LittleEndian(elf.Slice(0x20));
+        int shentsize = BinaryPrimitives.ReadUInt16LittleEndian(elf.Slice(is64 ? 0x3A : 0x2E));
+        int shnum = BinaryPrimitives.ReadUInt16LittleEndian(elf.Slice(is64 ? 0x3C : 0x30));
+        if (shoff == 0 || shnum == 0)
+            return;
+        if (shoff + (ulong)(shnum * shentsize) > (ulong)elf.Length)
+            throw new InvalidDataException("section header table is out of bounds");
+
+        for (int i = 0; i < shnum; i++)
+        {
+            ReadOnlySpan<byte> sh = elf.Slice((int)shoff + i * shentsize, shentsize);
+            uint type = BinaryPrimitives.ReadUInt32LittleEndian(sh.Slice(4));
+            if (type != ElfFile.ShtSymtab && type != ElfFile.ShtDynsym)
+                continue;
+
+            (ulong offset, ulong size, uint link, ulong entsize) = is64
+                ? (BinaryPrimitives.ReadUInt64LittleEndian(sh.Slice(24)), BinaryPrimitives.ReadUInt64LittleEndian(sh.Slice(32)),
+                   BinaryPrimitives.ReadUInt32LittleEndian(sh.Slice(40)), BinaryPrimitives.ReadUInt64LittleEndian(sh.Slice(56)))
+                : (BinaryPrimitives.ReadUInt32LittleEndian(sh.Slice(16)), BinaryPrimitives.ReadUInt32LittleEndian(sh.Slice(20)),
+                   BinaryPrimitives.ReadUInt32LittleEndian(sh.Slice(24)), BinaryPrimitives.ReadUInt32LittleEndian(sh.Slice(36)));
+            if (entsize == 0 || link >= shnum || offset + size > (ulong)elf.Length)
+                continue;
+
+            ReadOnlySpan<byte> strtabHeader = elf.Slice((int)shoff + (int)link * shentsize, shentsize);
+            ulong strOffset = is64 ? BinaryPrimitives.ReadUInt64LittleEndian(strtabHeader.Slice(24)) : BinaryPrimitives.ReadUInt32LittleEndian(strtabHeader.Slice(16));
+            ulong strSize = is64 ? BinaryPrimitives.ReadUInt64LittleEndian(strtabHeader.Slice(32)) : BinaryPrimitives.ReadUInt32LittleEndian(strtabHeader.Slice(20));
+            if (strOffset + strSize > (ulong)elf.Length)
+                continue;
+            ReadOnlySpan<byte> strtab = elf.Slice((int)strOffset, (int)strSize);
+
+            int count = (int)(size / entsize);
+            for (int n = 0; n < count; n++)
+            {
+                ReadOnlySpan<byte> e = elf.Slice((int)(offset + (ulong)n * entsize), (int)entsize);
+                uint nameOffset = BinaryPrimitives.ReadUInt32LittleEndian(e);
+                string name = nameOffset < strtab.Length ? CString(strtab.Slice((int)nameOffset)) : string.Empty;
+
+                if (names != null)
+                {
+                    if (name.Length != 0)
+                        names.Add(name);
+                    continue;
+                }
+
+                ulong value, symbolSize;
+                byte info, other;
+                ushort shndx;
+                if (is64)
+                {
+                    info = e[4];
+                    other = e[5];
+                    shndx = BinaryPrimitives.ReadUInt16LittleEndian(e.Slice(6));
+                    value = BinaryPrimitives.ReadUInt64LittleEndian(e.Slice(8));
+                    symbolSize = BinaryPrimitives.ReadUInt64LittleEndian(e.Slice(16));
+                }
+                else
+                {
+                    value = BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(4));
+                    symbolSize = BinaryPrimitives.ReadUInt32LittleEndian(e.Slice(8));
+                    info = e[12];
+                    other = e[13];
+                    shndx = BinaryPrimitives.ReadUInt16LittleEndian(e.Slice(14));
+                }
+
+                symbols.Add(new ElfSymbol(n, value, symbolSize,
+                    TypeName(info & 0xF), BindName(info >> 4), VisibilityName(other & 3), SectionName(shndx), name));
+            }
+        }
+    }
+
+    private static string CString(ReadOnlySpan<byte> s)
+    {
+        int end = s.IndexOf((byte)0);
+        return Encoding.UTF8.GetString(end < 0 ? s : s.Slice(0, end));
+    }
+
+    // readelf's spelling of each field.
+    private static string TypeName(int type) => type switch
+    {
+        0 => "NOTYPE", 1 => "OBJECT", 2 => "FUNC", 3 => "SECTION", 4 => "FILE", 5 => "COMMON", 6 => "TLS", 10 => "IFUNC",
+        _ => type.ToString(),
+    };
+
+    private static string BindName(int bind) => bind switch
+    {
+        0 => "LOCAL", 1 => "GLOBAL", 2 => "WEAK", 10 => "UNIQUE",
+        _ => bind.ToString(),
+    };
+
+    private static string VisibilityName(int visibility) => visibility switch
+    {
+        0 => "DEFAULT", 1 => "INTERNAL", 2 => "HIDDEN", _ => "PROTECTED",
+    };
+
+    private static string SectionName(ushort shndx) => shndx switch
+    {
+        0 => "UND", 0xFFF1 => "ABS", 0xFFF2 => "COM",
+        _ => shndx.ToString(),
+    };
+}
@@ -54,6 +54,7 @@ internal class ILBuildCommand : CommandBase
             CommonOptions.ResourceOption,
             CommonOptions.NoDebugInfoOption,
             CommonOptions.LangVersionOption,
+            CommonOptions.ServerOption,
             OptimizeOption,
         };
         command.Handler = new ILBuildCommand();
@@ -167,6 +168,25 @@ internal class ILBuildCommand : CommandBase
             languageVersion);
     }
 
+    // Reference metadata by path, reused while the file is unchanged. Only
+    // pays off in a process that compiles more than once (bflat build-server),
+    // where the hundreds of framework references are read a single time.
+    private static readonly Dictionary<string, (DateTime Stamp, MetadataReference Reference)> MetadataReferenceCache = new();
+
+    private static MetadataReference GetMetadataReference(string path)
+    {
+        DateTime stamp = File.GetLastWriteTimeUtc(path);
+        lock (MetadataReferenceCache)
+        {
+            if (MetadataReferenceCache.TryGetValue(path, out var cached) && cached.Stamp == stamp)
+                return cached.Reference;
+
+            MetadataReference reference = MetadataReference.CreateFromFile(path);
+            MetadataReferenceCache[path] = (stamp, reference);
+            return reference;
+        }
+    }
+
     private static CSharpCompilation CreateCompilation(
         string moduleName,
         string[] inputFiles,
@@ -192,7 +212,7 @@ internal class ILBuildCommand : CommandBase
 
         var metadataReferences = new List<MetadataReference>();
         foreach (var reference in references)
-            metadataReferences.Add(MetadataReference.CreateFromFile(reference));
+            metadataReferences.Add(GetMetadataReference(reference));
 
         if (!LanguageVersionFacts.TryParse(languageVersion, out LanguageVersion langVer))
         {
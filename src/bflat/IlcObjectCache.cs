@@ -0,0 +1,192 @@
+// bflat C# compiler
+// Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Security.Cryptography;
+using System.Text;
+
+// Content-addressed cache of the native object ILC produces.
+//
+// The key is a SHA-256 over everything the scanner and RyuJIT see: the IL
+// Roslyn emitted (deterministically), the contents of every reference
+// assembly and MIBC profile, the compile-affecting command-line options, the
+// feature switches and direct P/Invoke list, and the identity (size and
+// timestamp) of the compiler binaries and JIT libraries themselves. A hit
+// restores the object and the compile-time side files (exports list, cctor
+// schedule, reports) and the build goes straight to the link.
+//
+// Entries are directories named after the key. They are written under a
+// unique temporary name and renamed into place, so a concurrent build sees
+// either no entry or a complete one; when two builds race to store the same
+// key, the loser drops its copy. Restores copy through a temporary file too.
+// Nothing is ever evicted; delete the directory to reclaim space.
+internal sealed class IlcObjectCache
+{
+    private const string ObjectName = "object";
+
+    private readonly string _root;
+    private readonly IncrementalHash _hash = IncrementalHash.CreateHash(HashAlgorithmName.SHA256);
+    private string _key;
+
+    /// <param name="compilerBinaries">
+    /// Assemblies and libraries the compile runs, besides bflat itself and
+    /// the JITs next to it.
+    /// </param>
+    public IlcObjectCache(string root, IEnumerable<string> compilerBinaries)
+    {
+        _root = root;
+        AddCompilerIdentity(compilerBinaries);
+    }
+
+    public string Key => _key ??= Convert.ToHexString(_hash.GetHashAndReset()).ToLowerInvariant();
+
+    // BFLAT_ILC_CACHE, else $XDG_CACHE_HOME/bflat/ilc, else ~/.cache/bflat/ilc.
+    public static string DefaultRoot()
+    {
+        string root = Environment.GetEnvironmentVariable("BFLAT_ILC_CACHE");
+        if (!string.IsNullOrEmpty(root))
+            return root;
+
+        string cacheHome = Environment.GetEnvironmentVariable("XDG_CACHE_HOME");
+        if (string.IsNullOrEmpty(cacheHome))
+            cacheHome = Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.UserProfile), ".cache");
+        return Path.Combine(cacheHome, "bflat", "ilc");
+    }
+
+    public void AddString(string value)
+    {
+        byte[] bytes = Encoding.UTF8.GetBytes(value ?? "\0null");
+        AddLength(bytes.Length);
+        _hash.AppendData(bytes);
+    }
+
+    public void AddBytes(ReadOnlySpan<byte> bytes)
+    {
+        AddLength(bytes.Length);
+        _hash.AppendData(bytes);
+    }
+
+    // By name and content: the same framework in another directory still hits.
+    public void AddFile(string path)
+    {
+        AddString(Path.GetFileName(path));
+        using FileStream stream = File.OpenRead(path);
+        AddLength(stream.Length);
+        byte[] buffer = new byte[1 << 16];
+        int read;
+        while ((read = stream.Read(buffer, 0, buffer.Length)) > 0)
+            _hash.AppendData(buffer, 0, read);
+    }
+
+    /// <summary>
+    /// Copies the cached object to <paramref name="objectFilePath"/> and each
+    /// side file to its path. Returns false, touching nothing, on a miss.
+    /// </summary>
+    public bool TryRestore(string objectFilePath, IReadOnlyList<string> sideFiles)
+    {
+        string entry = Path.Combine(_root, Key);
+        if (!File.Exists(Path.Combine(entry, ObjectName)))
+            return false;
+        for (int i = 0; i < sideFiles.Count; i++)
+        {
+            if (!File.Exists(Path.Combine(entry, SideName(i))))
+                return false;
+        }
+
+        CopyThroughTemp(Path.Combine(entry, ObjectName), objectFilePath);
+        for (int i = 0; i < sideFiles.Count; i++)
+            CopyThroughTemp(Path.Combine(entry, SideName(i)), sideFiles[i]);
+        return true;
+    }
+
+    /// <summary>
+    /// Publishes the object and side files under the key. Failures only cost
+    /// the next build a compile, so they are reported and swallowed.
+    /// </summary>
+    public void Store(string objectFilePath, IReadOnlyList<string> sideFiles)
+    {
+        string entry = Path.Combine(_root, Key);
+        if (Directory.Exists(entry))
+            return;
+
+        string staging = Path.Combine(_root, $".{Key}.{Environment.ProcessId}.{Guid.NewGuid():N}");
+        try
+        {
+            Directory.CreateDirectory(staging);
+            File.Copy(objectFilePath, Path.Combine(staging, ObjectName));
+            for (int i = 0; i < sideFiles.Count; i++)
+                File.Copy(sideFiles[i], Path.Combine(staging, SideName(i)));
+
+            try
+            {
+                Directory.Move(staging, entry);
+            }
+            catch (IOException) when (Directory.Exists(entry))
+            {
+                // Another build stored the same key first.
+            }
+        }
+        catch (Exception ex) when (ex is IOException or UnauthorizedAccessException)
+        {
+            Console.Error.WriteLine($"Warning: could not store the ILC object in the cache: {ex.Message}");
+        }
+        finally
+        {
+            try { Directory.Delete(staging, recursive: true); } catch { }
+        }
+    }
+
+    private static string SideName(int index) => $"side{index}";
+
+    private static void CopyThroughTemp(string source, string destination)
+    {
+        string temp = destination + $".{Environment.ProcessId}.tmp";
+        File.Copy(source, temp, overwrite: true);
+        File.Move(temp, destination, overwrite: true);
+    }
+
+    // A rebuilt bflat or JIT must miss, even when the inputs are the same.
+    private void AddCompilerIdentity(IEnumerable<string> compilerBinaries)
+    {
+        var binaries = new List<string>
+        {
+            Environment.ProcessPath,
+            typeof(IlcObjectCache).Assembly.Location,
+        };
+        binaries.AddRange(compilerBinaries);
+        if (Directory.Exists(AppContext.BaseDirectory))
+            binaries.AddRange(Directory.GetFiles(AppContext.BaseDirectory, "*jit*"));
+
+        foreach (string binary in binaries)
+        {
+            if (string.IsNullOrEmpty(binary) || !File.Exists(binary))
+                continue;
+            var info = new FileInfo(binary);
+            AddString(info.FullName);
+            AddLength(info.Length);
+            AddLength(info.LastWriteTimeUtc.Ticks);
+        }
+    }
+
+    private void AddLength(long value)
+    {
+        Span<byte> bytes = stackalloc byte[sizeof(long)];
+        BitConverter.TryWriteBytes(bytes, value);
+        _hash.AppendData(bytes);
+    }
+}
@@ -21,6 +21,7 @@ using System.CommandLine.Help;
 using System.CommandLine.Parsing;
 using System.Diagnostics;
 using System.IO;
+using System.Linq;
 using System.Reflection;
 
 class Program
@@ -43,6 +44,16 @@ class Program
 
         using PerfWatch total = new PerfWatch("Total");
 
+        // `bflat build --server` (or build-il): hand the build to a running
+        // build-server, or do it here when there is none.
+        if (args.Length > 0 && (args[0] == "build" || args[0] == "build-il") && args.Contains("--server"))
+        {
+            args = args.Where(a => a != "--server").ToArray();
+            if (BuildServerCommand.TryForward(args, out int serverExitCode))
+                return serverExitCode;
+        }
+
+        Parser parser = null;
         var root = new RootCommand(
             "Bflat C# compiler\n" +
             "Copyright (c) 2021-2022 Michal Strehovsky\n" +
@@ -51,6 +62,8 @@ class Program
             BuildCommand.Create(),
             ILBuildCommand.Create(),
             RebakeCommand.Create(),
+            AllocProfileCommand.Create(),
+            BuildServerCommand.Create(buildArgs => parser.Invoke(buildArgs)),
             InfoOption,
         };
         root.SetHandler(ctx =>
@@ -79,7 +92,7 @@ class Program
             }
         });
 
-        Parser parser = new CommandLineBuilder(root)
+        parser = new CommandLineBuilder(root)
                 .UseVersionOption("-v")
                 .UseParseErrorReporting()
                 .UseHelp()
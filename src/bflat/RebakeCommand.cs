@@ -20,7 +20,6 @@ using System.Collections.Generic;
 using System.CommandLine;
 using System.CommandLine.Parsing;
 using System.IO;
-using System.Text;
 
 // Bakes a ziskemu memory snapshot into a Zisk guest ELF so it restores warm at
 // startup instead of cold-booting. The guest must have been built with the
@@ -48,8 +47,6 @@ internal class RebakeCommand : CommandBase
     private const int Page = 4096;
     private const ulong RamLo = 0xA0020000;  // guest RAM start (zkvm_zisk script.ld)
     private const ulong RamHi = 0xC0000000;
-    private const ulong ShfWrite = 0x1, ShfAlloc = 0x2;
-    private const uint ShtProgbits = 1, ShtSymtab = 2;
 
     private static readonly Argument<string> GuestArgument =
         new Argument<string>("guest-elf")
@@ -74,13 +71,6 @@ internal class RebakeCommand : CommandBase
         return command;
     }
 
-    private sealed class Section
-    {
-        public uint Type;
-        public ulong Flags, Addr, Offset, Size, Entsize;
-        public uint Link;
-    }
-
     private sealed class Run
     {
         public ulong Start;
@@ -96,12 +86,23 @@ internal class RebakeCommand : CommandBase
         byte[] snap = File.ReadAllBytes(snapshotPath);
         ParseSnapshot(snap, out ulong pc, out ulong[] regs, out List<Run> runs);
 
-        byte[] elf = File.ReadAllBytes(guestPath);
-        List<Section> sections = ReadSectionTable(elf, out int eShoff, out int eShentsize, out int eShnum);
+        ElfFile guest;
+        ulong blobVaddr;
+        try
+        {
+            guest = ElfFile.Read(guestPath);
+            blobVaddr = guest.FindSymbolVaddr(SnapshotSymbol);
+        }
+        catch (Exception e)
+        {
+            throw new Exception("rebake: " + e.Message);
+        }
+        byte[] elf = guest.Image;
 
         // 1. write the register blob into __zkvm_snapshot
-        ulong blobVaddr = FindSymbolVaddr(elf, sections, SnapshotSymbol);
-        int blobOffset = VaddrToFileOffset(sections, blobVaddr);
+        int blobOffset = guest.VaddrToFileOffset(blobVaddr);
+        if (blobOffset < 0)
+            throw new Exception($"rebake: vaddr 0x{blobVaddr:x} not in any PROGBITS section");
         byte[] blob = BuildBlob(pc, regs);
         if (blob.Length > BlobReserved)
             throw new Exception($"rebake: register blob {blob.Length} exceeds reserved {BlobReserved}");
@@ -110,17 +111,17 @@ internal class RebakeCommand : CommandBase
         // 2. neutralise the guest's own writable-in-RAM sections so their cold
         //    values do not override the warm image
         int neutralised = 0;
-        for (int i = 0; i < sections.Count; i++)
+        foreach (ElfFile.Section s in guest.Sections)
         {
-            Section s = sections[i];
-            if ((s.Flags & ShfAlloc) != 0 && (s.Flags & ShfWrite) != 0 &&
+            if ((s.Flags & ElfFile.ShfAlloc) != 0 && (s.Flags & ElfFile.ShfWrite) != 0 &&
                 s.Addr >= RamLo && s.Addr < RamHi)
             {
-                int hdr = eShoff + i * eShentsize;
-                BinaryPrimitives.WriteUInt64LittleEndian(elf.AsSpan(hdr + 8), s.Flags & ~ShfAlloc);
+                s.Flags &= ~ElfFile.ShfAlloc;
                 neutralised++;
             }
         }
+        guest.WriteSectionHeaders();
+        int shnum = guest.Sections.Count;
 
         // 3. append the warm runs as new writable PROGBITS sections, then a new
         //    section header table (original entries + one per run)
@@ -141,17 +142,26 @@ internal class RebakeCommand : CommandBase
         long newShoff = outp.Position;
 
         // original section headers (carrying the neutralised flags) ...
-        outp.Write(elf, eShoff, eShnum * eShentsize);
+        outp.Write(elf, guest.SectionHeaderOffset, shnum * ElfFile.SectionHeaderSize);
         // ... plus one PROGBITS entry per warm run
         for (int r = 0; r < runs.Count; r++)
         {
-            byte[] hdr = PackSectionHeader(runs[r].Start, (ulong)runOffsets[r], (ulong)runs[r].Data.Count);
+            // sh_name/link/info/entsize = 0
+            byte[] hdr = ElfFile.PackSectionHeader(new ElfFile.Section
+            {
+                Type = ElfFile.ShtProgbits,
+                Flags = ElfFile.ShfAlloc | ElfFile.ShfWrite,
+                Addr = runs[r].Start,
+                Offset = (ulong)runOffsets[r],
+                Size = (ulong)runs[r].Data.Count,
+                Align = 8,
+            });
             outp.Write(hdr, 0, hdr.Length);
         }
 
         byte[] outBytes = outp.ToArray();
         BinaryPrimitives.WriteUInt64LittleEndian(outBytes.AsSpan(0x28), (ulong)newShoff);            // e_shoff
-        BinaryPrimitives.WriteUInt16LittleEndian(outBytes.AsSpan(0x3C), (ushort)(eShnum + runs.Count)); // e_shnum
+        BinaryPrimitives.WriteUInt16LittleEndian(outBytes.AsSpan(0x3C), (ushort)(shnum + runs.Count)); // e_shnum
         File.WriteAllBytes(outputPath, outBytes);
 
         long span = runs.Count == 0 ? 0
@@ -213,62 +223,6 @@ internal class RebakeCommand : CommandBase
         }
     }
 
-    private static List<Section> ReadSectionTable(byte[] elf, out int eShoff, out int eShentsize, out int eShnum)
-    {
-        if (elf.Length < 64 || elf[0] != 0x7F || elf[1] != (byte)'E' ||
-            elf[2] != (byte)'L' || elf[3] != (byte)'F' || elf[4] != 2)
-            throw new Exception("rebake: not a 64-bit ELF");
-
-        eShoff = (int)RdU64(elf, 0x28);
-        eShentsize = RdU16(elf, 0x3A);
-        eShnum = RdU16(elf, 0x3C);
-
-        var secs = new List<Section>();
-        for (int i = 0; i < eShnum; i++)
-        {
-            int b = eShoff + i * eShentsize;
-            secs.Add(new Section
-            {
-                Type = RdU32(elf, b + 4),
-                Flags = RdU64(elf, b + 8),
-                Addr = RdU64(elf, b + 16),
-                Offset = RdU64(elf, b + 24),
-                Size = RdU64(elf, b + 32),
-                Link = RdU32(elf, b + 40),
-                Entsize = RdU64(elf, b + 56),
-            });
-        }
-        return secs;
-    }
-
-    private static ulong FindSymbolVaddr(byte[] elf, List<Section> secs, string name)
-    {
-        foreach (Section s in secs)
-        {
-            if (s.Type != ShtSymtab || s.Entsize == 0)
-                continue;
-            ulong strOff = secs[(int)s.Link].Offset;
-            for (ulong o = s.Offset; o < s.Offset + s.Size; o += s.Entsize)
-            {
-                uint stName = RdU32(elf, (int)o);
-                if (ReadCString(elf, (int)(strOff + stName)) == name)
-                    return RdU64(elf, (int)o + 8);
-            }
-        }
-        throw new Exception($"rebake: symbol {name} not found");
-    }
-
-    private static int VaddrToFileOffset(List<Section> secs, ulong vaddr)
-    {
-        foreach (Section s in secs)
-        {
-            if (s.Type == ShtProgbits && s.Size != 0 &&
-                vaddr >= s.Addr && vaddr < s.Addr + s.Size)
-                return (int)(s.Offset + (vaddr - s.Addr));
-        }
-        throw new Exception($"rebake: vaddr 0x{vaddr:x} not in any PROGBITS section");
-    }
-
     private static byte[] BuildBlob(ulong pc, ulong[] regs)
     {
         // layout: magic u32, pad u32, pc u64, regs[32] u64  ->  272 bytes
@@ -280,33 +234,11 @@ internal class RebakeCommand : CommandBase
         return b;
     }
 
-    private static byte[] PackSectionHeader(ulong addr, ulong offset, ulong size)
-    {
-        var h = new byte[64];
-        BinaryPrimitives.WriteUInt32LittleEndian(h.AsSpan(4), ShtProgbits);            // sh_type
-        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(8), ShfAlloc | ShfWrite);    // sh_flags
-        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(16), addr);                  // sh_addr
-        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(24), offset);                // sh_offset
-        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(32), size);                  // sh_size
-        BinaryPrimitives.WriteUInt64LittleEndian(h.AsSpan(48), 8);                     // sh_addralign
-        return h;                                                                     // sh_name/link/info/entsize = 0
-    }
-
-    private static string ReadCString(byte[] b, int off)
-    {
-        int end = off;
-        while (end < b.Length && b[end] != 0)
-            end++;
-        return Encoding.ASCII.GetString(b, off, end - off);
-    }
-
     private static void Pad8(MemoryStream s)
     {
         while ((s.Position & 7) != 0)
             s.WriteByte(0);
     }
 
-    private static ulong RdU64(byte[] b, int o) => BinaryPrimitives.ReadUInt64LittleEndian(b.AsSpan(o));
-    private static uint RdU32(byte[] b, int o) => BinaryPrimitives.ReadUInt32LittleEndian(b.AsSpan(o));
-    private static ushort RdU16(byte[] b, int o) => BinaryPrimitives.ReadUInt16LittleEndian(b.AsSpan(o));
+    private static ulong RdU64(byte[] b, int o) => ElfFile.RdU64(b, o);
 }
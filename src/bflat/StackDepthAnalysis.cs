@@ -0,0 +1,443 @@
+// bflat C# compiler
+// Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Text;
+
+// Worst-case stack depth of a linked RISC-V64 zkVM guest.
+//
+// Every function symbol in the executable sections becomes a node. Its frame
+// is the deepest the stack pointer goes below its entry value in a linear
+// pass over the body: "addi sp, sp, -N", or "sub sp, sp, tX" once tX is a
+// known constant (lui/addi(w) pairs, as large prologues use). Direct calls
+// (jal ra, auipc+jalr ra) are edges that add the callee's depth on top of
+// the frame; tail calls (jal/jalr with rd = zero leaving the function)
+// replace it.
+//
+// Recursive cycles are the strongly connected components of the call graph.
+// Each is counted for one pass through its deepest member and listed, since
+// its real depth depends on input. Calls through a register (virtual and
+// interface dispatch, delegates, function pointers) have no static target,
+// so the figure is a bound over the direct call graph only; the report says
+// how many functions make such calls.
+internal static class StackDepthAnalysis
+{
+    private const int RegZero = 0, RegRa = 1, RegSp = 2;
+
+    private sealed class Function
+    {
+        public string Name;
+        public ulong Start;
+        public ulong End;
+        public long Frame;
+        public bool DynamicFrame;
+        public int IndirectCalls;
+        public readonly HashSet<int> Calls = new HashSet<int>();
+        public readonly HashSet<int> TailCalls = new HashSet<int>();
+        public int Component = -1;
+    }
+
+    private sealed class Component
+    {
+        public readonly List<int> Members = new List<int>();
+        public bool Recursive;
+        public long Depth;
+        public int Via = -1;         // member whose frame is counted
+        public int Next = -1;        // component the deepest path continues in
+    }
+
+    // "65536", "0x10000", "64K" and "4M" all parse; the result is rounded up
+    // to the 16-byte alignment the RISC-V ABI wants of sp.
+    public static bool TryParseStackSize(string value, out long bytes)
+    {
+        bytes = 0;
+        string digits = value.Trim();
+        long scale = 1;
+        if (digits.EndsWith("K", StringComparison.OrdinalIgnoreCase))
+            scale = 1024;
+        else if (digits.EndsWith("M", StringComparison.OrdinalIgnoreCase))
+            scale = 1024 * 1024;
+        if (scale != 1)
+            digits = digits.Substring(0, digits.Length - 1);
+
+        bool parsed = digits.StartsWith("0x", StringComparison.OrdinalIgnoreCase)
+            ? long.TryParse(digits.AsSpan(2), NumberStyles.HexNumber, CultureInfo.InvariantCulture, out long size)
+            : long.TryParse(digits, NumberStyles.None, CultureInfo.InvariantCulture, out size);
+        if (!parsed || size <= 0 || size > int.MaxValue / scale)
+            return false;
+
+        bytes = (size * scale + 15) & ~15L;
+        return true;
+    }
+
+    /// <summary>
+    /// Analyses <paramref name="elfPath"/> and writes the report to
+    /// <paramref name="reportPath"/>. Returns the depth of the deepest
+    /// non-recursive path in bytes. Throws if the file is not an ELF image
+    /// the scanner understands.
+    /// </summary>
+    public static long Write(string elfPath, string reportPath, long stackSize)
+    {
+        ElfFile elf = ElfFile.Read(elfPath);
+        List<Function> functions = ReadFunctions(elf);
+        for (int i = 0; i < functions.Count; i++)
+            Scan(elf, functions, i);
+
+        List<Component> components = FindComponents(functions);
+        foreach (Component component in components)
+            ComputeDepth(functions, components, component);
+
+        Component deepest = components.OrderByDescending(c => c.Depth).FirstOrDefault();
+        long depth = deepest?.Depth ?? 0;
+
+        var report = new StringBuilder();
+        report.AppendLine($"# Worst-case stack depth of {Path.GetFileName(elfPath)}");
+        report.AppendLine($"# {depth} bytes on the deepest path, stack size {stackSize}");
+        report.AppendLine($"# {functions.Count} functions, {functions.Sum(f => f.Calls.Count + f.TailCalls.Count)} direct call edges");
+        report.AppendLine($"# {functions.Count(f => f.IndirectCalls > 0)} functions call through a register; those callees are not counted");
+        report.AppendLine($"# {functions.Count(f => f.DynamicFrame)} functions size their frame at run time; only the constant part is counted");
+        report.AppendLine($"# {components.Count(c => c.Recursive)} recursive cycles, each counted for a single pass");
+        report.AppendLine();
+
+        report.AppendLine("deepest path (depth, frame, function):");
+        for (Component c = deepest; c != null; c = c.Next >= 0 ? components[c.Next] : null)
+        {
+            Function f = functions[c.Via];
+            string note = c.Recursive ? "  [recursive]" : f.DynamicFrame ? "  [dynamic frame]" : "";
+            report.AppendLine($"  {c.Depth,10} {f.Frame,8}  {f.Name}{note}");
+        }
+        report.AppendLine();
+
+        report.AppendLine("recursive cycles (depth of one pass, members):");
+        foreach (Component c in components.Where(c => c.Recursive).OrderByDescending(c => c.Depth))
+        {
+            IEnumerable<string> names = c.Members.Select(m => functions[m].Name).OrderBy(n => n, StringComparer.Ordinal);
+            report.AppendLine($"  {c.Depth,10}  {string.Join(" <-> ", names)}");
+        }
+        report.AppendLine();
+
+        report.AppendLine("largest frames (frame, function):");
+        foreach (Function f in functions.Where(f => f.Frame > 0).OrderByDescending(f => f.Frame).ThenBy(f => f.Name, StringComparer.Ordinal).Take(50))
+            report.AppendLine($"  {f.Frame,8}  {f.Name}{(f.DynamicFrame ? "  [dynamic frame]" : "")}");
+
+        File.WriteAllText(reportPath, report.ToString());
+        return depth;
+    }
+
+    // Function symbols (and global labels, which is what assembly entry
+    // points like _start are) in the executable sections, sorted by address.
+    // Symbols without a size run up to the next one.
+    private static List<Function> ReadFunctions(ElfFile elf)
+    {
+        var byAddress = new SortedDictionary<ulong, (string Name, ulong Size, ulong SectionEnd)>();
+        foreach (ElfFile.Section table in elf.Sections.Where(s => s.Type == ElfFile.ShtSymtab))
+        {
+            foreach (ElfFile.Symbol symbol in elf.ReadSymbols(table))
+            {
+                if (symbol.SectionIndex == 0 || symbol.SectionIndex >= elf.Sections.Count)
+                    continue;
+                if (symbol.Type != ElfFile.SttFunc && !(symbol.Type == ElfFile.SttNotype && symbol.Bind != ElfFile.StbLocal))
+                    continue;
+
+                ElfFile.Section section = elf.Sections[symbol.SectionIndex];
+                if ((section.Flags & ElfFile.ShfExecinstr) == 0)
+                    continue;
+
+                if (!byAddress.TryGetValue(symbol.Value, out var existing) || (existing.Size == 0 && symbol.Size != 0))
+                    byAddress[symbol.Value] = (symbol.Name, symbol.Size, section.Addr + section.Size);
+            }
+        }
+
+        var functions = new List<Function>();
+        var entries = byAddress.ToList();
+        for (int i = 0; i < entries.Count; i++)
+        {
+            ulong start = entries[i].Key;
+            ulong end = entries[i].Value.Size != 0
+                ? start + entries[i].Value.Size
+                : Math.Min(i + 1 < entries.Count ? entries[i + 1].Key : ulong.MaxValue, entries[i].Value.SectionEnd);
+            functions.Add(new Function { Name = entries[i].Value.Name, Start = start, End = end });
+        }
+        return functions;
+    }
+
+    private static void Scan(ElfFile file, List<Function> functions, int index)
+    {
+        Function f = functions[index];
+        byte[] elf = file.Image;
+        int fileStart = file.VaddrToFileOffset(f.Start);
+        if (fileStart < 0)
+            return;
+
+        var known = new bool[32];
+        var value = new long[32];
+        long depth = 0;
+
+        ulong pc = f.Start;
+        while (pc + 2 <= f.End)
+        {
+            int at = fileStart + (int)(pc - f.Start);
+            if (at + 2 > elf.Length)
+                break;
+
+            ushort half = RdU16(elf, at);
+            if ((half & 3) != 3)
+            {
+                ScanCompressed(half, f, ref depth);
+                pc += 2;
+                continue;
+            }
+            if (pc + 4 > f.End || at + 4 > elf.Length)
+                break;
+
+            uint w = RdU32(elf, at);
+            uint opcode = w & 0x7F;
+            int rd = (int)(w >> 7) & 31, rs1 = (int)(w >> 15) & 31, rs2 = (int)(w >> 20) & 31;
+            uint funct3 = (w >> 12) & 7, funct7 = w >> 25;
+            long immI = (int)w >> 20;
+            long immU = (int)(w & 0xFFFFF000);
+
+            switch (opcode)
+            {
+                case 0x13 when funct3 == 0:                     // addi
+                    if (rd == RegSp && rs1 == RegSp)
+                        depth -= immI;
+                    else
+                        Set(known, value, rd, rs1 == RegZero || known[rs1], (rs1 == RegZero ? 0 : value[rs1]) + immI);
+                    break;
+                case 0x1B when funct3 == 0:                     // addiw
+                    Set(known, value, rd, rs1 == RegZero || known[rs1], (int)((rs1 == RegZero ? 0 : value[rs1]) + immI));
+                    break;
+                case 0x37:                                      // lui
+                    Set(known, value, rd, true, immU);
+                    break;
+                case 0x17:                                      // auipc
+                    Set(known, value, rd, true, (long)pc + immU);
+                    break;
+                case 0x33 when funct3 == 0 && rd == RegSp && rs1 == RegSp:
+                    if (!known[rs2] || (funct7 != 0 && funct7 != 0x20))
+                        f.DynamicFrame = true;
+                    else
+                        depth += funct7 == 0x20 ? value[rs2] : -value[rs2];    // sub / add
+                    break;
+                case 0x6F:                                      // jal
+                {
+                    long imm = (((int)w >> 11) & unchecked((int)0xFFF00000)) | (int)(w & 0xFF000) | (int)((w >> 9) & 0x800) | (int)((w >> 20) & 0x7FE);
+                    AddEdge(functions, f, rd, (ulong)((long)pc + imm));
+                    Set(known, value, rd, false, 0);
+                    break;
+                }
+                case 0x67:                                      // jalr
+                    if (rd == RegZero && rs1 == RegRa)
+                        break;                                  // ret
+                    if (known[rs1])
+                        AddEdge(functions, f, rd, (ulong)(value[rs1] + immI));
+                    else if (rd != RegZero)
+                        f.IndirectCalls++;
+                    Set(known, value, rd, false, 0);
+                    break;
+                case 0x03: case 0x0F: case 0x13: case 0x1B: case 0x2F:
+                case 0x33: case 0x3B: case 0x73:
+                    Set(known, value, rd, false, 0);           // anything else with an rd
+                    break;
+            }
+
+            f.Frame = Math.Max(f.Frame, depth);
+            pc += 4;
+        }
+    }
+
+    // The zkVM targets have no C extension; runtime objects built for plain
+    // rv64gc can still carry it. Only the sp adjustment and calls matter.
+    private static void ScanCompressed(ushort h, Function f, ref long depth)
+    {
+        int quadrant = h & 3, funct3 = h >> 13;
+        int rd = (h >> 7) & 31;
+
+        if (quadrant == 1 && funct3 == 3 && rd == RegSp)            // c.addi16sp
+        {
+            int imm = ((h >> 3) & 0x200) | ((h >> 2) & 0x10) | ((h << 1) & 0x40) | ((h << 4) & 0x180) | ((h << 3) & 0x20);
+            depth -= (imm << 22) >> 22;
+        }
+        else if (quadrant == 1 && funct3 == 0 && rd == RegSp)       // c.addi sp
+        {
+            int imm = ((h >> 7) & 0x20) | ((h >> 2) & 0x1F);
+            depth -= (imm << 26) >> 26;
+        }
+        else if (quadrant == 2 && (h >> 12) == 0x9 && rd != 0 && ((h >> 2) & 31) == 0)
+        {
+            f.IndirectCalls++;                                      // c.jalr
+        }
+        f.Frame = Math.Max(f.Frame, depth);
+    }
+
+    private static void Set(bool[] known, long[] value, int rd, bool isKnown, long v)
+    {
+        if (rd == RegZero)
+            return;
+        known[rd] = isKnown;
+        value[rd] = v;
+    }
+
+    private static void AddEdge(List<Function> functions, Function from, int rd, ulong target)
+    {
+        if (rd != RegRa && rd != RegZero)
+            return;
+        if (target >= from.Start && target < from.End)
+            return;                                                 // a branch within the body
+
+        int callee = FindFunction(functions, target);
+        if (callee < 0)
+            return;
+        if (rd == RegRa)
+            from.Calls.Add(callee);
+        else
+            from.TailCalls.Add(callee);
+    }
+
+    private static int FindFunction(List<Function> functions, ulong address)
+    {
+        int lo = 0, hi = functions.Count - 1;
+        while (lo <= hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (address < functions[mid].Start)
+                hi = mid - 1;
+            else if (address >= functions[mid].End)
+                lo = mid + 1;
+            else
+                return mid;
+        }
+        return -1;
+    }
+
+    // Tarjan's algorithm without recursion: managed call chains are deeper
+    // than the host stack wants to follow. Components come out callees first.
+    private static List<Component> FindComponents(List<Function> functions)
+    {
+        var components = new List<Component>();
+        var order = new int[functions.Count];
+        var low = new int[functions.Count];
+        var onStack = new bool[functions.Count];
+        var stack = new Stack<int>();
+        var work = new Stack<(int Node, IEnumerator<int> Edges)>();
+        int counter = 0;
+
+        for (int root = 0; root < functions.Count; root++)
+        {
+            if (order[root] != 0)
+                continue;
+
+            order[root] = low[root] = ++counter;
+            stack.Push(root);
+            onStack[root] = true;
+            work.Push((root, Edges(functions[root]).GetEnumerator()));
+
+            while (work.Count > 0)
+            {
+                var (node, edges) = work.Peek();
+                if (edges.MoveNext())
+                {
+                    int next = edges.Current;
+                    if (order[next] == 0)
+                    {
+                        order[next] = low[next] = ++counter;
+                        stack.Push(next);
+                        onStack[next] = true;
+                        work.Push((next, Edges(functions[next]).GetEnumerator()));
+                    }
+                    else if (onStack[next])
+                    {
+                        low[node] = Math.Min(low[node], order[next]);
+                    }
+                    continue;
+                }
+
+                work.Pop();
+                if (work.Count > 0)
+                {
+                    int parent = work.Peek().Node;
+                    low[parent] = Math.Min(low[parent], low[node]);
+                }
+                if (low[node] != order[node])
+                    continue;
+
+                var component = new Component();
+                int member;
+                do
+                {
+                    member = stack.Pop();
+                    onStack[member] = false;
+                    functions[member].Component = components.Count;
+                    component.Members.Add(member);
+                } while (member != node);
+
+                Function single = functions[component.Members[0]];
+                component.Recursive = component.Members.Count > 1 ||
+                    single.Calls.Contains(component.Members[0]) || single.TailCalls.Contains(component.Members[0]);
+                components.Add(component);
+            }
+        }
+        return components;
+    }
+
+    private static IEnumerable<int> Edges(Function f) => f.Calls.Concat(f.TailCalls);
+
+    // Callee components are final by the time their callers get here. A call
+    // stacks the callee's depth on the frame; a tail call starts from the
+    // caller's entry depth.
+    private static void ComputeDepth(List<Function> functions, List<Component> components, Component component)
+    {
+        int self = functions[component.Members[0]].Component;
+        foreach (int m in component.Members)
+        {
+            Function f = functions[m];
+            long depth = f.Frame;
+            int next = -1;
+            foreach (int callee in f.Calls)
+            {
+                int c = functions[callee].Component;
+                if (c != self && f.Frame + components[c].Depth > depth)
+                {
+                    depth = f.Frame + components[c].Depth;
+                    next = c;
+                }
+            }
+            foreach (int callee in f.TailCalls)
+            {
+                int c = functions[callee].Component;
+                if (c != self && components[c].Depth > depth)
+                {
+                    depth = components[c].Depth;
+                    next = c;
+                }
+            }
+            if (component.Via < 0 || depth > component.Depth)
+            {
+                component.Depth = depth;
+                component.Via = m;
+                component.Next = next;
+            }
+        }
+    }
+
+    private static uint RdU32(byte[] b, int o) => ElfFile.RdU32(b, o);
+    private static ushort RdU16(byte[] b, int o) => ElfFile.RdU16(b, o);
+}
@@ -21,7 +21,8 @@ using System.Linq;
 using System.Text;
 
 /// <summary>
-/// Represents a single entry from an ELF symbol table.
+/// Represents a single entry from an ELF symbol table, with the fields
+/// spelled the way <c>readelf -sW</c> prints them.
 /// </summary>
 internal record ElfSymbol(
     int     Ordinal,
@@ -34,89 +35,6 @@ internal record ElfSymbol(
     string  Name
 );
 
-// ---------------------------------------------------------------------------
-// Parser
-// ---------------------------------------------------------------------------
-
-/// <summary>
-/// Parses the text output produced by <c>readelf -sW</c> (or <c>llvm-readelf -sW</c>).
-/// </summary>
-internal static class ElfSymbolParser
-{
-    /// <summary>
-    /// Parse the full stdout of <c>readelf -sW &lt;binary&gt;</c> and return all
-    /// symbol entries found across every symbol table section.
-    /// </summary>
-    public static List<ElfSymbol> Parse(string readelfOutput)
-    {
-        var symbols = new List<ElfSymbol>();
-        bool inTable = false;
-
-        foreach (var rawLine in readelfOutput.Split('\n'))
-        {
-            var line = rawLine.TrimEnd('\r');
-
-            // Detect the header row that precedes data rows:
-            //    Num:    Value          Size Type    Bind   Vis      Ndx Name
-            if (line.TrimStart().StartsWith("Num:", StringComparison.Ordinal)
-                && line.Contains("Value", StringComparison.Ordinal)
-                && line.Contains("Name", StringComparison.Ordinal))
-            {
-                inTable = true;
-                continue;
-            }
-
-            if (string.IsNullOrWhiteSpace(line))
-                continue;
-
-            if (line.TrimStart().StartsWith("Symbol table", StringComparison.OrdinalIgnoreCase))
-            {
-                inTable = false;
-                continue;
-            }
-
-            if (!inTable) continue;
-
-            // Data row format (space-separated, >= 7 tokens, name may be absent):
-            //   N: ADDR SIZE TYPE BIND VIS NDX [name...]
-            // where N ends with ':'
-            var parts = line.Split(new[] { ' ', '\t' }, StringSplitOptions.RemoveEmptyEntries);
-            if (parts.Length < 7) continue;
-
-            if (!parts[0].EndsWith(':')) continue;
-            if (!int.TryParse(parts[0].TrimEnd(':'), out int ordinal)) continue;
-
-            if (!ulong.TryParse(parts[1],
-                    System.Globalization.NumberStyles.HexNumber,
-                    System.Globalization.CultureInfo.InvariantCulture,
-                    out ulong address))
-                continue;
-
-            if (!ulong.TryParse(parts[2],
-                    System.Globalization.NumberStyles.None,
-                    System.Globalization.CultureInfo.InvariantCulture,
-                    out ulong size))
-                continue;
-
-            string type = parts[3];
-            string bind = parts[4];
-            string vis  = parts[5];
-            string ndx  = parts[6];
-            string name = parts.Length > 7
-                ? string.Join(" ", parts, 7, parts.Length - 7)
-                : string.Empty;
-
-            // Strip version suffix, e.g. "printf@GLIBC_2.5"
-            int atIdx = name.IndexOf('@');
-            if (atIdx > 0) name = name[..atIdx];
-
-            symbols.Add(new ElfSymbol(ordinal, address, size, type, bind, vis, ndx, name));
-        }
-
-        return symbols;
-    }
-}
-
 // ---------------------------------------------------------------------------
 // Generator  (HTML template lives in SymbolChartTemplate.cs)
 // ---------------------------------------------------------------------------
@@ -137,7 +55,7 @@ internal static partial class SymbolChartGenerator
     /// </summary>
     /// <param name="outputHtmlPath">Destination .html file.</param>
     /// <param name="binaryPath">Path to the analysed ELF binary (for display).</param>
-    /// <param name="allSymbols">Full list returned by <see cref="ElfSymbolParser.Parse"/>.</param>
+    /// <param name="allSymbols">Full list returned by <see cref="ElfSymbolReader.ReadBinary"/>.</param>
     /// <param name="defaultTopN">How many symbols to show by default.</param>
     public static void Generate(
         string                   outputHtmlPath,
@@ -1,61 +1,1206 @@
 /**
  * @file
- * @brief Floating point neglecting module
+ * @brief Integer-only IEEE-754 soft-float runtime
  *
  * Copyright (C) 2025 Demerzel Solutions Limited (Nethermind)
  *
  * @author Maxim Menshikov <maksim.menshikov@nethermind.io>
  */
-void __extenddftf2(void) { }
-void __addtf3(void) { }
-void __netf2(void) { }
-void __multf3(void) { }
-void __fixunstfsi(void) { }
-void __floatunsitf(void) { }
-void __subtf3(void) { }
-void __fixtfsi(void) { }
-void __floatsitf(void) { }
-void __eqtf2(void) { }
-void __divtf3(void) { }
-void __letf2(void) { }
-void __trunctfsf2(void) { }
-void __trunctfdf2(void) { }
-void __getf2(void) { }
-void __floatdidf(void) { }
-void __floatunsisf(void) { }
-void __ltdf2(void) { }
-void __gedf2(void) { }
-void __fixdfsi(void) { }
-void __gtdf2(void) { }
-void __floatsisf(void) { }
-void __floatsidf(void) { }
-void __floatunsidf(void) { }
-void __floatundisf(void) { }
-extern void __muldf3(void) { }
-extern void __mulsf3(void) { }
-extern void __floatundidf(void) { }
-
-void __divdf3(void) { }
-void __subdf3(void) { }
-void __adddf3(void) { }
-void __extendsftf2(void) { }
-void __extendsfdf2(void) { }
-void __eqdf2(void) { }
-void __fixunsdfsi(void) { }
-void __fixunsdfdi(void) { }
-void __divsf3(void) {}
-void __truncdfsf2(void) {}
-void __fixdfdi(void) {}
-void __gtsf2(void) {}
-void __fixunssfsi(void) {}
-void __addsf3(void) {}
-void __nedf2(void) {}
-void __floatdisf(void) {}
-void __fixsfsi(void) {}
-void __fixunssfdi(void) {}
-void __gesf2(void) {}
-void __ledf2(void) {}
-void __ltsf2(void) {}
-void __subsf3(void) {}
-void __eqsf2(void) {}
-void __lesf2(void) {}
+#include <inttypes.h>
+#include <stddef.h>
+
+/*
+ * The libgcc/compiler-rt soft-float helpers that musl and the runtime's C
+ * code call under the lp64 ABI: float (sf), double (df) and the 128-bit
+ * long double (tf). Everything is done on the bit patterns in integer
+ * registers, so only RV64IMA instructions are used whatever -march the
+ * module is built with. Results are IEEE-754 round-to-nearest-even; NaNs
+ * are quieted and propagated, exceptions are not raised.
+ *
+ * In the lp64 ABI a float or double argument arrives in an integer register
+ * exactly like an integer of the same size, and a long double like an
+ * unsigned __int128, so the helpers are declared with those types. The
+ * upper half of a register holding a float is unspecified, hence the
+ * uint64_t parameters truncated inside.
+ *
+ * Single-precision arithmetic runs in double precision and rounds once at
+ * the end: for +, -, * and / with 53 >= 2 * 24 + 2 bits this is exactly the
+ * correctly rounded float result.
+ */
+
+/* Profiling flavour (module.profile.o): every helper counts its calls;
+ * pal's zk_prof_dump() prints the non-zero counters at exit. */
+#ifndef ZKVM_PROFILE
+#define ZKVM_PROFILE 0
+#endif
+
+typedef unsigned __int128 u128;
+
+#define ZK_FP_HELPERS(X) \
+    X(addsf3) X(subsf3) X(mulsf3) X(divsf3) \
+    X(eqsf2) X(nesf2) X(ltsf2) X(lesf2) X(gtsf2) X(gesf2) X(unordsf2) \
+    X(floatsisf) X(floatunsisf) X(floatdisf) X(floatundisf) \
+    X(fixsfsi) X(fixunssfsi) X(fixsfdi) X(fixunssfdi) \
+    X(adddf3) X(subdf3) X(muldf3) X(divdf3) \
+    X(eqdf2) X(nedf2) X(ltdf2) X(ledf2) X(gtdf2) X(gedf2) X(unorddf2) \
+    X(floatsidf) X(floatunsidf) X(floatdidf) X(floatundidf) \
+    X(fixdfsi) X(fixunsdfsi) X(fixdfdi) X(fixunsdfdi) \
+    X(extendsfdf2) X(truncdfsf2) \
+    X(addtf3) X(subtf3) X(multf3) X(divtf3) \
+    X(eqtf2) X(netf2) X(lttf2) X(letf2) X(gttf2) X(getf2) X(unordtf2) \
+    X(floatsitf) X(floatunsitf) X(fixtfsi) X(fixunstfsi) \
+    X(extendsftf2) X(extenddftf2) X(trunctfsf2) X(trunctfdf2)
+
+#if ZKVM_PROFILE
+enum
+{
+#define ZK_FP_ID(name) ZK_FP_##name,
+    ZK_FP_HELPERS(ZK_FP_ID)
+#undef ZK_FP_ID
+    ZK_FP_HELPER_COUNT
+};
+
+/* Read by pal's zk_prof_dump() at exit. */
+#define ZK_FP_NAME(name) #name,
+const char *const zk_prof_fp_names[] = { ZK_FP_HELPERS(ZK_FP_NAME) };
+#undef ZK_FP_NAME
+uint64_t       zk_prof_fp_calls[ZK_FP_HELPER_COUNT];
+const uint32_t zk_prof_fp_helpers = ZK_FP_HELPER_COUNT;
+
+#define ZK_FP_CALL(name) (zk_prof_fp_calls[ZK_FP_##name]++)
+#else
+#define ZK_FP_CALL(name) ((void)0)
+#endif
+
+#define SF_SIGN     0x80000000u
+#define SF_INF      0x7F800000u
+#define SF_QUIET    0x00400000u
+
+#define DF_SIGN     0x8000000000000000ull
+#define DF_INF      0x7FF0000000000000ull
+#define DF_QNAN     0x7FF8000000000000ull
+#define DF_QUIET    0x0008000000000000ull
+#define DF_IMPLICIT 0x0010000000000000ull
+#define DF_FRAC     (DF_IMPLICIT - 1)
+#define DF_BIAS     1023
+
+#define TF_SIGN     ((u128)1 << 127)
+#define TF_INF      ((u128)0x7FFF << 112)
+#define TF_QNAN     ((u128)0xFFFF << 111)
+#define TF_QUIET    ((u128)1 << 111)
+#define TF_IMPLICIT ((u128)1 << 112)
+#define TF_FRAC     (TF_IMPLICIT - 1)
+#define TF_BIAS     16383
+
+static inline int
+clz128(u128 x)
+{
+    uint64_t hi = (uint64_t)(x >> 64);
+
+    return hi != 0 ? __builtin_clzll(hi) : 64 + __builtin_clzll((uint64_t)x);
+}
+
+/* Shift right, folding every bit shifted out into bit 0. */
+static inline uint64_t
+shr_sticky64(uint64_t x, unsigned shift)
+{
+    if (shift == 0)
+        return x;
+    if (shift >= 64)
+        return x != 0;
+    return (x >> shift) | ((x << (64 - shift)) != 0);
+}
+
+static inline u128
+shr_sticky128(u128 x, unsigned shift)
+{
+    if (shift == 0)
+        return x;
+    if (shift >= 128)
+        return x != 0;
+    return (x >> shift) | ((x << (128 - shift)) != 0);
+}
+
+/*
+ * Rounds and packs a float or double. sig carries the implicit bit at
+ * fracBits + 3, two guard bits and a sticky bit below it; exp is biased and
+ * may be out of range either way.
+ */
+static inline uint64_t
+fp_round_pack(uint64_t sign, int exp, uint64_t sig, int fracBits, int maxExp)
+{
+    if (exp >= maxExp)
+        return sign | ((uint64_t)maxExp << fracBits);
+    if (exp <= 0)
+    {
+        sig = shr_sticky64(sig, 1 - exp);
+        exp = 0;
+    }
+
+    uint64_t result = sign | ((uint64_t)exp << fracBits) | ((sig >> 3) & ((1ull << fracBits) - 1));
+    unsigned round  = sig & 7;
+
+    /* A carry out of the fraction bumps the exponent, which is exactly
+     * right for subnormal -> normal and largest finite -> infinity. */
+    if (round > 4 || (round == 4 && (result & 1)))
+        result++;
+    return result;
+}
+
+static inline u128
+tf_round_pack(u128 sign, int exp, u128 sig)
+{
+    if (exp >= 0x7FFF)
+        return sign | TF_INF;
+    if (exp <= 0)
+    {
+        sig = shr_sticky128(sig, 1 - exp);
+        exp = 0;
+    }
+
+    u128     result = sign | ((u128)exp << 112) | ((sig >> 3) & TF_FRAC);
+    unsigned round  = (unsigned)sig & 7;
+
+    if (round > 4 || (round == 4 && (result & 1)))
+        result++;
+    return result;
+}
+
+/* Moves the leading bit of a subnormal fraction up to the implicit position
+ * and returns the matching biased exponent. */
+static inline int
+df_normalize(uint64_t *sig)
+{
+    int shift = __builtin_clzll(*sig) - 11;
+
+    *sig <<= shift;
+    return 1 - shift;
+}
+
+static inline int
+tf_normalize(u128 *sig)
+{
+    int shift = clz128(*sig) - 15;
+
+    *sig <<= shift;
+    return 1 - shift;
+}
+
+/* --- double ------------------------------------------------------------ */
+
+static uint64_t
+df_add(uint64_t a, uint64_t b)
+{
+    uint64_t aAbs = a & ~DF_SIGN;
+    uint64_t bAbs = b & ~DF_SIGN;
+
+    /* Zeros, infinities and NaNs, one unsigned compare per operand. */
+    if (aAbs - 1 >= DF_INF - 1 || bAbs - 1 >= DF_INF - 1)
+    {
+        if (aAbs > DF_INF)
+            return a | DF_QUIET;
+        if (bAbs > DF_INF)
+            return b | DF_QUIET;
+        if (aAbs == DF_INF)
+            return (a ^ b) == DF_SIGN ? DF_QNAN : a;
+        if (bAbs == DF_INF)
+            return b;
+        if (aAbs == 0)
+            return bAbs == 0 ? (a & b) : b;
+        if (bAbs == 0)
+            return a;
+    }
+
+    if (bAbs > aAbs)
+    {
+        uint64_t t = a;
+        a = b;
+        b = t;
+    }
+
+    int      aExp = (int)((a >> 52) & 0x7FF);
+    int      bExp = (int)((b >> 52) & 0x7FF);
+    uint64_t aSig = a & DF_FRAC;
+    uint64_t bSig = b & DF_FRAC;
+
+    if (aExp == 0)
+        aExp = df_normalize(&aSig);
+    if (bExp == 0)
+        bExp = df_normalize(&bSig);
+
+    aSig = (aSig | DF_IMPLICIT) << 3;
+    bSig = shr_sticky64((bSig | DF_IMPLICIT) << 3, (unsigned)(aExp - bExp));
+
+    if ((a ^ b) & DF_SIGN)
+    {
+        aSig -= bSig;
+        if (aSig == 0)
+            return 0;
+        if (aSig < DF_IMPLICIT << 3)
+        {
+            int shift = __builtin_clzll(aSig) - 8;
+            aSig <<= shift;
+            aExp -= shift;
+        }
+    }
+    else
+    {
+        aSig += bSig;
+        if (aSig & (DF_IMPLICIT << 4))
+        {
+            aSig = shr_sticky64(aSig, 1);
+            aExp++;
+        }
+    }
+    return fp_round_pack(a & DF_SIGN, aExp, aSig, 52, 0x7FF);
+}
+
+static uint64_t
+df_mul(uint64_t a, uint64_t b)
+{
+    uint64_t sign = (a ^ b) & DF_SIGN;
+    uint64_t aAbs = a & ~DF_SIGN;
+    uint64_t bAbs = b & ~DF_SIGN;
+
+    if (aAbs - 1 >= DF_INF - 1 || bAbs - 1 >= DF_INF - 1)
+    {
+        if (aAbs > DF_INF)
+            return a | DF_QUIET;
+        if (bAbs > DF_INF)
+            return b | DF_QUIET;
+        if (aAbs == DF_INF)
+            return bAbs != 0 ? sign | DF_INF : DF_QNAN;
+        if (bAbs == DF_INF)
+            return aAbs != 0 ? sign | DF_INF : DF_QNAN;
+        if (aAbs == 0 || bAbs == 0)
+            return sign;
+    }
+
+    int      aExp = (int)(aAbs >> 52);
+    int      bExp = (int)(bAbs >> 52);
+    uint64_t aSig = a & DF_FRAC;
+    uint64_t bSig = b & DF_FRAC;
+
+    if (aExp == 0)
+        aExp = df_normalize(&aSig);
+    if (bExp == 0)
+        bExp = df_normalize(&bSig);
+
+    /* 53 x 53 bits: one mul and one mulhu. The product lies in
+     * [2^104, 2^106); keep 56 bits of it plus sticky. */
+    u128     p     = (u128)(aSig | DF_IMPLICIT) * (bSig | DF_IMPLICIT);
+    int      exp   = aExp + bExp - DF_BIAS;
+    unsigned shift = 49;
+
+    if ((uint64_t)(p >> 64) >> 41)
+    {
+        shift++;
+        exp++;
+    }
+
+    uint64_t sig = (uint64_t)(p >> shift) | (((uint64_t)p & ((1ull << shift) - 1)) != 0);
+    return fp_round_pack(sign, exp, sig, 52, 0x7FF);
+}
+
+static uint64_t
+df_div(uint64_t a, uint64_t b)
+{
+    uint64_t sign = (a ^ b) & DF_SIGN;
+    uint64_t aAbs = a & ~DF_SIGN;
+    uint64_t bAbs = b & ~DF_SIGN;
+
+    if (aAbs - 1 >= DF_INF - 1 || bAbs - 1 >= DF_INF - 1)
+    {
+        if (aAbs > DF_INF)
+            return a | DF_QUIET;
+        if (bAbs > DF_INF)
+            return b | DF_QUIET;
+        if (aAbs == DF_INF)
+            return bAbs == DF_INF ? DF_QNAN : sign | DF_INF;
+        if (bAbs == DF_INF)
+            return sign;
+        if (aAbs == 0)
+            return bAbs == 0 ? DF_QNAN : sign;
+        if (bAbs == 0)
+            return sign | DF_INF;
+    }
+
+    int      aExp = (int)(aAbs >> 52);
+    int      bExp = (int)(bAbs >> 52);
+    uint64_t aSig = a & DF_FRAC;
+    uint64_t bSig = b & DF_FRAC;
+
+    if (aExp == 0)
+        aExp = df_normalize(&aSig);
+    if (bExp == 0)
+        bExp = df_normalize(&bSig);
+    aSig |= DF_IMPLICIT;
+    bSig |= DF_IMPLICIT;
+
+    /* Long division in 11-bit digits: the remainder stays below the 53-bit
+     * divisor, so each digit is one divu/remu pair on 64-bit values. */
+    int      exp  = aExp - bExp + DF_BIAS;
+    int      bits = 55;
+    uint64_t q    = aSig >= bSig;
+    uint64_t r    = aSig - (q ? bSig : 0);
+
+    if (q == 0)
+    {
+        bits++;
+        exp--;
+    }
+    while (bits > 0)
+    {
+        int step = bits < 11 ? bits : 11;
+
+        r <<= step;
+        q = (q << step) | (r / bSig);
+        r %= bSig;
+        bits -= step;
+    }
+    return fp_round_pack(sign, exp, q | (r != 0), 52, 0x7FF);
+}
+
+/*
+ * Ordered comparison: -1, 0 or 1, or `unordered` when either side is a NaN.
+ * Outside NaNs and signed zeros, IEEE order is the order of the bit patterns
+ * as sign-magnitude integers.
+ */
+static inline int
+df_cmp(uint64_t a, uint64_t b, int unordered)
+{
+    uint64_t aAbs = a & ~DF_SIGN;
+    uint64_t bAbs = b & ~DF_SIGN;
+
+    if (aAbs > DF_INF || bAbs > DF_INF)
+        return unordered;
+    if ((aAbs | bAbs) == 0 || a == b)
+        return 0;
+    if ((int64_t)(a & b) >= 0)
+        return (int64_t)a < (int64_t)b ? -1 : 1;
+    return (int64_t)a > (int64_t)b ? -1 : 1;
+}
+
+static inline int
+df_ne(uint64_t a, uint64_t b)
+{
+    uint64_t aAbs = a & ~DF_SIGN;
+    uint64_t bAbs = b & ~DF_SIGN;
+
+    if (aAbs > DF_INF || bAbs > DF_INF)
+        return 1;
+    return a != b && (aAbs | bAbs) != 0;
+}
+
+static inline uint64_t
+df_from_u64(uint64_t sign, uint64_t mag)
+{
+    if (mag == 0)
+        return sign;
+
+    int lz  = __builtin_clzll(mag);
+    int exp = DF_BIAS + 63 - lz;
+
+    /* Up to 53 significant bits convert exactly; every 32-bit input does. */
+    if (lz >= 11)
+        return sign | ((uint64_t)exp << 52) | ((mag << (lz - 11)) & DF_FRAC);
+    return fp_round_pack(sign, exp, shr_sticky64(mag << lz, 8), 52, 0x7FF);
+}
+
+/* Truncating conversion; out-of-range values and NaNs saturate like
+ * RISC-V's fcvt. */
+static inline int64_t
+df_to_int(uint64_t a, int bits)
+{
+    int      exp = (int)((a >> 52) & 0x7FF) - DF_BIAS;
+    uint64_t sig = (a & DF_FRAC) | DF_IMPLICIT;
+    int      neg = (int64_t)a < 0;
+
+    if (exp < 0)
+        return 0;
+    if (exp >= bits - 1)
+    {
+        uint64_t max = (1ull << (bits - 1)) - 1;
+        return (int64_t)(neg ? ~max : max);
+    }
+
+    uint64_t mag = exp < 52 ? sig >> (52 - exp) : sig << (exp - 52);
+    return neg ? -(int64_t)mag : (int64_t)mag;
+}
+
+static inline uint64_t
+df_to_uint(uint64_t a, int bits)
+{
+    int      exp = (int)((a >> 52) & 0x7FF) - DF_BIAS;
+    uint64_t sig = (a & DF_FRAC) | DF_IMPLICIT;
+
+    if ((int64_t)a < 0 || exp < 0)
+        return 0;
+    if (exp >= bits)
+        return bits == 64 ? ~0ull : (1ull << bits) - 1;
+    return exp < 52 ? sig >> (52 - exp) : sig << (exp - 52);
+}
+
+/* --- float ------------------------------------------------------------- */
+
+static inline uint64_t
+sf_to_df(uint32_t a)
+{
+    uint64_t sign = (uint64_t)(a & SF_SIGN) << 32;
+    uint32_t abs  = a & ~SF_SIGN;
+
+    /* Normal numbers just move the fraction and rebias the exponent. */
+    if (abs - 0x00800000u < 0x7F000000u)
+        return sign | (((uint64_t)abs << 29) + ((uint64_t)(DF_BIAS - 127) << 52));
+    if (abs >= SF_INF)
+        return sign | DF_INF | ((uint64_t)(abs & 0x007FFFFFu) << 29) | (abs > SF_INF ? DF_QUIET : 0);
+    if (abs == 0)
+        return sign;
+
+    int shift = __builtin_clz(abs) - 8;
+    return sign | ((uint64_t)(DF_BIAS - 126 - shift) << 52) | ((uint64_t)((abs << shift) & 0x007FFFFFu) << 29);
+}
+
+static inline uint32_t
+df_to_sf(uint64_t a)
+{
+    uint64_t sign = (a & DF_SIGN) >> 32;
+    uint64_t abs  = a & ~DF_SIGN;
+    int      exp  = (int)(abs >> 52);
+
+    if (exp == 0x7FF)
+        return (uint32_t)(sign | SF_INF | ((abs & DF_FRAC) != 0 ? SF_QUIET | ((abs & DF_FRAC) >> 29) : 0));
+    /* Double subnormals are far below half the smallest float. */
+    if (exp == 0)
+        return (uint32_t)sign;
+
+    uint64_t sig = shr_sticky64((abs & DF_FRAC) | DF_IMPLICIT, 26);
+    return (uint32_t)fp_round_pack(sign, exp - DF_BIAS + 127, sig, 23, 0xFF);
+}
+
+static inline uint32_t
+sf_from_u64(uint64_t sign, uint64_t mag)
+{
+    if (mag == 0)
+        return (uint32_t)sign;
+
+    int lz = __builtin_clzll(mag);
+    return (uint32_t)fp_round_pack(sign, 127 + 63 - lz, shr_sticky64(mag << lz, 37), 23, 0xFF);
+}
+
+static inline int
+sf_cmp(uint32_t a, uint32_t b, int unordered)
+{
+    uint32_t aAbs = a & ~SF_SIGN;
+    uint32_t bAbs = b & ~SF_SIGN;
+
+    if (aAbs > SF_INF || bAbs > SF_INF)
+        return unordered;
+    if ((aAbs | bAbs) == 0 || a == b)
+        return 0;
+    if ((int32_t)(a & b) >= 0)
+        return (int32_t)a < (int32_t)b ? -1 : 1;
+    return (int32_t)a > (int32_t)b ? -1 : 1;
+}
+
+/* --- long double ------------------------------------------------------- */
+
+static u128
+tf_add(u128 a, u128 b)
+{
+    u128 aAbs = a & ~TF_SIGN;
+    u128 bAbs = b & ~TF_SIGN;
+
+    if (aAbs - 1 >= TF_INF - 1 || bAbs - 1 >= TF_INF - 1)
+    {
+        if (aAbs > TF_INF)
+            return a | TF_QUIET;
+        if (bAbs > TF_INF)
+            return b | TF_QUIET;
+        if (aAbs == TF_INF)
+            return (a ^ b) == TF_SIGN ? TF_QNAN : a;
+        if (bAbs == TF_INF)
+            return b;
+        if (aAbs == 0)
+            return bAbs == 0 ? (a & b) : b;
+        if (bAbs == 0)
+            return a;
+    }
+
+    if (bAbs > aAbs)
+    {
+        u128 t = a;
+        a = b;
+        b = t;
+    }
+
+    int  aExp = (int)((a >> 112) & 0x7FFF);
+    int  bExp = (int)((b >> 112) & 0x7FFF);
+    u128 aSig = a & TF_FRAC;
+    u128 bSig = b & TF_FRAC;
+
+    if (aExp == 0)
+        aExp = tf_normalize(&aSig);
+    if (bExp == 0)
+        bExp = tf_normalize(&bSig);
+
+    aSig = (aSig | TF_IMPLICIT) << 3;
+    bSig = shr_sticky128((bSig | TF_IMPLICIT) << 3, (unsigned)(aExp - bExp));
+
+    if ((a ^ b) & TF_SIGN)
+    {
+        aSig -= bSig;
+        if (aSig == 0)
+            return 0;
+        if (aSig < TF_IMPLICIT << 3)
+        {
+            int shift = clz128(aSig) - 12;
+            aSig <<= shift;
+            aExp -= shift;
+        }
+    }
+    else
+    {
+        aSig += bSig;
+        if (aSig & (TF_IMPLICIT << 4))
+        {
+            aSig = shr_sticky128(aSig, 1);
+            aExp++;
+        }
+    }
+    return tf_round_pack(a & TF_SIGN, aExp, aSig);
+}
+
+static u128
+tf_mul(u128 a, u128 b)
+{
+    u128 sign = (a ^ b) & TF_SIGN;
+    u128 aAbs = a & ~TF_SIGN;
+    u128 bAbs = b & ~TF_SIGN;
+
+    if (aAbs - 1 >= TF_INF - 1 || bAbs - 1 >= TF_INF - 1)
+    {
+        if (aAbs > TF_INF)
+            return a | TF_QUIET;
+        if (bAbs > TF_INF)
+            return b | TF_QUIET;
+        if (aAbs == TF_INF)
+            return bAbs != 0 ? sign | TF_INF : TF_QNAN;
+        if (bAbs == TF_INF)
+            return aAbs != 0 ? sign | TF_INF : TF_QNAN;
+        if (aAbs == 0 || bAbs == 0)
+            return sign;
+    }
+
+    int  aExp = (int)(aAbs >> 112);
+    int  bExp = (int)(bAbs >> 112);
+    u128 aSig = a & TF_FRAC;
+    u128 bSig = b & TF_FRAC;
+
+    if (aExp == 0)
+        aExp = tf_normalize(&aSig);
+    if (bExp == 0)
+        bExp = tf_normalize(&bSig);
+    aSig |= TF_IMPLICIT;
+    bSig |= TF_IMPLICIT;
+
+    /* 113 x 113 bits from four 64 x 64 partial products; the result lies
+     * in [2^224, 2^226). */
+    uint64_t al = (uint64_t)aSig, ah = (uint64_t)(aSig >> 64);
+    uint64_t bl = (uint64_t)bSig, bh = (uint64_t)(bSig >> 64);
+    u128     ll  = (u128)al * bl;
+    u128     lh  = (u128)al * bh;
+    u128     hl  = (u128)ah * bl;
+    u128     mid = (ll >> 64) + (uint64_t)lh + (uint64_t)hl;
+    u128     lo  = (mid << 64) | (uint64_t)ll;
+    u128     hi  = (u128)ah * bh + (lh >> 64) + (hl >> 64) + (mid >> 64);
+
+    int      exp   = aExp + bExp - TF_BIAS;
+    unsigned shift = 109;
+
+    if (hi >> 97)
+    {
+        shift++;
+        exp++;
+    }
+
+    u128 sig = (hi << (128 - shift)) | (lo >> shift) | ((lo << (128 - shift)) != 0);
+    return tf_round_pack(sign, exp, sig);
+}
+
+static u128
+tf_div(u128 a, u128 b)
+{
+    u128 sign = (a ^ b) & TF_SIGN;
+    u128 aAbs = a & ~TF_SIGN;
+    u128 bAbs = b & ~TF_SIGN;
+
+    if (aAbs - 1 >= TF_INF - 1 || bAbs - 1 >= TF_INF - 1)
+    {
+        if (aAbs > TF_INF)
+            return a | TF_QUIET;
+        if (bAbs > TF_INF)
+            return b | TF_QUIET;
+        if (aAbs == TF_INF)
+            return bAbs == TF_INF ? TF_QNAN : sign | TF_INF;
+        if (bAbs == TF_INF)
+            return sign;
+        if (aAbs == 0)
+            return bAbs == 0 ? TF_QNAN : sign;
+        if (bAbs == 0)
+            return sign | TF_INF;
+    }
+
+    int  aExp = (int)(aAbs >> 112);
+    int  bExp = (int)(bAbs >> 112);
+    u128 aSig = a & TF_FRAC;
+    u128 bSig = b & TF_FRAC;
+
+    if (aExp == 0)
+        aExp = tf_normalize(&aSig);
+    if (bExp == 0)
+        bExp = tf_normalize(&bSig);
+    aSig |= TF_IMPLICIT;
+    bSig |= TF_IMPLICIT;
+
+    /* The 113-bit divisor does not fit divu, so this is plain restoring
+     * division, one quotient bit per step. */
+    int  exp  = aExp - bExp + TF_BIAS;
+    int  bits = 115;
+    u128 q    = aSig >= bSig;
+    u128 r    = aSig - (q ? bSig : 0);
+
+    if (q == 0)
+    {
+        bits++;
+        exp--;
+    }
+    while (bits-- > 0)
+    {
+        r <<= 1;
+        q <<= 1;
+        if (r >= bSig)
+        {
+            r -= bSig;
+            q |= 1;
+        }
+    }
+    return tf_round_pack(sign, exp, q | (r != 0));
+}
+
+static inline int
+tf_cmp(u128 a, u128 b, int unordered)
+{
+    u128 aAbs = a & ~TF_SIGN;
+    u128 bAbs = b & ~TF_SIGN;
+
+    if (aAbs > TF_INF || bAbs > TF_INF)
+        return unordered;
+    if ((aAbs | bAbs) == 0 || a == b)
+        return 0;
+    if ((__int128)(a & b) >= 0)
+        return (__int128)a < (__int128)b ? -1 : 1;
+    return (__int128)a > (__int128)b ? -1 : 1;
+}
+
+static inline u128
+df_to_tf(uint64_t a)
+{
+    u128     sign = (u128)(a >> 63) << 127;
+    uint64_t frac = a & DF_FRAC;
+    int      exp  = (int)((a >> 52) & 0x7FF);
+
+    if (exp == 0x7FF)
+        return sign | TF_INF | ((u128)frac << 60) | (frac != 0 ? TF_QUIET : 0);
+    if (exp == 0)
+    {
+        if (frac == 0)
+            return sign;
+        exp = df_normalize(&frac);
+        frac &= DF_FRAC;
+    }
+    return sign | ((u128)(exp - DF_BIAS + TF_BIAS) << 112) | ((u128)frac << 60);
+}
+
+/* Narrows to a float (fracBits 23, expBits 8) or a double (52, 11) with a
+ * single rounding. */
+static inline uint64_t
+tf_trunc(u128 a, int fracBits, int expBits)
+{
+    int      maxExp = (1 << expBits) - 1;
+    uint64_t sign   = (uint64_t)(a >> 127) << (fracBits + expBits);
+    u128     frac   = a & TF_FRAC;
+    int      exp    = (int)((a >> 112) & 0x7FFF);
+
+    if (exp == 0x7FFF)
+        return sign | ((uint64_t)maxExp << fracBits)
+               | (frac != 0 ? (1ull << (fracBits - 1)) | (uint64_t)(frac >> (112 - fracBits)) : 0);
+    /* Quad subnormals are far below half the smallest double. */
+    if (exp == 0)
+        return sign;
+
+    unsigned shift = 112 - (fracBits + 3);
+    u128     sig   = shr_sticky128(frac | TF_IMPLICIT, shift);
+    return fp_round_pack(sign, exp - TF_BIAS + (maxExp >> 1), (uint64_t)sig, fracBits, maxExp);
+}
+
+static inline u128
+tf_from_u32(u128 sign, uint32_t mag)
+{
+    if (mag == 0)
+        return sign;
+
+    int lz = __builtin_clz(mag);
+    return sign | ((u128)(TF_BIAS + 31 - lz) << 112) | (((u128)mag << (81 + lz)) & TF_FRAC);
+}
+
+static inline int64_t
+tf_to_int(u128 a, int bits)
+{
+    int  exp = (int)((a >> 112) & 0x7FFF) - TF_BIAS;
+    u128 sig = (a & TF_FRAC) | TF_IMPLICIT;
+    int  neg = (__int128)a < 0;
+
+    if (exp < 0)
+        return 0;
+    if (exp >= bits - 1)
+    {
+        uint64_t max = (1ull << (bits - 1)) - 1;
+        return (int64_t)(neg ? ~max : max);
+    }
+
+    uint64_t mag = (uint64_t)(sig >> (112 - exp));
+    return neg ? -(int64_t)mag : (int64_t)mag;
+}
+
+static inline uint64_t
+tf_to_uint(u128 a, int bits)
+{
+    int  exp = (int)((a >> 112) & 0x7FFF) - TF_BIAS;
+    u128 sig = (a & TF_FRAC) | TF_IMPLICIT;
+
+    if ((__int128)a < 0 || exp < 0)
+        return 0;
+    if (exp >= bits)
+        return bits == 64 ? ~0ull : (1ull << bits) - 1;
+    return (uint64_t)(sig >> (112 - exp));
+}
+
+/* --- float helpers ----------------------------------------------------- */
+
+uint64_t
+__addsf3(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(addsf3);
+    return df_to_sf(df_add(sf_to_df((uint32_t)a), sf_to_df((uint32_t)b)));
+}
+
+uint64_t
+__subsf3(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(subsf3);
+    return df_to_sf(df_add(sf_to_df((uint32_t)a), sf_to_df((uint32_t)b ^ SF_SIGN)));
+}
+
+uint64_t
+__mulsf3(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(mulsf3);
+    return df_to_sf(df_mul(sf_to_df((uint32_t)a), sf_to_df((uint32_t)b)));
+}
+
+uint64_t
+__divsf3(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(divsf3);
+    return df_to_sf(df_div(sf_to_df((uint32_t)a), sf_to_df((uint32_t)b)));
+}
+
+int
+__eqsf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(eqsf2);
+    return sf_cmp((uint32_t)a, (uint32_t)b, 1) != 0;
+}
+
+int
+__nesf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(nesf2);
+    return sf_cmp((uint32_t)a, (uint32_t)b, 1) != 0;
+}
+
+int
+__ltsf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(ltsf2);
+    return sf_cmp((uint32_t)a, (uint32_t)b, 1);
+}
+
+int
+__lesf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(lesf2);
+    return sf_cmp((uint32_t)a, (uint32_t)b, 1);
+}
+
+int
+__gtsf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(gtsf2);
+    return sf_cmp((uint32_t)a, (uint32_t)b, -1);
+}
+
+int
+__gesf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(gesf2);
+    return sf_cmp((uint32_t)a, (uint32_t)b, -1);
+}
+
+int
+__unordsf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(unordsf2);
+    return ((uint32_t)a & ~SF_SIGN) > SF_INF || ((uint32_t)b & ~SF_SIGN) > SF_INF;
+}
+
+uint64_t
+__floatsisf(int a)
+{
+    ZK_FP_CALL(floatsisf);
+    return sf_from_u64(a < 0 ? SF_SIGN : 0, a < 0 ? -(uint64_t)a : (uint64_t)a);
+}
+
+uint64_t
+__floatunsisf(unsigned int a)
+{
+    ZK_FP_CALL(floatunsisf);
+    return sf_from_u64(0, a);
+}
+
+uint64_t
+__floatdisf(int64_t a)
+{
+    ZK_FP_CALL(floatdisf);
+    return sf_from_u64(a < 0 ? SF_SIGN : 0, a < 0 ? -(uint64_t)a : (uint64_t)a);
+}
+
+uint64_t
+__floatundisf(uint64_t a)
+{
+    ZK_FP_CALL(floatundisf);
+    return sf_from_u64(0, a);
+}
+
+int
+__fixsfsi(uint64_t a)
+{
+    ZK_FP_CALL(fixsfsi);
+    return (int)df_to_int(sf_to_df((uint32_t)a), 32);
+}
+
+unsigned int
+__fixunssfsi(uint64_t a)
+{
+    ZK_FP_CALL(fixunssfsi);
+    return (unsigned int)df_to_uint(sf_to_df((uint32_t)a), 32);
+}
+
+int64_t
+__fixsfdi(uint64_t a)
+{
+    ZK_FP_CALL(fixsfdi);
+    return df_to_int(sf_to_df((uint32_t)a), 64);
+}
+
+uint64_t
+__fixunssfdi(uint64_t a)
+{
+    ZK_FP_CALL(fixunssfdi);
+    return df_to_uint(sf_to_df((uint32_t)a), 64);
+}
+
+/* --- double helpers ---------------------------------------------------- */
+
+uint64_t
+__adddf3(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(adddf3);
+    return df_add(a, b);
+}
+
+uint64_t
+__subdf3(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(subdf3);
+    return df_add(a, b ^ DF_SIGN);
+}
+
+uint64_t
+__muldf3(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(muldf3);
+    return df_mul(a, b);
+}
+
+uint64_t
+__divdf3(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(divdf3);
+    return df_div(a, b);
+}
+
+int
+__eqdf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(eqdf2);
+    return df_ne(a, b);
+}
+
+int
+__nedf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(nedf2);
+    return df_ne(a, b);
+}
+
+int
+__ltdf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(ltdf2);
+    return df_cmp(a, b, 1);
+}
+
+int
+__ledf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(ledf2);
+    return df_cmp(a, b, 1);
+}
+
+int
+__gtdf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(gtdf2);
+    return df_cmp(a, b, -1);
+}
+
+int
+__gedf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(gedf2);
+    return df_cmp(a, b, -1);
+}
+
+int
+__unorddf2(uint64_t a, uint64_t b)
+{
+    ZK_FP_CALL(unorddf2);
+    return (a & ~DF_SIGN) > DF_INF || (b & ~DF_SIGN) > DF_INF;
+}
+
+uint64_t
+__floatsidf(int a)
+{
+    ZK_FP_CALL(floatsidf);
+    return df_from_u64(a < 0 ? DF_SIGN : 0, a < 0 ? -(uint64_t)a : (uint64_t)a);
+}
+
+uint64_t
+__floatunsidf(unsigned int a)
+{
+    ZK_FP_CALL(floatunsidf);
+    return df_from_u64(0, a);
+}
+
+uint64_t
+__floatdidf(int64_t a)
+{
+    ZK_FP_CALL(floatdidf);
+    return df_from_u64(a < 0 ? DF_SIGN : 0, a < 0 ? -(uint64_t)a : (uint64_t)a);
+}
+
+uint64_t
+__floatundidf(uint64_t a)
+{
+    ZK_FP_CALL(floatundidf);
+    return df_from_u64(0, a);
+}
+
+int
+__fixdfsi(uint64_t a)
+{
+    ZK_FP_CALL(fixdfsi);
+    return (int)df_to_int(a, 32);
+}
+
+unsigned int
+__fixunsdfsi(uint64_t a)
+{
+    ZK_FP_CALL(fixunsdfsi);
+    return (unsigned int)df_to_uint(a, 32);
+}
+
+int64_t
+__fixdfdi(uint64_t a)
+{
+    ZK_FP_CALL(fixdfdi);
+    return df_to_int(a, 64);
+}
+
+uint64_t
+__fixunsdfdi(uint64_t a)
+{
+    ZK_FP_CALL(fixunsdfdi);
+    return df_to_uint(a, 64);
+}
+
+uint64_t
+__extendsfdf2(uint64_t a)
+{
+    ZK_FP_CALL(extendsfdf2);
+    return sf_to_df((uint32_t)a);
+}
+
+uint64_t
+__truncdfsf2(uint64_t a)
+{
+    ZK_FP_CALL(truncdfsf2);
+    return df_to_sf(a);
+}
+
+/* --- long double helpers ----------------------------------------------- */
+
+u128
+__addtf3(u128 a, u128 b)
+{
+    ZK_FP_CALL(addtf3);
+    return tf_add(a, b);
+}
+
+u128
+__subtf3(u128 a, u128 b)
+{
+    ZK_FP_CALL(subtf3);
+    return tf_add(a, b ^ TF_SIGN);
+}
+
+u128
+__multf3(u128 a, u128 b)
+{
+    ZK_FP_CALL(multf3);
+    return tf_mul(a, b);
+}
+
+u128
+__divtf3(u128 a, u128 b)
+{
+    ZK_FP_CALL(divtf3);
+    return tf_div(a, b);
+}
+
+int
+__eqtf2(u128 a, u128 b)
+{
+    ZK_FP_CALL(eqtf2);
+    return tf_cmp(a, b, 1) != 0;
+}
+
+int
+__netf2(u128 a, u128 b)
+{
+    ZK_FP_CALL(netf2);
+    return tf_cmp(a, b, 1) != 0;
+}
+
+int
+__lttf2(u128 a, u128 b)
+{
+    ZK_FP_CALL(lttf2);
+    return tf_cmp(a, b, 1);
+}
+
+int
+__letf2(u128 a, u128 b)
+{
+    ZK_FP_CALL(letf2);
+    return tf_cmp(a, b, 1);
+}
+
+int
+__gttf2(u128 a, u128 b)
+{
+    ZK_FP_CALL(gttf2);
+    return tf_cmp(a, b, -1);
+}
+
+int
+__getf2(u128 a, u128 b)
+{
+    ZK_FP_CALL(getf2);
+    return tf_cmp(a, b, -1);
+}
+
+int
+__unordtf2(u128 a, u128 b)
+{
+    ZK_FP_CALL(unordtf2);
+    return (a & ~TF_SIGN) > TF_INF || (b & ~TF_SIGN) > TF_INF;
+}
+
+u128
+__floatsitf(int a)
+{
+    ZK_FP_CALL(floatsitf);
+    return tf_from_u32(a < 0 ? TF_SIGN : 0, a < 0 ? -(uint32_t)a : (uint32_t)a);
+}
+
+u128
+__floatunsitf(unsigned int a)
+{
+    ZK_FP_CALL(floatunsitf);
+    return tf_from_u32(0, a);
+}
+
+int
+__fixtfsi(u128 a)
+{
+    ZK_FP_CALL(fixtfsi);
+    return (int)tf_to_int(a, 32);
+}
+
+unsigned int
+__fixunstfsi(u128 a)
+{
+    ZK_FP_CALL(fixunstfsi);
+    return (unsigned int)tf_to_uint(a, 32);
+}
+
+u128
+__extendsftf2(uint64_t a)
+{
+    ZK_FP_CALL(extendsftf2);
+    return df_to_tf(sf_to_df((uint32_t)a));
+}
+
+u128
+__extenddftf2(uint64_t a)
+{
+    ZK_FP_CALL(extenddftf2);
+    return df_to_tf(a);
+}
+
+uint64_t
+__trunctfsf2(u128 a)
+{
+    ZK_FP_CALL(trunctfsf2);
+    return tf_trunc(a, 23, 8);
+}
+
+uint64_t
+__trunctfdf2(u128 a)
+{
+    ZK_FP_CALL(trunctfdf2);
+    return tf_trunc(a, 52, 11);
+}
@@ -14,6 +14,31 @@
 
 #define _DEBUG (0)
 
+/* Set for the zisk_sim flavour of this module (module.sim.o, see
+ * module_params.yml): code that only makes sense under a real Linux kernel -
+ * debugging aids, host syscalls - is compiled in only there. */
+#ifndef ZKVM_SIM
+#define ZKVM_SIM 0
+#endif
+
+/* Set for the allocation-profiling flavour (module.profile.o, zisk_sim only,
+ * selected by `bflat build --zkvm-alloc-profile`): managed allocations are
+ * counted per MethodTable and per call site and reported at exit. */
+#ifndef ZKVM_PROFILE
+#define ZKVM_PROFILE 0
+#endif
+
+#if ZKVM_PROFILE && !ZKVM_SIM
+#error "ZKVM_PROFILE reports through the host kernel and needs ZKVM_SIM"
+#endif
+
+/* Set for the collecting flavour (module.gc.o / module.sim_gc.o, selected by
+ * `bflat build --zkvm-gc`): GC.Collect() runs the mark-sweep collector below
+ * and all native memory moves to the upward region. */
+#ifndef ZKVM_GC
+#define ZKVM_GC 0
+#endif
+
 /* zkVM RAM is zero-initialised and the downward bump allocator never reuses
  * memory, so a freshly handed-out block is already all-zero — the per-object
  * memset is redundant.
@@ -22,6 +47,40 @@
 #define ZKVM_FAST_ALLOC 1
 #endif
 
+/* Opt-in recycling of blocks handed back through free()/realloc(). Off by
+ * default: most proof workloads are short enough that pure bump allocation
+ * wins, but long-running guests that churn native buffers (musl stdio,
+ * runtime tables, realloc growth) can bound their footprint with it. See the
+ * size-class free lists below.
+ */
+#ifndef ZKVM_FREELIST_ALLOC
+#define ZKVM_FREELIST_ALLOC 0
+#endif
+
+/* Managed objects carry no 8-byte size header: the header only serves
+ * realloc(), and uGC never frees or walks managed objects. Set to 0 to put
+ * objects back on the headered malloc path. See zk_alloc_object().
+ */
+#ifndef ZKVM_HEADERLESS_OBJECTS
+#define ZKVM_HEADERLESS_OBJECTS 1
+#endif
+
+/* Dual-ended heap: large blocks and realloc() targets grow upward from
+ * _kernel_heap_bottom so the most recent one can be resized in place, while
+ * small objects stay dense at the top. See the upward region below.
+ */
+#ifndef ZKVM_DUAL_HEAP
+#define ZKVM_DUAL_HEAP 1
+#endif
+
+#ifndef ZKVM_UPWARD_THRESHOLD
+#define ZKVM_UPWARD_THRESHOLD 4096u
+#endif
+
+#if ZKVM_GC && !(ZKVM_DUAL_HEAP && ZKVM_FAST_ALLOC && ZKVM_HEADERLESS_OBJECTS)
+#error "ZKVM_GC needs the dual-ended heap with fast header-less objects"
+#endif
+
 extern const char _kernel_heap_bottom[];
 extern const char _kernel_heap_top[];
 
@@ -103,39 +162,1021 @@ align_down_8_uintptr(uintptr_t x)
     return x & ~(uintptr_t)7;
 }
 
-extern uint32_t rhp_tss_counter;
+#if ZKVM_DUAL_HEAP
+/*
+ * Upward region.
+ *
+ * Blocks of ZKVM_UPWARD_THRESHOLD bytes and more - large managed arrays and
+ * large malloc() requests - and every realloc() target are bumped upward
+ * from _kernel_heap_bottom; the two pointers meet in the middle.
+ *
+ * Only the most recent headered upward block changes size: realloc() grows
+ * it in place while the gap allows, which turns the repeated copy-and-double
+ * growth of RLP/trie buffers into a pointer bump, and free() of it retracts
+ * the pointer. Everything above zk_up_high has never been handed out and is
+ * still zero RAM; an upward block placed below it is cleared first, and the
+ * downward side never goes below it.
+ */
+static uint8_t *zk_up      = (uint8_t *)_kernel_heap_bottom; /* next free byte */
+static uint8_t *zk_up_high = (uint8_t *)_kernel_heap_bottom; /* highest zk_up so far */
+static uint8_t *zk_up_last;                                  /* last headered block */
+
+#define ZK_DOWN_FLOOR() ((uintptr_t)zk_up_high)
+
+static void *
+zk_up_alloc(size_t bytes, int header)
+{
+    if (mem == 0)
+        mem = (uint8_t *)_kernel_heap_top;
+
+    uintptr_t base = ((uintptr_t)zk_up + 7u) & ~(uintptr_t)7u;
+    uintptr_t p    = base + (header ? 8u : 0u);
+    uintptr_t high = (uintptr_t)zk_up_high;
+
+    bytes = (bytes + 7u) & ~(size_t)7u;
+    if (p > (uintptr_t)mem || bytes > (uintptr_t)mem - p)
+        return 0;
+
+    uintptr_t end = p + bytes;
+    if (base < high)
+        __builtin_memset((void *)base, 0, (end < high ? end : high) - base);
+    if (end > high)
+        zk_up_high = (uint8_t *)end;
+    zk_up = (uint8_t *)end;
+
+    if (header)
+    {
+        *(uint64_t *)base = (uint64_t)bytes;
+        zk_up_last = (uint8_t *)p;
+    }
+    else
+    {
+        zk_up_last = 0;
+    }
+    return (void *)p;
+}
+
+/* Grow (or shrink) the last headered upward block in place. */
+static int
+zk_up_resize_last(void *p, size_t bytes)
+{
+    bytes = (bytes + 7u) & ~(size_t)7u;
+    if ((uint8_t *)p != zk_up_last || bytes > (uintptr_t)mem - (uintptr_t)p)
+        return 0;
+
+    uintptr_t end = (uintptr_t)p + bytes;
+    if (end > (uintptr_t)zk_up_high)
+        zk_up_high = (uint8_t *)end;
+    zk_up = (uint8_t *)end;
+    *(uint64_t *)((uint8_t *)p - 8u) = (uint64_t)bytes;
+    return 1;
+}
+
+/* free() of the last headered upward block gives its space back. */
+static inline void
+zk_up_free(void *p)
+{
+    if (p != 0 && (uint8_t *)p == zk_up_last)
+    {
+        zk_up      = (uint8_t *)p - 8u;
+        zk_up_last = 0;
+    }
+}
+#else
+#define ZK_DOWN_FLOOR() ((uintptr_t)_kernel_heap_bottom)
+#endif
+
+#if ZKVM_FREELIST_ALLOC
+/*
+ * Segregated size-class free lists.
+ *
+ * Requests are rounded up to their class size - 16-byte steps up to 1 KiB,
+ * then four steps per power of two - and that rounded size is what goes into
+ * the 8-byte header. free() therefore recovers the class from the header
+ * alone, with no search, and a header that is not an exact class size (a
+ * request too large for any class) marks a block that is simply dropped.
+ *
+ * Each list is a LIFO threaded through the first word of the free payloads.
+ * Only malloc/free/realloc touch the lists, so the addresses handed out are a
+ * pure function of the call sequence: same input, same heap layout, same
+ * proof.
+ */
+#define ZK_SMALL_CLASS_MAX      1024u
+#define ZK_SMALL_CLASS_STEP     16u
+#define ZK_SMALL_CLASSES        (ZK_SMALL_CLASS_MAX / ZK_SMALL_CLASS_STEP)
+#define ZK_LARGE_CLASS_LOG2_MIN 10u
+#define ZK_LARGE_CLASS_LOG2_MAX 32u
+#define ZK_NUM_CLASSES          (ZK_SMALL_CLASSES + \
+                                 (ZK_LARGE_CLASS_LOG2_MAX - ZK_LARGE_CLASS_LOG2_MIN + 1u) * 4u)
+
+static void *zk_free_lists[ZK_NUM_CLASSES];
+
+/* Round *n up to its class size and return the class index, or -1 for sizes
+ * too large to ever be recycled (those keep their plain 8-byte rounding). */
+static inline int
+zk_size_class(size_t *n)
+{
+    size_t sz = *n;
+
+    if (sz <= ZK_SMALL_CLASS_MAX)
+    {
+        size_t c = (sz + ZK_SMALL_CLASS_STEP - 1u) / ZK_SMALL_CLASS_STEP;
+        if (c == 0)
+            c = 1; /* the payload must hold the free-list link */
+        *n = c * ZK_SMALL_CLASS_STEP;
+        return (int)c - 1;
+    }
+
+    /* 2^k < sz <= 2^(k+1), split into four steps of 2^(k-2) */
+    unsigned k = 63u - (unsigned)__builtin_clzll((unsigned long long)(sz - 1u));
+    if (k > ZK_LARGE_CLASS_LOG2_MAX)
+        return -1;
+
+    size_t step = (size_t)1 << (k - 2u);
+    sz = (sz + step - 1u) & ~(step - 1u);
+    *n = sz;
+    return (int)(ZK_SMALL_CLASSES + (k - ZK_LARGE_CLASS_LOG2_MIN) * 4u +
+                 (unsigned)((sz - ((size_t)1 << k)) / step) - 1u);
+}
+
+static inline void *
+zk_freelist_pop(size_t *n)
+{
+    int   cls = zk_size_class(n);
+    void *p;
+
+    if (cls < 0 || (p = zk_free_lists[cls]) == 0)
+        return 0;
+
+    zk_free_lists[cls] = *(void **)p;
+
+    /* Recycled blocks must look like fresh zkVM RAM: calloc and the managed
+     * allocators rely on malloc handing out zeroed memory. */
+    __builtin_memset(p, 0, *n);
+    return p;
+}
+
+static inline void
+zk_freelist_push(void *p)
+{
+    if (p == 0 || (uintptr_t)p <= (uintptr_t)mem ||
+        (uintptr_t)p > (uintptr_t)_kernel_heap_top)
+        return;
+
+    size_t len = (size_t)*(uint64_t *)((uint8_t *)p - 8u);
+    size_t sz  = len;
+    int    cls = zk_size_class(&sz);
+    if (cls < 0 || sz != len)
+        return;
+
+    *(void **)p = zk_free_lists[cls];
+    zk_free_lists[cls] = p;
+}
+
+/* Drop every free block below `floor` (i.e. allocated after a heap mark). */
+static void
+zk_freelist_prune(uintptr_t floor)
+{
+    for (unsigned i = 0; i < ZK_NUM_CLASSES; i++)
+    {
+        void **link = &zk_free_lists[i];
+        while (*link != 0)
+        {
+            if ((uintptr_t)*link < floor)
+                *link = *(void **)*link;
+            else
+                link = (void **)*link;
+        }
+    }
+}
+#endif
+
+#if ZKVM_SIM
+/* Initial stack pointer as handed over by the kernel (argc, argv, envp, auxv),
+ * saved by the zisk_sim _start before it switches to its own stack. */
+extern uintptr_t __zkvm_sim_initial_sp;
+
+extern long __real_syscall(long number, ...);
+
+/* getenv() is wrapped and musl only sees the fake argv, so read the real
+ * process environment straight off the initial stack. Shared with the other
+ * sim-flavoured modules. */
+const char *
+zk_sim_getenv(const char *name)
+{
+    uintptr_t *sp = (uintptr_t *)__zkvm_sim_initial_sp;
+    size_t     n  = strlen(name);
+
+    if (sp == 0)
+        return 0;
+
+    for (char **envp = (char **)(sp + 1 + sp[0] + 1); *envp != 0; envp++)
+    {
+        if (strncmp(*envp, name, n) == 0 && (*envp)[n] == '=')
+            return *envp + n + 1;
+    }
+    return 0;
+}
+
+/*
+ * Heap debug mode (zisk_sim only, ZKVM_HEAP_DEBUG=1 in the environment).
+ *
+ * Instead of rewinding, zk_heap_reset() fills the released range with 0xCD
+ * and revokes access to the whole pages inside it, and the range is never
+ * handed out again. A stale reference then faults on first touch (or, at the
+ * ragged page edges, reads a non-canonical 0xCDCD... MethodTable pointer and
+ * faults on the next dispatch) rather than silently reading recycled memory.
+ */
+#define ZK_HEAP_POISON_BYTE 0xCD
+#define ZK_SYS_MPROTECT     226
+#define ZK_PAGE_SIZE        4096u
+
+static int
+zk_heap_debug(void)
+{
+    static int state = -1;
+
+    if (state < 0)
+    {
+        const char *v = zk_sim_getenv("ZKVM_HEAP_DEBUG");
+        state = (v != 0 && v[0] != '\0' && v[0] != '0');
+    }
+    return state;
+}
+
+static void
+zk_heap_poison(uintptr_t lo, uintptr_t hi)
+{
+    uintptr_t page_lo = (lo + ZK_PAGE_SIZE - 1u) & ~(uintptr_t)(ZK_PAGE_SIZE - 1u);
+    uintptr_t page_hi = hi & ~(uintptr_t)(ZK_PAGE_SIZE - 1u);
+
+    __builtin_memset((void *)lo, ZK_HEAP_POISON_BYTE, hi - lo);
+    if (page_lo < page_hi)
+        __real_syscall(ZK_SYS_MPROTECT, page_lo, page_hi - page_lo, 0 /* PROT_NONE */);
+}
+
+/*
+ * Stack high-water mark (zisk_sim only, ZKVM_STACK_REPORT=1 in the environment).
+ *
+ * _start (modules/zkvm_zisk_sim) fills the stack with ZK_STACK_CANARY before
+ * switching to it; the lowest word that no longer holds the pattern is as far
+ * as the stack ever grew. Compare with the static bound `bflat build
+ * --zkvm-stack-report` gives, and size the zisk stack with --stack-size.
+ */
+#define ZK_STACK_CANARY 0x5a4b535441434b21ull /* "!KCATSKZ" */
+
+extern uint64_t _stack_bottom[];
+extern uint64_t _init_stack_top[];
+
+static void
+zk_stack_report(void)
+{
+    const char *v = zk_sim_getenv("ZKVM_STACK_REPORT");
+    uint64_t   *p = _stack_bottom;
+    char        line[96];
+    int         len;
+
+    if (v == 0 || v[0] == '\0' || v[0] == '0')
+        return;
+
+    while (p < _init_stack_top && *p == ZK_STACK_CANARY)
+        p++;
+
+    len = snprintf(line, sizeof(line), "stack: %lu of %lu bytes used\n",
+                   (unsigned long)((uintptr_t)_init_stack_top - (uintptr_t)p),
+                   (unsigned long)((uintptr_t)_init_stack_top - (uintptr_t)_stack_bottom));
+    if (len > 0)
+        __real_syscall(64 /* write */, 2 /* stderr */, line, len);
+}
+#endif
+
+#if ZKVM_PROFILE
+/*
+ * Allocation profiler.
+ *
+ * Two open-addressing tables count objects and bytes, one keyed by
+ * MethodTable and one by the caller's return address. zk_prof_dump() prints
+ * them at exit as `ZKALLOC` lines on stderr, unsorted and with raw
+ * addresses; `bflat allocprof` symbolises and ranks them against the ELF.
+ */
+#define ZK_PROF_SLOTS 4096u /* per table, power of two */
+
+struct zk_prof_slot
+{
+    uintptr_t key;
+    uint64_t  count;
+    uint64_t  bytes;
+};
+
+static struct zk_prof_slot zk_prof_types[ZK_PROF_SLOTS];
+static struct zk_prof_slot zk_prof_sites[ZK_PROF_SLOTS];
+static uint64_t            zk_prof_dropped; /* records that found no free slot */
+static uintptr_t           zk_prof_low;     /* lowest downward bump pointer seen */
+
+static void
+zk_prof_count(struct zk_prof_slot *table, uintptr_t key, uint64_t bytes)
+{
+    uint32_t i = (uint32_t)(((key >> 3) * 0x9E3779B97F4A7C15ull) >> 52) & (ZK_PROF_SLOTS - 1u);
+
+    for (uint32_t n = 0; n < ZK_PROF_SLOTS; n++, i = (i + 1u) & (ZK_PROF_SLOTS - 1u))
+    {
+        if (table[i].key == key || table[i].key == 0)
+        {
+            table[i].key = key;
+            table[i].count++;
+            table[i].bytes += bytes;
+            return;
+        }
+    }
+    zk_prof_dropped++;
+}
+
+/* The bump pointer only moves up again on zk_heap_reset, so sampling it there
+ * and on every record is enough to catch its low-water mark. */
+static inline void
+zk_prof_note_low(void)
+{
+    if (mem != 0 && (zk_prof_low == 0 || (uintptr_t)mem < zk_prof_low))
+        zk_prof_low = (uintptr_t)mem;
+}
+
+void
+zk_prof_record(const void *methodTable, size_t bytes, const void *site)
+{
+    zk_prof_count(zk_prof_types, (uintptr_t)methodTable, bytes);
+    zk_prof_count(zk_prof_sites, (uintptr_t)site, bytes);
+    zk_prof_note_low();
+}
+
+static void
+zk_prof_write(const char *line, int len)
+{
+    if (len > 0)
+        __real_syscall(64 /* write */, 2 /* stderr */, line, len);
+}
+
+static void
+zk_prof_dump_table(const char *kind, const struct zk_prof_slot *table)
+{
+    char line[96];
+
+    for (uint32_t i = 0; i < ZK_PROF_SLOTS; i++)
+    {
+        if (table[i].key == 0)
+            continue;
+        zk_prof_write(line, snprintf(line, sizeof(line),
+            "ZKALLOC %s %#" PRIxPTR " %" PRIu64 " %" PRIu64 "\n",
+            kind, table[i].key, table[i].count, table[i].bytes));
+    }
+}
+
+/* Counters kept by other modules' profiling flavours (rhp's cast cache,
+ * nofp's soft-float calls); weak, so a missing flavour just drops the line. */
+extern uint64_t zk_prof_cast_hits __attribute__((weak));
+extern uint64_t zk_prof_cast_misses __attribute__((weak));
+extern const char *const zk_prof_fp_names[] __attribute__((weak));
+extern uint64_t zk_prof_fp_calls[] __attribute__((weak));
+extern const uint32_t zk_prof_fp_helpers __attribute__((weak));
+
+static void
+zk_prof_dump(void)
+{
+    char line[160];
+
+    if (mem == 0)
+        mem = (uint8_t *)_kernel_heap_top;
+    zk_prof_note_low();
+
+    uint64_t high_water = (uint64_t)((uintptr_t)_kernel_heap_top - zk_prof_low);
+#if ZKVM_DUAL_HEAP
+    high_water += (uint64_t)((uintptr_t)zk_up_high - (uintptr_t)_kernel_heap_bottom);
+#endif
+
+    zk_prof_write(line, snprintf(line, sizeof(line),
+        "ZKALLOC heap size=%" PRIu64 " high_water=%" PRIu64 " remaining=%" PRIu64
+        " dropped=%" PRIu64 "\n",
+        (uint64_t)((uintptr_t)_kernel_heap_top - (uintptr_t)_kernel_heap_bottom),
+        high_water,
+        (uint64_t)((uintptr_t)mem - ZK_DOWN_FLOOR()),
+        zk_prof_dropped));
+    zk_prof_dump_table("type", zk_prof_types);
+    zk_prof_dump_table("site", zk_prof_sites);
+
+    if (&zk_prof_cast_hits != 0 && &zk_prof_cast_misses != 0)
+        zk_prof_write(line, snprintf(line, sizeof(line),
+            "ZKALLOC counter cast_cache_hits=%" PRIu64 " cast_cache_misses=%" PRIu64 "\n",
+            zk_prof_cast_hits, zk_prof_cast_misses));
+
+    if (&zk_prof_fp_helpers != 0)
+    {
+        for (uint32_t i = 0; i < zk_prof_fp_helpers; i++)
+        {
+            if (zk_prof_fp_calls[i] != 0)
+                zk_prof_write(line, snprintf(line, sizeof(line),
+                    "ZKALLOC counter fp_%s=%" PRIu64 "\n", zk_prof_fp_names[i], zk_prof_fp_calls[i]));
+        }
+    }
+}
+
+#define ZK_PROF_RECORD(mt, bytes) zk_prof_record((mt), (bytes), __builtin_return_address(0))
+#else
+#define ZK_PROF_RECORD(mt, bytes) ((void)0)
+#endif
+
+#if ZKVM_GC
+/*
+ * Explicit mark-sweep collector (the "gc" variant, `bflat build --zkvm-gc`).
+ *
+ * uGC never collects. This collector runs only when managed code calls
+ * GC.Collect() (RhpCollect), never behind an allocation, so where and what it
+ * frees is a pure function of the program's execution and multi-block proofs
+ * stay reproducible.
+ *
+ * In this variant all native memory (malloc, mmap, the handle store) lives in
+ * the upward region and only managed objects live in the downward one, so
+ * [mem, _kernel_heap_top) is a gap-free run of objects, each sized by its
+ * MethodTable. Freed space stays walkable: its first word is a small tag that
+ * no MethodTable address can take.
+ *
+ * Roots are scanned conservatively - callee-saved registers, the stack from
+ * sp to _init_stack_top, .data/.bss (statics), the thread's .tdata/.tbss
+ * block (inlined thread statics) and the used part of the upward region
+ * (handles, runtime tables) - so no stack maps are
+ * needed. Objects are traced precisely through their GCDesc. Nothing moves,
+ * which is what makes ambiguous roots safe: dead runs are zeroed and threaded
+ * onto a free list, and a dead run at the bottom of the heap goes straight
+ * back to the bump pointer.
+ */
+#define ZK_GC_CHUNK  1u /* free chunk: size at +8, next chunk at +16 if size >= 24 */
+#define ZK_GC_FILLER 2u /* 8-byte hole */
+
+#define ZK_MT_HAS_COMPONENT_SIZE 0x80000000u
+#define ZK_MT_HAS_POINTERS       0x01000000u
+
+#define ZK_GC_MARK_STACK 65536u /* entries; overflow falls back to heap rescans */
+
+extern char     __data_start[];
+extern char     _bss_end[];
+extern char     __tdata_start[];
+extern char     __tbss_end[];
+extern uint64_t _init_stack_top[];
+
+static uint8_t *zk_gc_free; /* free chunks, lowest address first */
+static uint8_t *zk_gc_cur;  /* allocation window [zk_gc_lim, zk_gc_cur) */
+static uint8_t *zk_gc_lim;
+
+/* Collection-time state; the bitmaps and mark stack borrow the upward region. */
+static uintptr_t  zk_gc_lo, zk_gc_hi;
+static uint64_t  *zk_gc_starts; /* bit per 8 bytes: an object starts here */
+static uint64_t  *zk_gc_marks;  /* bit per 8 bytes: that object is live */
+static uintptr_t *zk_gc_stack;
+static uint32_t   zk_gc_depth;
+static int        zk_gc_overflow;
+
+/* Size as the allocators computed it: base size + components, before
+ * alignment. The GCDesc series are expressed against this figure. */
+static inline size_t
+zk_gc_raw_size(uintptr_t obj)
+{
+    const uint8_t *mt    = *(const uint8_t **)obj;
+    uint32_t       flags = *(const uint32_t *)mt;
+    size_t         size  = *(const uint32_t *)(mt + 4);
+
+    if (flags & ZK_MT_HAS_COMPONENT_SIZE)
+        size += (size_t)(flags & 0xFFFFu) * *(const uint32_t *)(obj + 8);
+    return size;
+}
+
+/* Footprint of whatever starts at `p`: an object, a free chunk or a filler. */
+static inline size_t
+zk_gc_block_size(uintptr_t p)
+{
+    uintptr_t w = *(const uintptr_t *)p;
+
+    if (w == ZK_GC_CHUNK)
+        return (size_t)*(const uint64_t *)(p + 8);
+    if (w == ZK_GC_FILLER)
+        return 8;
+
+    size_t size = zk_gc_raw_size(p);
+    if (size < 0x18)
+        size = 0x18;
+    return (size + 7u) & ~(size_t)7u;
+}
+
+/* Turn [a, b) - zeroed, or about to be reused - into a walkable hole. */
+static void
+zk_gc_hole(uintptr_t a, uintptr_t b)
+{
+    if (b - a >= 16)
+    {
+        ((uint64_t *)a)[0] = ZK_GC_CHUNK;
+        ((uint64_t *)a)[1] = (uint64_t)(b - a);
+    }
+    else if (b > a)
+    {
+        ((uint64_t *)a)[0] = ZK_GC_FILLER;
+    }
+}
+
+/* Give the unused part of the allocation window back as a hole, so the heap
+ * is walkable again. Holes of 24 bytes and more go back on the list. */
+static void
+zk_gc_seal_window(void)
+{
+    uintptr_t a = (uintptr_t)zk_gc_lim, b = (uintptr_t)zk_gc_cur;
+
+    zk_gc_lim = zk_gc_cur = 0;
+    zk_gc_hole(a, b);
+    if (b - a >= 24)
+    {
+        *(uint8_t **)(a + 16) = zk_gc_free;
+        zk_gc_free = (uint8_t *)a;
+    }
+}
+
+/* First fit from the free list; the chunk becomes the allocation window. */
+static void *
+zk_gc_alloc_slow(size_t bytes)
+{
+    uint8_t **link = &zk_gc_free;
+
+    while (*link != 0)
+    {
+        uint8_t *c    = *link;
+        size_t   size = (size_t)*(uint64_t *)(c + 8);
+
+        if (size >= bytes)
+        {
+            *link = *(uint8_t **)(c + 16);
+            zk_gc_seal_window();
+            __builtin_memset(c, 0, 24);
+            zk_gc_lim = c;
+            zk_gc_cur = c + size - bytes;
+            return zk_gc_cur;
+        }
+        link = (uint8_t **)(c + 16);
+    }
+    return 0;
+}
+
+/* Before the bump pointer moves up to `floor` (zk_heap_reset): forget free
+ * space below it, re-heading anything that straddles it. */
+static void
+zk_gc_prune(uintptr_t floor)
+{
+    if ((uintptr_t)zk_gc_lim < floor)
+    {
+        if ((uintptr_t)zk_gc_cur > floor)
+            zk_gc_lim = (uint8_t *)floor;
+        else
+            zk_gc_lim = zk_gc_cur = 0;
+    }
+
+    uint8_t **link = &zk_gc_free;
+    while (*link != 0)
+    {
+        uintptr_t c   = (uintptr_t)*link;
+        uintptr_t end = c + (uintptr_t)*(uint64_t *)(c + 8);
+
+        if (c >= floor)
+        {
+            link = (uint8_t **)(c + 16);
+            continue;
+        }
+
+        uint8_t *next = *(uint8_t **)(c + 16);
+        if (end > floor)
+        {
+            zk_gc_hole(floor, end);
+            if (end - floor >= 24)
+            {
+                *(uint8_t **)(floor + 16) = next;
+                *link = (uint8_t *)floor;
+                link  = (uint8_t **)(floor + 16);
+                continue;
+            }
+        }
+        *link = next;
+    }
+}
+
+static inline int
+zk_gc_bit(const uint64_t *bits, uintptr_t p)
+{
+    uintptr_t i = (p - zk_gc_lo) >> 3;
+    return (int)((bits[i >> 6] >> (i & 63u)) & 1u);
+}
+
+static void
+zk_gc_mark(uintptr_t obj)
+{
+    uintptr_t i   = (obj - zk_gc_lo) >> 3;
+    uint64_t  bit = 1ull << (i & 63u);
+
+    if (zk_gc_marks[i >> 6] & bit)
+        return;
+    zk_gc_marks[i >> 6] |= bit;
+
+    if (zk_gc_depth == ZK_GC_MARK_STACK)
+        zk_gc_overflow = 1;
+    else
+        zk_gc_stack[zk_gc_depth++] = obj;
+}
+
+/* A field of a live object: either null, outside the heap, or an object. */
+static inline void
+zk_gc_mark_field(uintptr_t p)
+{
+    if (p >= zk_gc_lo && p < zk_gc_hi && (p & 7u) == 0 && zk_gc_bit(zk_gc_starts, p))
+        zk_gc_mark(p);
+}
+
+/* An ambiguous root: anything that points into an object keeps it alive. */
+static void
+zk_gc_mark_ambiguous(uintptr_t p)
+{
+    if (p < zk_gc_lo || p >= zk_gc_hi)
+        return;
+
+    uintptr_t i    = (p - zk_gc_lo) >> 3;
+    uintptr_t word = i >> 6;
+    uint64_t  bits = zk_gc_starts[word] & (~0ull >> (63u - (i & 63u)));
+
+    while (bits == 0)
+    {
+        if (word == 0)
+            return;
+        bits = zk_gc_starts[--word];
+    }
+
+    uintptr_t obj = zk_gc_lo + (((word << 6) + 63u - (uintptr_t)__builtin_clzll(bits)) << 3);
+    if (p < obj + zk_gc_block_size(obj))
+        zk_gc_mark(obj);
+}
+
+static void
+zk_gc_scan_range(uintptr_t lo, uintptr_t hi)
+{
+    for (lo = (lo + 7u) & ~(uintptr_t)7u; lo + 8u <= hi; lo += 8u)
+        zk_gc_mark_ambiguous(*(const uintptr_t *)lo);
+}
+
+/* Visit the reference fields of `obj` as described by the GCDesc that sits
+ * in front of its MethodTable: the series count at MT-8, then either that
+ * many {size, offset} series going down from MT-24 (sizes are relative to
+ * the object size), or - for arrays of structs, a negative count - one start
+ * offset at MT-16 and {nptrs, skip} pairs going down from MT-24. */
+static void
+zk_gc_scan_object(uintptr_t obj)
+{
+    const uint8_t *mt = *(const uint8_t **)obj;
+
+    if ((*(const uint32_t *)mt & ZK_MT_HAS_POINTERS) == 0)
+        return;
+
+    size_t           size   = zk_gc_raw_size(obj);
+    intptr_t         n      = *(const intptr_t *)(mt - 8);
+    const uintptr_t *series = (const uintptr_t *)(mt - 24);
+
+    if (n > 0)
+    {
+        for (intptr_t s = 0; s < n; s++, series -= 2)
+        {
+            const uintptr_t *p    = (const uintptr_t *)(obj + series[1]);
+            const uintptr_t *stop = (const uintptr_t *)((uintptr_t)p + series[0] + size);
+
+            for (; p < stop; p++)
+                zk_gc_mark_field(*p);
+        }
+    }
+    else
+    {
+        const uintptr_t *p   = (const uintptr_t *)(obj + series[1]);
+        const uintptr_t *end = (const uintptr_t *)(obj + size - 8u);
+
+        while (p < end)
+        {
+            for (intptr_t k = 0; k > n; k--)
+            {
+                const uint32_t  *item = (const uint32_t *)((const uint8_t *)series + 8 * k);
+                const uintptr_t *stop = p + item[0];
+
+                for (; p < stop; p++)
+                    zk_gc_mark_field(*p);
+                p = (const uintptr_t *)((uintptr_t)stop + item[1]);
+            }
+        }
+    }
+}
+
+static void
+zk_gc_drain(void)
+{
+    for (;;)
+    {
+        while (zk_gc_depth != 0)
+            zk_gc_scan_object(zk_gc_stack[--zk_gc_depth]);
+
+        if (!zk_gc_overflow)
+            return;
+
+        /* Mark stack overflowed: rescan every marked object; marking is
+         * idempotent, so this converges. */
+        zk_gc_overflow = 0;
+        for (uintptr_t p = zk_gc_lo; p < zk_gc_hi; p += zk_gc_block_size(p))
+        {
+            if (zk_gc_bit(zk_gc_marks, p))
+                zk_gc_scan_object(p);
+            while (zk_gc_depth != 0)
+                zk_gc_scan_object(zk_gc_stack[--zk_gc_depth]);
+        }
+    }
+}
+
+/* A dead run [a, b): zero it, then hand it to the bump pointer if it is the
+ * bottom of the heap, or make it a free chunk. */
+static uint8_t **
+zk_gc_release(uintptr_t a, uintptr_t b, uint8_t **tail)
+{
+    __builtin_memset((void *)a, 0, b - a);
+
+    if (a == (uintptr_t)mem)
+    {
+        mem = (uint8_t *)b;
+        return tail;
+    }
+
+    zk_gc_hole(a, b);
+    if (b - a >= 24)
+    {
+        *tail = (uint8_t *)a;
+        tail  = (uint8_t **)(a + 16);
+    }
+    return tail;
+}
+
+__attribute__((noinline)) static void
+zk_gc_collect(void)
+{
+    uintptr_t sp;
+
+    /* Callee-saved registers may hold the only reference to an object;
+     * force them into this frame so the stack scan sees them. */
+    __builtin_unwind_init();
+#if defined(__riscv)
+    __asm__ volatile("mv %0, sp" : "=r"(sp));
+#else
+    sp = (uintptr_t)__builtin_frame_address(0) - 256u;
+#endif
+
+    if (mem == 0)
+        return;
+    zk_gc_seal_window();
+    zk_gc_free = 0;
+
+    zk_gc_lo = (uintptr_t)mem;
+    zk_gc_hi = (uintptr_t)_kernel_heap_top;
+    if (zk_gc_lo == zk_gc_hi)
+        return;
+
+    uint8_t  *up_before   = zk_up;
+    uint8_t  *last_before = zk_up_last;
+    size_t    words       = (size_t)(((zk_gc_hi - zk_gc_lo) >> 3) + 63u) >> 6;
+
+    zk_gc_starts = zk_up_alloc(words * 8u, 0);
+    zk_gc_marks  = zk_up_alloc(words * 8u, 0);
+    zk_gc_stack  = zk_up_alloc(ZK_GC_MARK_STACK * sizeof(uintptr_t), 0);
+    zk_gc_depth  = 0;
+    zk_gc_overflow = 0;
+
+    if (zk_gc_starts != 0 && zk_gc_marks != 0 && zk_gc_stack != 0)
+    {
+        for (uintptr_t p = zk_gc_lo; p < zk_gc_hi; p += zk_gc_block_size(p))
+        {
+            if (*(const uintptr_t *)p > ZK_GC_FILLER)
+            {
+                uintptr_t i = (p - zk_gc_lo) >> 3;
+                zk_gc_starts[i >> 6] |= 1ull << (i & 63u);
+            }
+        }
+
+        zk_gc_scan_range(sp, (uintptr_t)_init_stack_top);
+        zk_gc_scan_range((uintptr_t)__data_start, (uintptr_t)_bss_end);
+        zk_gc_scan_range((uintptr_t)__tdata_start, (uintptr_t)__tbss_end);
+        zk_gc_scan_range((uintptr_t)_kernel_heap_bottom, (uintptr_t)up_before);
+        zk_gc_drain();
+
+        uint8_t **tail = &zk_gc_free;
+        uintptr_t run  = 0;
+        for (uintptr_t p = zk_gc_lo; p < zk_gc_hi; )
+        {
+            size_t size = zk_gc_block_size(p);
+            int    live = *(const uintptr_t *)p > ZK_GC_FILLER && zk_gc_bit(zk_gc_marks, p);
+
+            if (live && run != 0)
+            {
+                tail = zk_gc_release(run, p, tail);
+                run  = 0;
+            }
+            else if (!live && run == 0)
+            {
+                run = p;
+            }
+            p += size;
+        }
+        if (run != 0)
+            tail = zk_gc_release(run, zk_gc_hi, tail);
+        *tail = 0;
+    }
+
+    /* The collector's own scratch goes away again. */
+    zk_up      = up_before;
+    zk_up_last = last_before;
+}
+
+/* GC.Collect() lands here (RuntimeImports.RhCollect -> RhpCollect). */
+void
+__wrap_RhpCollect(uint32_t generation, uint32_t mode, uint32_t lowMemory)
+{
+    (void)generation;
+    (void)mode;
+    (void)lowMemory;
+    zk_gc_collect();
+}
+#endif
+
+#if ZKVM_DUAL_HEAP
+/* Release the upward region back to `up` and its high-water mark back to
+ * `high` (the counterpart of zk_heap_reset for the other end). The range
+ * between the two is cleared lazily by zk_up_alloc; everything above `high`
+ * is cleared here, so it is zero RAM again and the downward side may use it. */
+static void
+zk_up_reset(uint8_t *up, uint8_t *high)
+{
+    if (up == 0 || up > zk_up || high < up)
+        return;
+#if ZKVM_SIM && !ZKVM_GC
+    if (zk_heap_debug())
+    {
+        zk_heap_poison((uintptr_t)up, (uintptr_t)zk_up_high);
+        zk_up_last = 0;
+        return;
+    }
+#endif
+    if (high < zk_up_high)
+    {
+        __builtin_memset(high, 0, (size_t)(zk_up_high - high));
+        zk_up_high = high;
+    }
+    zk_up      = up;
+    zk_up_last = 0;
+}
+#endif
 
 /*
  * Heap mark/reset: used by the preinit warmup to drop ephemeral allocations
  * (block/tx/witness/EvmStack buffers from the warmup Execute) after type
  * loading and dispatch-cell resolution have happened. Caller is responsible
  * for ensuring no live reference points into the released region.
+ *
+ * The released range is cleared on reset: the allocators hand out memory
+ * without zeroing it (ZKVM_FAST_ALLOC), which is only sound while everything
+ * below the bump pointer is untouched zkVM RAM.
+ *
+ * With the dual-ended heap, zk_heap_mark() also records the upward end, and
+ * resetting to the most recent mark rewinds both ends, so large blocks and
+ * realloc() targets taken since the mark are released as well.
  */
+#if ZKVM_DUAL_HEAP
+static void    *zk_heap_mark_down;
+static uint8_t *zk_heap_mark_up;
+static uint8_t *zk_heap_mark_high;
+#endif
+
 void *
 zk_heap_mark(void)
 {
+    if (mem == 0)
+        mem = (uint8_t *)_kernel_heap_top;
+#if ZKVM_DUAL_HEAP
+    zk_heap_mark_down = mem;
+    zk_heap_mark_up   = zk_up;
+    zk_heap_mark_high = zk_up_high;
+#endif
     return (void *)mem;
 }
 
+static void
+zk_heap_reset_down(void *m)
+{
+    if (m != 0 && (uint8_t *)m >= mem)
+    {
+#if ZKVM_PROFILE
+        zk_prof_note_low();
+#endif
+#if ZKVM_FREELIST_ALLOC
+        zk_freelist_prune((uintptr_t)m);
+#endif
+#if ZKVM_GC
+        zk_gc_prune((uintptr_t)m);
+#endif
+#if ZKVM_SIM && !ZKVM_GC
+        if (zk_heap_debug())
+        {
+            zk_heap_poison((uintptr_t)mem, (uintptr_t)m);
+            return;
+        }
+#endif
+        __builtin_memset(mem, 0, (size_t)((uint8_t *)m - mem));
+        mem = (uint8_t *)m;
+    }
+}
+
 void
 zk_heap_reset(void *m)
 {
-    if (m != 0)
-        mem = (uint8_t *)m;
+    zk_heap_reset_down(m);
+#if ZKVM_DUAL_HEAP
+    if (m != 0 && m == zk_heap_mark_down)
+        zk_up_reset(zk_heap_mark_up, zk_heap_mark_high);
+#endif
+}
+
+/*
+ * Scoped arenas (the managed ZkArena API): a fixed stack of heap marks.
+ * zk_arena_enter() pushes the current marks of both heap ends and returns
+ * its depth; zk_arena_leave(depth) resets the heap to those marks and also
+ * closes any inner scope still open above it, so scopes nest and a missed
+ * inner Dispose() cannot leave a dangling mark behind.
+ */
+#define ZK_ARENA_MAX_DEPTH 64
+
+struct zk_arena_mark
+{
+    void    *down;
+#if ZKVM_DUAL_HEAP
+    uint8_t *up;
+    uint8_t *high;
+#endif
+};
+
+static struct zk_arena_mark zk_arena_marks[ZK_ARENA_MAX_DEPTH];
+static int                  zk_arena_depth;
+
+int
+zk_arena_enter(void)
+{
+    if (zk_arena_depth == ZK_ARENA_MAX_DEPTH)
+        return -1;
+
+    if (mem == 0)
+        mem = (uint8_t *)_kernel_heap_top;
+    zk_arena_marks[zk_arena_depth].down = mem;
+#if ZKVM_DUAL_HEAP
+    zk_arena_marks[zk_arena_depth].up   = zk_up;
+    zk_arena_marks[zk_arena_depth].high = zk_up_high;
+#endif
+    return zk_arena_depth++;
+}
+
+void
+zk_arena_leave(int depth)
+{
+    if (depth < 0 || depth >= zk_arena_depth)
+        return;
+
+    zk_heap_reset_down(zk_arena_marks[depth].down);
+#if ZKVM_DUAL_HEAP
+    zk_up_reset(zk_arena_marks[depth].up, zk_arena_marks[depth].high);
+#endif
+    zk_arena_depth = depth;
 }
 
 void *
 __wrap___libc_malloc_impl(unsigned long n)
 {
+#if ZKVM_DUAL_HEAP
+    /* The collector walks the downward region as managed objects only. */
+    if (ZKVM_GC || n >= ZKVM_UPWARD_THRESHOLD)
+        return zk_up_alloc((size_t)n, 1);
+#endif
+
 #if ZKVM_FAST_ALLOC
     if (mem == 0)
         mem = (uint8_t *)_kernel_heap_top;
 
-    size_t req_aligned = ((size_t)n + 7u) & ~(size_t)7u;
+    size_t req_aligned = (size_t)n;
+#if ZKVM_FREELIST_ALLOC
+    void *reused = zk_freelist_pop(&req_aligned);
+    if (reused)
+        return reused;
+#endif
+    req_aligned = (req_aligned + 7u) & ~(size_t)7u;
     uintptr_t new_tmp = align_down_8_uintptr((uintptr_t)mem - req_aligned);
     uintptr_t new_len = new_tmp - 8u;
 
-    if (new_len < (uintptr_t)_kernel_heap_bottom)
+    if (new_len < ZK_DOWN_FLOOR())
         return NULL;
 
     mem = (uint8_t *)new_len;
@@ -149,7 +1190,7 @@ __wrap___libc_malloc_impl(unsigned long n)
 
     uint8_t  *saved_mem = mem;
     uintptr_t top = (uintptr_t)_kernel_heap_top;
-    uintptr_t bottom = (uintptr_t)_kernel_heap_bottom;
+    uintptr_t bottom = ZK_DOWN_FLOOR();
 
     /* Initialize bump pointer */
     if (mem == 0)
@@ -160,6 +1201,11 @@ __wrap___libc_malloc_impl(unsigned long n)
 
     /* Align requested size to 8 so our "len" header stays aligned */
     size_t req = (size_t)n;
+#if ZKVM_FREELIST_ALLOC
+    tmp = zk_freelist_pop(&req);
+    if (tmp)
+        return tmp;
+#endif
     size_t req_aligned = (req + 7u) & ~(size_t)7u;
 
     /* Compute new pointer using uintptr_t to avoid UB on pointer underflow */
@@ -169,8 +1215,6 @@ __wrap___libc_malloc_impl(unsigned long n)
     tmp = (void *)new_tmp_u;
     len = (uint64_t *)new_len_u;
 
-    rhp_tss_counter = 0;
-
     /* Emit maximum diagnostics with correct pointer formatting */
 #if _DEBUG
     printf(
@@ -230,15 +1274,68 @@ __wrap___libc_malloc_impl(unsigned long n)
 #endif
 }
 
+/* Managed-object allocation.
+ *
+ * Objects come off the same downward bump pointer as malloc, but without the
+ * size header: one store less per allocation and 8 bytes less per object,
+ * which matters on a heap dominated by small objects. Blocks handed out here
+ * must never reach free()/realloc() - nothing does that with managed objects.
+ * `bytes` must be a multiple of 8; the block is all-zero (fresh zkVM RAM in
+ * the fast path, an explicit memset otherwise). */
+static inline void *
+zk_bump_object(size_t bytes)
+{
+#if ZKVM_FAST_ALLOC && ZKVM_HEADERLESS_OBJECTS
+#if ZKVM_GC
+    if ((size_t)(zk_gc_cur - zk_gc_lim) >= bytes)
+    {
+        zk_gc_cur -= bytes;
+        return (void *)zk_gc_cur;
+    }
+    if (zk_gc_free != 0)
+    {
+        void *reused = zk_gc_alloc_slow(bytes);
+        if (reused)
+            return reused;
+    }
+#endif
+    if (mem == 0)
+        mem = (uint8_t *)_kernel_heap_top;
+    if (bytes > (uintptr_t)mem - ZK_DOWN_FLOOR())
+        return 0;
+    mem -= bytes;
+    return (void *)mem;
+#else
+    void *obj = __wrap___libc_malloc_impl((unsigned long)bytes);
+#if !ZKVM_FAST_ALLOC
+    if (obj) __builtin_memset(obj, 0, bytes);
+#endif
+    return obj;
+#endif
+}
+
+/* Out-of-line entry for the rhp object allocators (inlined under LTO).
+ * Large arrays go to the upward region, keeping the top dense - except with
+ * the collector, which only reclaims the downward one. */
+void *
+zk_alloc_object(size_t bytes)
+{
+#if ZKVM_DUAL_HEAP && !ZKVM_GC
+    if (bytes >= ZKVM_UPWARD_THRESHOLD)
+        return zk_up_alloc(bytes, 0);
+#endif
+    return zk_bump_object(bytes);
+}
+
 /* Tight fixed-size object allocator (the hot path, RhpNewFast).
  *
- * Defined here, in the same translation unit as the bump pointer `mem`, the
- * heap bounds and align_down_8_uintptr, so the downward bump is inlined
- * directly: NO nested malloc call, a SINGLE alignment step, and a leaf body
- * (eligible for frameless-leaf). This mirrors how x64/arm64 get fast
- * allocation - a tight RhpNewFast helper - rather than per-site JIT inlining
- * (which RyuJIT does on no target). --wrap=RhpNewFast (rhp module) redirects
- * managed callers here regardless of which .o defines the symbol. */
+ * Defined here, in the same translation unit as the bump pointer `mem` and
+ * the heap bounds, so the downward bump is inlined directly: NO nested malloc
+ * call, a SINGLE alignment step, and a leaf body (eligible for
+ * frameless-leaf). This mirrors how x64/arm64 get fast allocation - a tight
+ * RhpNewFast helper - rather than per-site JIT inlining (which RyuJIT does on
+ * no target). --wrap=RhpNewFast (rhp module) redirects managed callers here
+ * regardless of which .o defines the symbol. */
 void *
 __wrap_RhpNewFast(void *methodTable)
 {
@@ -250,36 +1347,28 @@ __wrap_RhpNewFast(void *methodTable)
     if (total < MIN_OBJECT_SIZE)
         total = MIN_OBJECT_SIZE;
 
-#if ZKVM_FAST_ALLOC
-    /* Inlined downward bump (mirrors __wrap___libc_malloc_impl fast path):
-     * one alignment, no call. zkVM RAM is zero so no memset is needed. */
-    if (mem == 0)
-        mem = (uint8_t *)_kernel_heap_top;
-    size_t    req        = (total + 7u) & ~(size_t)7u;
-    uintptr_t new_tmp    = align_down_8_uintptr((uintptr_t)mem - req);
-    uintptr_t new_len    = new_tmp - 8u;
-    if (new_len < (uintptr_t)_kernel_heap_bottom)
-        return 0;
-    mem                  = (uint8_t *)new_len;
-    *(uint64_t *)new_len = (uint64_t)req;        /* size header */
-    void *obj            = (void *)new_tmp;
-#else
-    total     = (total + 7u) & ~(size_t)7u;
-    void *obj = malloc(total);
-    if (obj) __builtin_memset(obj, 0, total);
+    total = (total + 7u) & ~(size_t)7u;
+
+    void *obj = zk_bump_object(total);
     if (!obj)
         return 0;
-#endif
 
     *(void **)obj = methodTable;                 /* MethodTable header at offset 0 */
+    ZK_PROF_RECORD(methodTable, total);
     return obj;
 }
 
 void
 __wrap___libc_free(void *p)
 {
+#if ZKVM_DUAL_HEAP
+    zk_up_free(p);
+#endif
+#if ZKVM_FREELIST_ALLOC
+    zk_freelist_push(p);
+#else
     (void)p;
-    rhp_tss_counter = 0;
+#endif
 }
 
 void *
@@ -288,8 +1377,6 @@ __wrap___libc_realloc(void *p, unsigned long n)
     void     *tmp;
     uint64_t *len;
 
-    rhp_tss_counter = 0;
-
     if (!p)
     {
 #if _DEBUG
@@ -309,7 +1396,15 @@ __wrap___libc_realloc(void *p, unsigned long n)
         return p;
     }
 
+#if ZKVM_DUAL_HEAP
+    /* The last upward block grows in place; anything else moves up there so
+     * that its next growth can. */
+    if (zk_up_resize_last(p, (size_t)n))
+        return p;
+    tmp = zk_up_alloc((size_t)n, 1);
+#else
     tmp = __wrap___libc_malloc_impl(n);
+#endif
     if (!tmp)
     {
 #if _DEBUG
@@ -319,6 +1414,9 @@ __wrap___libc_realloc(void *p, unsigned long n)
     }
 
     memcpy(tmp, p, (size_t)*len);
+#if ZKVM_FREELIST_ALLOC
+    zk_freelist_push(p);
+#endif
     return tmp;
 }
 
@@ -490,10 +1588,28 @@ zkvm_raw_exit(long code)
     for (;;) { } /* ecall ends the program; loop is just in case */
 }
 
+/* zkvm_zisk_output publishes the buffered console text and public outputs;
+ * weak, so a link without the module just exits. */
+extern void zk_output_commit(void) __attribute__((weak));
+
+static inline void
+zkvm_commit_output(void)
+{
+#if ZKVM_SIM
+    zk_stack_report();
+#endif
+    if (zk_output_commit)
+        zk_output_commit();
+}
+
 __attribute__((noreturn))
 void
 __wrap_exit(int code)
 {
+#if ZKVM_PROFILE
+    zk_prof_dump();
+#endif
+    zkvm_commit_output();
     zkvm_raw_exit(code);
 }
 
@@ -501,6 +1617,7 @@ __attribute__((noreturn))
 void
 __wrap__Exit(int code)
 {
+    zkvm_commit_output();
     zkvm_raw_exit(code);
 }
 
@@ -508,6 +1625,7 @@ __attribute__((noreturn))
 void
 __wrap_abort(void)
 {
+    zkvm_commit_output();
     zkvm_raw_exit(134); /* 128 + SIGABRT, conventional abort exit code */
 }
 
@@ -516,12 +1634,6 @@ int RhIsGCBridgeActive(void)
     return 0;
 }
 
-int
-__wrap___stdio_write(int fd, const void *buf, int count)
-{
-    return -1;
-}
-
 int
 __wrap_sysconf(int n)
 {
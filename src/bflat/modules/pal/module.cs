@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief Managed surface of the PAL heap: scoped arenas on top of
+ *        zk_heap_mark() / zk_heap_reset()
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ */
+using System.Runtime.InteropServices;
+
+namespace Bflat.Zkvm
+{
+    /// <summary>
+    /// A heap scope: everything allocated between <see cref="Enter"/> and
+    /// <see cref="Dispose"/> is released at once by rewinding the bump
+    /// allocator, e.g. per transaction in a multi-transaction block.
+    /// </summary>
+    /// <remarks>
+    /// Scopes nest. Disposing an outer scope also closes any inner scope that
+    /// is still open; disposing twice is a no-op. Nothing allocated inside the
+    /// scope may be referenced after it is disposed - under zisk_sim, run with
+    /// <c>ZKVM_HEAP_DEBUG=1</c> to make such stale references fault.
+    /// </remarks>
+    public ref struct ZkArena
+    {
+        // depth + 1, so that default(ZkArena) is an inert scope
+        private int _token;
+
+        public static ZkArena Enter()
+        {
+            int depth = zk_arena_enter();
+            if (depth < 0)
+                throw new System.InvalidOperationException("ZkArena nesting is too deep");
+            return new ZkArena { _token = depth + 1 };
+        }
+
+        public void Dispose()
+        {
+            if (_token != 0)
+            {
+                zk_arena_leave(_token - 1);
+                _token = 0;
+            }
+        }
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern int zk_arena_enter();
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_arena_leave(int depth);
+    }
+}
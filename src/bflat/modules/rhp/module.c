@@ -8,6 +8,7 @@
  * @author Maxim Menshikov <maksim.menshikov@nethermind.io>
  */
 #include <inttypes.h>
+#include <setjmp.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -17,14 +18,6 @@
 
 #define _DEBUG (0)
 
-/* zkVM RAM is zero-initialised and the bump allocator never reuses memory,
- * so a freshly malloc'd block is already all-zero. ZKVM_FAST_ALLOC=1
- * (default) drops the redundant per-object/array memset; set to 0 to
- * restore the explicit zeroing. Kept in sync with pal/module.c. */
-#ifndef ZKVM_FAST_ALLOC
-#define ZKVM_FAST_ALLOC 1
-#endif
-
 /* RhpPInvoke / RhpPInvokeReturn build and tear down a PInvokeTransitionFrame
  * so the GC can scan/suspend a thread that has entered native code. The
  * zkVM guest is single-threaded, uGC never collects (so threads are never
@@ -36,6 +29,19 @@
 #define ZKVM_STUB_PINVOKE 1
 #endif
 
+/* Allocation-profiling flavour (module.profile.o): every allocator below
+ * reports its MethodTable, size and managed call site to pal's profiler. */
+#ifndef ZKVM_PROFILE
+#define ZKVM_PROFILE 0
+#endif
+
+#if ZKVM_PROFILE
+extern void zk_prof_record(const void *methodTable, size_t bytes, const void *site);
+#define ZK_PROF_RECORD(mt, bytes) zk_prof_record((mt), (bytes), __builtin_return_address(0))
+#else
+#define ZK_PROF_RECORD(mt, bytes) ((void)0)
+#endif
+
 #if ZKVM_STUB_PINVOKE
 void
 __wrap_RhpPInvoke(void *pFrame)
@@ -85,7 +91,12 @@ extern int __real_S_P_CoreLib_System_Threading_ProcessorIdCache__ProcessorNumber
 /* __wrap_RhpNewFast moved to pal/module.c so the downward bump allocator is
  * inlined directly into it (same translation unit as `mem` and the heap
  * bounds): no nested malloc call, single alignment step, leaf function.
- * --wrap=RhpNewFast (rhp/module_params.yml) still redirects callers there. */
+ * --wrap=RhpNewFast (rhp/module_params.yml) still redirects callers there.
+ *
+ * The allocators below take their memory from pal's zk_alloc_object(): the
+ * header-less managed-object path, which hands out zeroed blocks and is
+ * inlined under LTO. */
+extern void *zk_alloc_object(size_t bytes);
 
 void *
 __wrap_RhpNewObject(void *methodTable, int allocFlags)
@@ -105,14 +116,12 @@ __wrap_RhpNewObject(void *methodTable, int allocFlags)
     /* Align allocation size to 8 bytes */
     total = (total + 7u) & ~(size_t)7u;
 
-    void *obj = malloc(total);
-#if !ZKVM_FAST_ALLOC
-    if (obj) __builtin_memset(obj, 0, total);
-#endif
+    void *obj = zk_alloc_object(total);
     if (!obj)
         return 0;
 
     *(void **)((uint8_t *)obj + OBJ_EETYPE_OFFSET) = methodTable;
+    ZK_PROF_RECORD(methodTable, total);
     return obj;
 }
 
@@ -161,33 +170,32 @@ __wrap_RhpNewPtrArrayFast(void *methodTable, unsigned long numElements)
 {
     size_t total = (size_t)SZARRAY_BASE_SIZE + ((size_t)numElements << 3);
 
-    void *obj = malloc(total);
-#if !ZKVM_FAST_ALLOC
-    if (obj) __builtin_memset(obj, 0, total);
-#endif
+    void *obj = zk_alloc_object(total);
     if (!obj)
         return 0;
 
     init_object_header(obj, methodTable);
     init_array_length(obj, numElements);
+    ZK_PROF_RECORD(methodTable, total);
     return obj;
 }
 
 void *
 __wrap_RhpNewArrayFast(void *methodTable, unsigned long numElements)
 {
+    /* The MethodTable's base size, not SZARRAY_BASE_SIZE: multi-dimensional
+     * arrays carry their bounds in it, and the zkgc heap walk sizes every
+     * object from its MethodTable exactly like this. */
     size_t comp = (size_t)mt_component_size(methodTable);
-    size_t total = align_up_8((size_t)SZARRAY_BASE_SIZE + ((size_t)numElements * comp));
+    size_t total = align_up_8((size_t)mt_base_size(methodTable) + ((size_t)numElements * comp));
 
-    void *obj = malloc(total);
-#if !ZKVM_FAST_ALLOC
-    if (obj) __builtin_memset(obj, 0, total);
-#endif
+    void *obj = zk_alloc_object(total);
     if (!obj)
         return 0;
 
     init_object_header(obj, methodTable);
     init_array_length(obj, numElements);
+    ZK_PROF_RECORD(methodTable, total);
     return obj;
 }
 
@@ -196,24 +204,74 @@ __wrap_RhNewString(void *methodTable, unsigned long numElements)
 {
     size_t total = align_up_8((size_t)STRING_BASE_SIZE + ((size_t)numElements * (size_t)STRING_COMPONENT_SIZE));
 
-    void *obj = malloc(total);
-#if !ZKVM_FAST_ALLOC
-    if (obj) __builtin_memset(obj, 0, total);
-#endif
+    void *obj = zk_alloc_object(total);
     if (!obj)
         return 0;
 
     init_object_header(obj, methodTable);
     init_array_length(obj, numElements);
+    ZK_PROF_RECORD(methodTable, total);
     return obj;
 }
 
+/*
+ * Cast cache. CheckCastAny(targetType, obj) returns obj or throws, so only
+ * successful casts are remembered: a direct-mapped table of
+ * (source MethodTable, target MethodTable) pairs. MethodTables never move and
+ * the guest has one thread, so a slot is just two words and the index is a
+ * pure function of the pair - the same casts hit on every run.
+ */
+#define CAST_CACHE_ENTRIES 1024u /* power of two */
+
+typedef struct CastCacheEntry
+{
+    const void *source;
+    const void *target;
+} CastCacheEntry;
+
+static CastCacheEntry g_cast_cache[CAST_CACHE_ENTRIES];
+
+#if ZKVM_PROFILE
+/* Reported by pal's zk_prof_dump() at exit. */
+uint64_t zk_prof_cast_hits;
+uint64_t zk_prof_cast_misses;
+#endif
+
+static inline uint32_t
+cast_cache_index(const void *source, const void *target)
+{
+    uint64_t h = ((uintptr_t)source >> 3) ^ ((uintptr_t)target << 7);
+    return (uint32_t)((h * 0x9E3779B97F4A7C15ull) >> 54) & (CAST_CACHE_ENTRIES - 1u);
+}
+
 void **
 __wrap_S_P_CoreLib_System_Runtime_TypeCast__CheckCastAny(
     unsigned int *param_1, unsigned int **param_2)
 {
-    return S_P_CoreLib_System_Runtime_TypeCast__CheckCastAny_NoCacheLookup(
+    if (param_2 == NULL)
+        return NULL;
+
+    const void     *source = *(void **)param_2;
+    CastCacheEntry *entry  = &g_cast_cache[cast_cache_index(source, param_1)];
+
+    if (entry->source == source && entry->target == param_1)
+    {
+#if ZKVM_PROFILE
+        zk_prof_cast_hits++;
+#endif
+        return (void **)param_2;
+    }
+
+#if ZKVM_PROFILE
+    zk_prof_cast_misses++;
+#endif
+    /* Throws InvalidCastException on failure, so reaching the store means
+     * the cast succeeded. */
+    void **result = S_P_CoreLib_System_Runtime_TypeCast__CheckCastAny_NoCacheLookup(
         param_1, param_2);
+    entry->source = source;
+    entry->target = param_1;
+    return result;
 }
 
 void
@@ -256,12 +314,6 @@ typedef struct ThreadStaticStorageLite
 
 static ThreadStaticStorageLite g_thread_static_storage = { 0 };
 
-/* Optional backing store for other custom thread-static emulation (not returned directly). */
-#define THREAD_STATIC_STORAGE_SIZE (256 * 1024)
-static uint8_t thread_static_storage[THREAD_STATIC_STORAGE_SIZE]
-    __attribute__((aligned(64))) = { 0 };
-static uint8_t *thread_static_ptr = thread_static_storage;
-
 /*
  * Wrapper for RhGetThreadStaticStorage - returns a pointer to the storage struct
  * with the managed array reference at offset 0.
@@ -272,112 +324,124 @@ __wrap_RhGetThreadStaticStorage(void)
     return &g_thread_static_storage;
 }
 
-#define TSS_MAX_TYPEMANAGERS 32
-#define TSS_MAX_SLOTS        256
+/*
+ * Thread statics.
+ *
+ * There is one thread, so every type's thread-static base is a single object
+ * for the whole run. The first access to a type manager lays out all of its
+ * bases at once: the ThreadStaticRegion section the compiler emitted lists
+ * the MethodTable of each type's base in slot order, so the slot table is
+ * sized exactly from it and each base is laid out as a proper object of that
+ * type. From then on a lookup is two bounds checks and two loads.
+ *
+ * The slot tables and the bases live in a static .bss pool, never on the
+ * heap: zk_heap_reset() and ZkArena rewind the heap, and a base taken from it
+ * would be handed out again while thread statics still point into it. The
+ * pool is in the collector's static root range, so references held in thread
+ * statics keep their objects alive. Raise TSS_STORAGE_BYTES if a program has
+ * more thread statics than it holds.
+ */
+#define TSS_MAX_TYPEMANAGERS          32
+#define READYTORUN_THREAD_STATIC_REGION 202
 
-typedef struct ThreadStaticsKeyedStore
-{
-    void   *slots[TSS_MAX_SLOTS];
-} ThreadStaticsKeyedStore;
+#ifndef TSS_STORAGE_BYTES
+#define TSS_STORAGE_BYTES (64u * 1024u)
+#endif
 
-static ThreadStaticsKeyedStore g_tss_by_type_manager[TSS_MAX_TYPEMANAGERS];
+static uint64_t g_tss_storage[TSS_STORAGE_BYTES / sizeof(uint64_t)];
+static size_t   g_tss_storage_used;
 
-static inline uint32_t
-tss_read_u32(const void *p)
+/* Zeroed .bss memory, 8-byte aligned; never released. Running out is fatal:
+ * a missing base would have managed code use a near-null address. */
+static void *
+tss_storage_alloc(size_t bytes)
 {
-    return *(const volatile uint32_t *)p;
+    bytes = align_up_8(bytes);
+    if (bytes > sizeof(g_tss_storage) - g_tss_storage_used)
+    {
+        printf("[TSS] out of thread-static storage (TSS_STORAGE_BYTES=%u)\n",
+               (unsigned)TSS_STORAGE_BYTES);
+        exit(1);
+    }
+
+    void *p = (uint8_t *)g_tss_storage + g_tss_storage_used;
+    g_tss_storage_used += bytes;
+    return p;
 }
 
-static inline size_t
-tss_align_up(size_t x, size_t a)
+extern void *RhGetModuleSection(void *typeManager, int32_t headerId, int32_t *length);
+
+typedef struct ThreadStaticsTable
 {
-    return (x + (a - 1u)) & ~(a - 1u);
-}
+    void   **bases; /* slot -> thread-static base object */
+    uint32_t count;
+} ThreadStaticsTable;
 
-#define TSS_SLOT_BYTES 256
+static ThreadStaticsTable g_tss_by_type_manager[TSS_MAX_TYPEMANAGERS];
 
-void *_param_1 = 0;
-void *_param_2 = 0;
-uint32_t _typeManagerIndex = 0;
-uint32_t rhp_tss_counter = 0;
+/* TypeManagerSlot: { TypeManagerHandle TypeManager; int32_t ModuleIndex; } */
+typedef struct TypeManagerSlot
+{
+    void    *typeManager;
+    int32_t  moduleIndex;
+} TypeManagerSlot;
 
-long __wrap_S_P_CoreLib_Internal_Runtime_ThreadStatics__GetUninlinedThreadStaticBaseForType(void *param_1, void *param_2)
+static __attribute__((noinline)) ThreadStaticsTable *
+tss_layout(const TypeManagerSlot *module)
 {
-    /* typeManagerIndex is read from param_1 + 8 (matches lw s3,8(s2) in disassembly) */
-    uint32_t typeManagerIndex = 0;
-    if (param_1 != NULL)
-        typeManagerIndex = tss_read_u32((const uint8_t *)param_1 + 8);
+    ThreadStaticsTable *table = &g_tss_by_type_manager[module->moduleIndex];
+    int32_t length = 0;
+    void  **region = (void **)RhGetModuleSection(module->typeManager,
+                                                 READYTORUN_THREAD_STATIC_REGION, &length);
+    uint32_t count = region != NULL && length > 0 ? (uint32_t)length / sizeof(void *) : 0;
 
-    /* slot index comes in param_2; treat it as a 32-bit signed/unsigned index */
-    uintptr_t slotU = (uintptr_t)param_2;
-    uint32_t slot = (uint32_t)slotU;
+    if (count == 0)
+        return table;
 
-#if _DEBUG
-    printf("[TSS] GetTSBase(typeMgr=%u, slot=%u) param_1=%p param_2=%p\n",
-           (unsigned)typeManagerIndex, (unsigned)slot, param_1, param_2);
-#endif
+    void **bases = tss_storage_alloc(count * sizeof(void *));
 
-    if (typeManagerIndex >= TSS_MAX_TYPEMANAGERS || slot >= TSS_MAX_SLOTS)
+    for (uint32_t i = 0; i < count; i++)
     {
-#if _DEBUG
-        printf("[TSS] WARN: out of bounds (typeMgr=%u/%u slot=%u/%u)\n",
-               (unsigned)typeManagerIndex, (unsigned)TSS_MAX_TYPEMANAGERS,
-               (unsigned)slot, (unsigned)TSS_MAX_SLOTS);
-#endif
-        return 0;
-    }
+        void  *mt    = region[i];
+        size_t total = mt_base_size(mt);
 
-    if (param_1 != _param_1 || param_2 != _param_2 ||
-        typeManagerIndex != _typeManagerIndex)
-    {
-        rhp_tss_counter = 0;
-        _param_1 = param_1;
-        _param_2 = param_2;
-        _typeManagerIndex = typeManagerIndex;
+        if (total < 0x18)
+            total = 0x18;
+        bases[i] = tss_storage_alloc(total);
+        init_object_header(bases[i], mt);
     }
 
-    rhp_tss_counter++;
 #if _DEBUG
-    if (rhp_tss_counter > 5000)
-    {
-        printf("[TSS] WARN: too many calls (typeMgr=%u/%u slot=%u/%u)\n",
-               (unsigned)typeManagerIndex, (unsigned)TSS_MAX_TYPEMANAGERS,
-               (unsigned)slot, (unsigned)TSS_MAX_SLOTS);
-        int *i = NULL;
-        *i = 0;
-    }
+    printf("[TSS] typeMgr=%d: %u thread-static bases\n", module->moduleIndex, (unsigned)count);
 #endif
+    table->bases = bases;
+    table->count = count;
+    return table;
+}
 
+long __wrap_S_P_CoreLib_Internal_Runtime_ThreadStatics__GetUninlinedThreadStaticBaseForType(void *param_1, void *param_2)
+{
+    const TypeManagerSlot *module = (const TypeManagerSlot *)param_1;
+    uint32_t               slot   = (uint32_t)(uintptr_t)param_2;
 
-    void *p = g_tss_by_type_manager[typeManagerIndex].slots[slot];
-    if (p != NULL)
-        return (long)p;
-
-    /* Allocate from our backing store and zero-init */
-    size_t need = tss_align_up((size_t)TSS_SLOT_BYTES, 16);
-
-    if ((size_t)(thread_static_storage + THREAD_STATIC_STORAGE_SIZE - thread_static_ptr) < need)
+    if ((uint32_t)module->moduleIndex >= TSS_MAX_TYPEMANAGERS)
     {
-#if _DEBUG
-        printf("[TSS] OOM: backing store exhausted (need=%zu left=%zu)\n",
-               need,
-               (size_t)(thread_static_storage + THREAD_STATIC_STORAGE_SIZE - thread_static_ptr));
-#endif
-        return 0;
+        printf("[TSS] type manager %d is past TSS_MAX_TYPEMANAGERS=%d\n",
+               module->moduleIndex, TSS_MAX_TYPEMANAGERS);
+        exit(1);
     }
 
-    p = (void *)thread_static_ptr;
-    thread_static_ptr += need;
-
-    memset(p, 0, need);
-
-    g_tss_by_type_manager[typeManagerIndex].slots[slot] = p;
-#if _DEBUG
-    printf("[TSS] Alloc slot: typeMgr=%u slot=%u -> %p (bytes=%zu) next=%p\n",
-           (unsigned)typeManagerIndex, (unsigned)slot, p, need, (void *)thread_static_ptr);
-#endif
+    ThreadStaticsTable *table = &g_tss_by_type_manager[module->moduleIndex];
+    if (table->bases == NULL)
+        table = tss_layout(module);
 
-    return (long)p;
+    if (slot >= table->count)
+    {
+        printf("[TSS] slot %u out of range (typeMgr=%d has %u)\n",
+               (unsigned)slot, module->moduleIndex, (unsigned)table->count);
+        exit(1);
+    }
+    return (long)table->bases[slot];
 }
 
 void __wrap__Z16InitializeCGroupv(void)
@@ -478,11 +542,6 @@ void __wrap_SystemNative_SetTerminalInvalidationHandler(void *param)
 {
 }
 
-int __wrap_SystemNative_Write(int fd, const void* buffer, int bufferSize)
-{
-    return bufferSize;
-}
-
 extern void *S_P_CoreLib_System_Number__UInt32ToDecStr_NoSmallNumberCheck(int value);
 
 void *__wrap_S_P_CoreLib_System_Number__UInt32ToDecStrForKnownSmallNumber(int value)
@@ -509,9 +568,46 @@ __wrap_RhpReversePInvokeReturn(void *pFrame)
     (void)pFrame;
 }
 
+/*
+ * Table-free try/catch. The EH tables are stripped from zkVM binaries
+ * (the postprocessor drops .eh_frame), so the runtime cannot find a catch funclet.
+ * Instead, Bflat.Zkvm.ZkTry runs its body under zk_eh_try(), which pushes a
+ * jmp_buf onto a chain; a throw longjmps straight back to the innermost one
+ * with the exception object. Everything between the throw and that frame is
+ * dropped without running finally blocks - there is one thread, no lock to
+ * release and no collection that could see the abandoned frames.
+ */
+struct zk_eh_frame
+{
+    jmp_buf             env;
+    struct zk_eh_frame *prev;
+    void               *exception;
+};
+
+static struct zk_eh_frame *g_zk_eh_top;
+
+/* Runs body(state); returns the object it threw, or NULL. */
+void *
+zk_eh_try(void (*body)(void *), void *state)
+{
+    struct zk_eh_frame frame;
+
+    frame.prev = g_zk_eh_top;
+    frame.exception = NULL;
+    if (setjmp(frame.env) == 0)
+    {
+        g_zk_eh_top = &frame;
+        body(state);
+    }
+    g_zk_eh_top = frame.prev;
+    /* Stored by the thrower after setjmp(): read it back from memory. */
+    return *(void *volatile *)&frame.exception;
+}
+
 /* RhpThrowEx receives the managed exception object in a0 (first arg register).
- * Instead of a blind fail-fast, hand that object to a managed handler that the
- * user program may export as [UnmanagedCallersOnly(EntryPoint = "ZkvmThrow")].
+ * The innermost zk_eh_try() frame catches it. Failing that, hand the object to
+ * a managed handler that the user program may export as
+ * [UnmanagedCallersOnly(EntryPoint = "ZkvmThrow")].
  * The reference is weak: programs that don't define ZkvmThrow link fine and
  * fall back to exit(1), so existing binaries keep their old behaviour. A
  * program that does define it takes full control of the throw — the wrapper
@@ -520,6 +616,13 @@ extern void ZkvmThrow(void *exceptionObj) __attribute__((weak));
 
 void __wrap_RhpThrowEx(void *exceptionObj)
 {
+    struct zk_eh_frame *frame = g_zk_eh_top;
+
+    if (frame != NULL)
+    {
+        frame->exception = exceptionObj;
+        longjmp(frame->env, 1);
+    }
     if (ZkvmThrow != NULL)
     {
         ZkvmThrow(exceptionObj);
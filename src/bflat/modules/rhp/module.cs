@@ -0,0 +1,69 @@
+/**
+ * @file
+ * @brief Managed surface of the table-free exception handler chain
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ */
+using System;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace Bflat.Zkvm
+{
+    /// <summary>
+    /// try/catch for zkVM binaries, which carry no EH tables. A regular
+    /// <c>catch</c> never runs there; an exception thrown inside a
+    /// <see cref="ZkTry"/> body is caught by the innermost enclosing call.
+    /// </summary>
+    /// <remarks>
+    /// On a throw, control jumps straight back to the <see cref="ZkTry"/>
+    /// call: <c>finally</c> blocks and <c>using</c> disposals between the
+    /// throw and that call do not run, and any <see cref="ZkArena"/> opened
+    /// in the body stays open until an enclosing scope is disposed. A throw
+    /// outside every <see cref="ZkTry"/> body still goes to <c>ZkvmThrow</c>,
+    /// or ends the program.
+    /// </remarks>
+    public static unsafe class ZkTry
+    {
+        /// <summary>
+        /// Runs <paramref name="body"/>. Returns the exception it threw, or
+        /// null if it completed.
+        /// </summary>
+        public static Exception Run(Action body)
+        {
+            ArgumentNullException.ThrowIfNull(body);
+            IntPtr thrown = zk_eh_try(&Invoke, Unsafe.As<Action, IntPtr>(ref body));
+            GC.KeepAlive(body);
+            return Unsafe.As<IntPtr, Exception>(ref thrown);
+        }
+
+        /// <summary>
+        /// Runs <paramref name="body"/>; a <typeparamref name="TException"/>
+        /// it throws goes to <paramref name="handler"/>, anything else is
+        /// thrown on to the enclosing <see cref="ZkTry"/>. Returns whether
+        /// the body completed.
+        /// </summary>
+        public static bool Run<TException>(Action body, Action<TException> handler) where TException : Exception
+        {
+            ArgumentNullException.ThrowIfNull(handler);
+            Exception thrown = Run(body);
+            if (thrown == null)
+                return true;
+            if (thrown is not TException matched)
+                throw thrown;
+            handler(matched);
+            return false;
+        }
+
+        [UnmanagedCallersOnly]
+        private static void Invoke(IntPtr body) => Unsafe.As<IntPtr, Action>(ref body)();
+
+        // zk_eh_try calls back into Invoke, an [UnmanagedCallersOnly] method,
+        // without a GC transition around it. That is only valid because this
+        // runtime's RhpReversePInvoke and RhpReversePInvokeReturn are no-ops
+        // (rhp/module.c); if they ever transition for real, drop
+        // SuppressGCTransition here.
+        [DllImport("*"), SuppressGCTransition]
+        private static extern IntPtr zk_eh_try(delegate* unmanaged<IntPtr, void> body, IntPtr state);
+    }
+}
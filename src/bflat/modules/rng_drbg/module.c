@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @brief Deterministic word-wide random generator with OpenSSL stub.
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ *
+ * @author Maxim Menshikov <maksim.menshikov@nethermind.io>
+ */
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+/* sim flavour (module.sim.o): ZKVM_RNG_SEED in the environment seeds the
+ * generator at first use. */
+#ifndef ZKVM_SIM
+#define ZKVM_SIM 0
+#endif
+
+/*
+ * xoshiro256** (Blackman & Vigna). Every step yields a full 64-bit word from
+ * shifts, rotates and two small multiplies, so filling a buffer costs one step
+ * per 8 bytes instead of one LCG step (and a divide) per byte.
+ *
+ * The stream is a pure function of the seed: the default seed keeps runs
+ * bit-for-bit reproducible, and zk_rng_seed() lets the guest derive it from
+ * its input so it can differ per proof. None of this is cryptographically
+ * secure - there is no entropy in a zkVM to begin with.
+ */
+#define ZK_RNG_DEFAULT_SEED 0x34095153u
+
+static uint64_t g_rng_state[4];
+static int      g_rng_seeded;
+
+static inline uint64_t
+rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/* splitmix64 spreads a single seed word over the 256-bit state, so nearby
+ * seeds still give unrelated streams and the state is never all zero. */
+static inline uint64_t
+splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void
+zk_rng_seed(uint64_t seed)
+{
+    for (int i = 0; i < 4; i++)
+        g_rng_state[i] = splitmix64(&seed);
+    g_rng_seeded = 1;
+}
+
+#if ZKVM_SIM
+#include <stdlib.h>
+
+/* pal's reader for the real process environment. */
+extern const char *zk_sim_getenv(const char *name);
+#endif
+
+static __attribute__((noinline)) void
+rng_seed_default(void)
+{
+    uint64_t seed = ZK_RNG_DEFAULT_SEED;
+#if ZKVM_SIM
+    const char *v = zk_sim_getenv("ZKVM_RNG_SEED");
+    if (v != NULL && v[0] != '\0')
+        seed = strtoull(v, NULL, 0);
+#endif
+    zk_rng_seed(seed);
+}
+
+static inline uint64_t
+rng_next(void)
+{
+    uint64_t *s      = g_rng_state;
+    uint64_t  result = rotl(s[1] * 5, 7) * 9;
+    uint64_t  t      = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+static void
+rng_fill(unsigned char *buffer, size_t length)
+{
+    if (__builtin_expect(!g_rng_seeded, 0))
+        rng_seed_default();
+
+    /* Whole words go straight out; memcpy keeps unaligned buffers legal and
+     * lowers to a single store where the buffer is aligned. */
+    while (length >= sizeof(uint64_t))
+    {
+        uint64_t word = rng_next();
+        memcpy(buffer, &word, sizeof(word));
+        buffer += sizeof(word);
+        length -= sizeof(word);
+    }
+
+    if (length != 0)
+    {
+        uint64_t word = rng_next();
+        memcpy(buffer, &word, length);
+    }
+}
+
+int
+__wrap_minipal_get_cryptographically_secure_random_bytes(unsigned char *buffer, int bufferLength)
+{
+    if (bufferLength > 0)
+        rng_fill(buffer, (size_t)bufferLength);
+    return 0;
+}
+
+int
+__wrap_CryptoNative_EnsureOpenSslInitialized(void)
+{
+    return 0;
+}
+
+int
+__wrap_CryptoNative_GetRandomBytes(unsigned char *buffer, int length)
+{
+    if (length > 0)
+        rng_fill(buffer, (size_t)length);
+    return 1;
+}
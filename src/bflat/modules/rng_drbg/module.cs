@@ -0,0 +1,31 @@
+/**
+ * @file
+ * @brief Managed surface of the deterministic random generator
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ */
+using System.Runtime.InteropServices;
+
+namespace Bflat.Zkvm
+{
+    /// <summary>
+    /// Controls the generator behind every "secure" random source of the
+    /// guest (hash seeds, <c>Guid.NewGuid</c>, <c>Random.Shared</c>,
+    /// <c>RandomNumberGenerator</c>). Its output is a pure function of the
+    /// seed, so a run is reproducible for a given seed.
+    /// </summary>
+    /// <remarks>
+    /// Without a call to <see cref="Seed"/> the generator starts from a fixed
+    /// seed (under zisk_sim, <c>ZKVM_RNG_SEED</c> in the environment overrides
+    /// it). Seeding restarts the stream, so values drawn earlier - including
+    /// seeds the runtime captured during startup - are not affected. Derive the
+    /// seed from the guest input to make it vary per proof.
+    /// </remarks>
+    public static class ZkRandom
+    {
+        public static void Seed(ulong seed) => zk_rng_seed(seed);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_rng_seed(ulong seed);
+    }
+}
@@ -1,37 +0,0 @@
-/**
- * @file
- * @brief Trivial RNG implementation with OpenSSL stub.
- *
- * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
- *
- * @author Maxim Menshikov <maksim.menshikov@nethermind.io>
- */
-static unsigned long _next = 0x34095153;
-
-static unsigned long get_val(void)
-{
-    _next = _next * 1103515243 + 12345;
-    return (unsigned long)(_next / 65536) % 32768;
-}
-
-int
-__wrap_minipal_get_cryptographically_secure_random_bytes(unsigned char *buffer, int bufferLength)
-{
-    for (int i = 0; i < bufferLength; i++)
-        buffer[i] = (unsigned char)(get_val() % 0x100);
-    return 0;
-}
-
-int
-__wrap_CryptoNative_EnsureOpenSslInitialized(void)
-{
-    return 0;
-}
-
-int
-__wrap_CryptoNative_GetRandomBytes(unsigned char *buffer, int length)
-{
-    for (int i = 0; i < length; i++)
-        buffer[i] = (unsigned char)(get_val() % 0x100);
-    return 1;
-}
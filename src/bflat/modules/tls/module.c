@@ -9,104 +9,61 @@
  */
 #include <inttypes.h>
 #include <stddef.h>
-#include <string.h>
-
-/* Constants from musl. Weird, in fact must be inferred automatically. */
-#define HEAP_SIZE       (100 * 1024)
-#define PTHREAD_SIZE    (200)
-#define TLS_SIZE        (2 * sizeof(void *) + PTHREAD_SIZE)
-#define TLS_CNT         (1)
-#define TLS_ALIGN       (4)
-
-static uint8_t  tls_storage_static[HEAP_SIZE]
-    __attribute__((aligned(64)));
 
 /*
- * tls_base points to the actual TLS data area (after pthread data).
- * tp points to the pthread data area (start of our TLS block).
+ * There is one thread, so there is one TLS block, and the zkvm linker
+ * scripts lay it out in place:
+ *
+ *   __tls_tcb  .. __tls_tp            musl's struct pthread for the thread
+ *   __tls_tp   .. + __tdata_len       .tdata, already holding its image
+ *              .. + __tbss_len        .tbss, zero RAM at boot
+ *
+ * __tls_tp is the start of the PT_TLS segment, which is where RISC-V's
+ * variant I TLS puts the thread pointer. The linker resolves local-exec and
+ * initial-exec accesses to offsets from tp against that very address, so
+ * tp = __tls_tp is the whole setup: no copy, no buffer, no lazy check. The
+ * block is exactly as large as the sections in it.
  *
- * These are initialized lazily on first access to ensure they're valid
- * even if __tls_get_addr is called before __init_tls.
+ * _start loads tp before anything runs; __init_tls sets it again so musl's
+ * own bookkeeping matches.
  */
-static uint8_t *tls_base = NULL;
-static uint8_t *tp = NULL;
-static volatile int tls_initialized = 0;
+#define PTHREAD_SIZE    (200) /* upper bound of musl's struct pthread */
 
-extern uint8_t  __tdata_load[] __attribute__((weak));
-extern const char __tdata_len[] __attribute__((weak));
-extern const char __tbss_len[] __attribute__((weak));
+extern uint8_t __tls_tp[];
 
 extern int __set_thread_area(void *tp);
 
-/*
- * Internal function to ensure TLS is initialized.
- * Can be called multiple times safely.
- * This function is designed to be safe to call from any context.
- */
-extern
-void
-ensure_tls_initialized(void)
-{
-    /* Quick check without memory barrier for performance */
-    if (tls_initialized)
-        return;
-
-    /* Set up the pointers first - this is safe even if called concurrently
-     * since we're always setting them to the same values */
-    tp = tls_storage_static;
-    tls_base = tls_storage_static + PTHREAD_SIZE;
-
-    uintptr_t tdata_len = (uintptr_t)__tdata_len;
-    uintptr_t tbss_len = (uintptr_t)__tbss_len;
-
-    /*
-     * Copy initial TLS data if present (.tdata section).
-     * This contains initialized thread-local variables.
-     */
-    if (tdata_len != 0 && __tdata_load != NULL)
-        memcpy(tls_base, __tdata_load, tdata_len);
-
-    /*
-     * Zero-initialize .tbss area (uninitialized thread-local variables).
-     * The storage is already zeroed since it's in .data section, but we
-     * do this explicitly for correctness.
-     */
-    if (tbss_len != 0)
-        memset(tls_base + tdata_len, 0, tbss_len);
-
-    /* Mark as initialized */
-    tls_initialized = 1;
-}
-
 uint8_t
 __wrap___init_tp(void *p)
 {
-    __set_thread_area(p + PTHREAD_SIZE);
+    (void)p;
+    __set_thread_area(__tls_tp);
     return 0;
 }
 
 uint8_t *
 __wrap___copy_tls(uint8_t *mem)
 {
-    /* Ensure TLS data is initialized */
-    ensure_tls_initialized();
-    return tp;
+    (void)mem;
+    return __tls_tp - PTHREAD_SIZE;
 }
 
 void
 __wrap___init_tls(size_t *aux)
 {
-    ensure_tls_initialized();
-    __wrap___init_tp(__wrap___copy_tls(tp));
+    (void)aux;
+    __wrap___init_tp(__wrap___copy_tls(NULL));
 }
 
+/* General-dynamic accesses from objects built for shared linking still come
+ * here; with the block at tp this is one load and one add, with no branch
+ * on the fast path. */
 void *
 __wrap___tls_get_addr(size_t *v)
 {
-    if (tls_base == NULL)
-        ensure_tls_initialized();
+    uint8_t *tls_base = __builtin_thread_pointer();
 
-    if (v != NULL)
-        return (void*)(tls_base + v[1]);
-    return tls_base;
+    if (__builtin_expect(v == NULL, 0))
+        return tls_base;
+    return (void *)(tls_base + v[1]);
 }
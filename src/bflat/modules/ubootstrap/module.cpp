@@ -105,6 +105,57 @@ extern "C" void InitializeModules(void* osModule, void ** modules, int count,
 #define NATIVEAOT_ENTRYPOINT __managed__Main
 extern "C" int __managed__Main(int argc, char* argv[]);
 
+/* Eager class-constructor schedule, emitted by `bflat build --zkvm-eager-cctors`
+ * as a linker-script fragment. Each entry points at a type's
+ * StaticClassConstructionContext: a single word holding the cctor address,
+ * which reads as zero once the cctor has run. Weak, so binaries built without
+ * the schedule see an empty list. */
+extern "C" void **__start_zk_cctors[] __attribute__((weak));
+extern "C" void **__stop_zk_cctors[] __attribute__((weak));
+
+/* Table-free try from rhp; weak so that ubootstrap links without it. */
+extern "C" void *zk_eh_try(void (*body)(void *), void *state) __attribute__((weak));
+
+static void
+uBootstrap_CallClassConstructor(void *cctor)
+{
+    ((void (*)())cctor)();
+}
+
+/* Called by Bflat.Zkvm.ClassConstructorSchedule, a module initializer: the
+ * startup code runs it after the library initializers, the command-line
+ * arguments and the AppContext setup, so a cctor sees the same runtime state
+ * it would at first access. */
+extern "C" void
+uBootstrap_RunClassConstructors()
+{
+    for (void ***entry = __start_zk_cctors; entry < __stop_zk_cctors; entry++)
+    {
+        void **context = *entry;
+        void (*cctor)() = (void (*)())*context;
+
+        /* Already run, e.g. triggered by an earlier cctor in the list. */
+        if (cctor == nullptr)
+            continue;
+
+        /* Mark it done first, so an access to the type from inside its own
+         * cctor (or a cycle back to it) does not re-enter, as in the lazy
+         * path. */
+        *context = nullptr;
+        if (zk_eh_try == nullptr)
+        {
+            cctor();
+            continue;
+        }
+
+        /* A cctor that throws is put back: the type stays lazy, and the
+         * failure happens at its first access, where a lazy build would
+         * have seen it, instead of here outside every ZkTry. */
+        if (zk_eh_try(uBootstrap_CallClassConstructor, (void *)cctor) != nullptr)
+            *context = (void *)cctor;
+    }
+}
+
 extern "C" int
 uBootstrap_InitializeRuntime()
 {
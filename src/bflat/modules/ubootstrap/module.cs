@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @brief Runs the eager class-constructor schedule once the startup code has
+ *        set up the runtime
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ */
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+
+namespace Bflat.Zkvm
+{
+    /// <summary>
+    /// Runs the cctors <c>bflat build --zkvm-eager-cctors</c> scheduled.
+    /// Module initializers run after the library initializers, the
+    /// command-line arguments and the AppContext setup, right before Main;
+    /// without a schedule the list is empty and this does nothing.
+    /// </summary>
+    internal static class ClassConstructorSchedule
+    {
+        [ModuleInitializer]
+        internal static void Run() => uBootstrap_RunClassConstructors();
+
+        // The cctors are called straight from native code, as they would be
+        // from the startup path; RhpReversePInvoke is a no-op here anyway.
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void uBootstrap_RunClassConstructors();
+    }
+}
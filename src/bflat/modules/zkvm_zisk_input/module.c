@@ -0,0 +1,101 @@
+/**
+ * @file
+ * @brief Zero-copy access to the guest input.
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ *
+ * @author Maxim Menshikov <maksim.menshikov@nethermind.io>
+ */
+#include <inttypes.h>
+#include <stddef.h>
+
+/* sim flavour (module.sim.o): the input is a file named by ZKVM_INPUT in the
+ * environment, mapped read-only. */
+#ifndef ZKVM_SIM
+#define ZKVM_SIM 0
+#endif
+
+/*
+ * The ZisK prover maps the input read-only at INPUT_ADDR (zisk/core/src/
+ * mem.rs), as ziskos lays it out:
+ *
+ *   INPUT_ADDR + 0     reserved word
+ *   INPUT_ADDR + 8     u64 payload length
+ *   INPUT_ADDR + 16    payload
+ *
+ * The region is at most MAX_INPUT_SIZE long, which bounds the length word.
+ */
+#define ZISK_INPUT_ADDR     0x90000000ul
+#define ZISK_MAX_INPUT_SIZE 0x08000000ul
+#define ZISK_INPUT_HEADER   16u
+
+#if ZKVM_SIM
+#define ZK_SYS_CLOSE  57
+#define ZK_SYS_LSEEK  62
+#define ZK_SYS_OPENAT 56
+#define ZK_SYS_MMAP   222
+#define ZK_AT_FDCWD   (-100)
+#define ZK_SEEK_END   2
+#define ZK_PROT_READ  1
+#define ZK_MAP_PRIVATE 2
+
+/* pal's reader for the real process environment. */
+extern const char *zk_sim_getenv(const char *name);
+/* mmap and open are wrapped by pal, so go to the kernel directly. */
+extern long __real_syscall(long number, ...);
+
+static const uint8_t *g_input;
+static size_t         g_input_length;
+static int            g_input_loaded;
+
+static __attribute__((noinline)) void
+input_load(void)
+{
+    const char *path = zk_sim_getenv("ZKVM_INPUT");
+    long        fd;
+    long        size;
+    long        addr;
+
+    g_input_loaded = 1;
+    if (path == NULL || path[0] == '\0')
+        return;
+
+    fd = __real_syscall(ZK_SYS_OPENAT, ZK_AT_FDCWD, path, 0 /* O_RDONLY */);
+    if (fd < 0)
+        return;
+
+    size = __real_syscall(ZK_SYS_LSEEK, fd, 0, ZK_SEEK_END);
+    if (size > 0)
+    {
+        addr = __real_syscall(ZK_SYS_MMAP, 0, size, ZK_PROT_READ,
+            ZK_MAP_PRIVATE, fd, 0);
+        /* The kernel reports errors as -4095..-1. */
+        if ((unsigned long)addr < (unsigned long)-4095)
+        {
+            g_input = (const uint8_t *)addr;
+            g_input_length = (size_t)size;
+        }
+    }
+    __real_syscall(ZK_SYS_CLOSE, fd);
+}
+#endif
+
+/* The input payload, valid for the whole run; *length receives its size.
+ * No input gives a zero length. */
+const uint8_t *
+zk_input(size_t *length)
+{
+#if ZKVM_SIM
+    if (__builtin_expect(!g_input_loaded, 0))
+        input_load();
+    *length = g_input_length;
+    return g_input;
+#else
+    uint64_t size = *(const volatile uint64_t *)(ZISK_INPUT_ADDR + 8);
+
+    if (size > ZISK_MAX_INPUT_SIZE - ZISK_INPUT_HEADER)
+        size = ZISK_MAX_INPUT_SIZE - ZISK_INPUT_HEADER;
+    *length = (size_t)size;
+    return (const uint8_t *)(ZISK_INPUT_ADDR + ZISK_INPUT_HEADER);
+#endif
+}
@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @brief Managed surface of the guest input
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ */
+using System;
+using System.Runtime.InteropServices;
+
+namespace Bflat.Zkvm
+{
+    /// <summary>
+    /// The guest input, read in place. On zisk the span covers the prover's
+    /// memory-mapped input region; under zisk_sim it covers the file named by
+    /// <c>ZKVM_INPUT</c> in the environment, mapped read-only (no variable or
+    /// an unreadable file give an empty span).
+    /// </summary>
+    /// <remarks>
+    /// Nothing is copied: parse straight out of <see cref="Data"/> and copy
+    /// only what must outlive the parse or be modified. The memory stays
+    /// valid and unchanged for the whole run.
+    /// </remarks>
+    public static unsafe class ZkInput
+    {
+        /// <summary>The whole input payload.</summary>
+        public static ReadOnlySpan<byte> Data
+        {
+            get
+            {
+                nuint length;
+                byte* data = zk_input(&length);
+                return new ReadOnlySpan<byte>(data, checked((int)length));
+            }
+        }
+
+        /// <summary>Size of the input payload in bytes.</summary>
+        public static int Length
+        {
+            get
+            {
+                nuint length;
+                zk_input(&length);
+                return checked((int)length);
+            }
+        }
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern byte* zk_input(nuint* length);
+    }
+}
@@ -0,0 +1,224 @@
+/**
+ * @file
+ * @brief Buffered console text and public outputs.
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ *
+ * @author Maxim Menshikov <maksim.menshikov@nethermind.io>
+ */
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+/* sim flavour (module.sim.o): console text goes to the real stdout, public
+ * outputs to the file named by ZKVM_OUTPUT. */
+#ifndef ZKVM_SIM
+#define ZKVM_SIM 0
+#endif
+
+/*
+ * Console text (Console.Write, printf) collects in a RAM buffer that is
+ * emptied in one go when it fills up, on ZkOutput.Flush() and at exit:
+ *
+ *   zisk      byte stores to the UART register the emulator prints from
+ *   zisk_sim  one write(2) for the whole buffer
+ *
+ * Public outputs are 32-bit words, as the prover commits them. They are kept
+ * in RAM and published once at exit; on zisk that is the count word at
+ * OUTPUT_ADDR followed by the words, which is where ziskos' set_output puts
+ * them (zisk/core/src/mem.rs).
+ */
+#define ZK_CONSOLE_SIZE     (64u * 1024u)
+#define ZK_PUBLIC_WORDS     64u
+
+#define ZISK_UART_ADDR      0xa0000200ul
+#define ZISK_OUTPUT_ADDR    0xa0010000ul
+
+static uint8_t  g_console[ZK_CONSOLE_SIZE];
+static size_t   g_console_len;
+static uint32_t g_public[ZK_PUBLIC_WORDS];
+static size_t   g_public_bytes;
+
+#if ZKVM_SIM
+#define ZK_SYS_OPENAT  56
+#define ZK_SYS_CLOSE   57
+#define ZK_SYS_WRITE   64
+#define ZK_AT_FDCWD    (-100)
+#define ZK_O_WRONLY_CREAT_TRUNC (01 | 0100 | 01000)
+
+/* pal's reader for the real process environment. */
+extern const char *zk_sim_getenv(const char *name);
+/* pal wraps syscall(); this is the kernel's. */
+extern long __real_syscall(long number, ...);
+
+static void
+sim_write_all(long fd, const uint8_t *p, size_t n)
+{
+    while (n != 0)
+    {
+        long done = __real_syscall(ZK_SYS_WRITE, fd, p, n);
+        if (done <= 0)
+            return;
+        p += done;
+        n -= (size_t)done;
+    }
+}
+#endif
+
+static void
+console_drain(const uint8_t *p, size_t n)
+{
+#if ZKVM_SIM
+    sim_write_all(1, p, n);
+#else
+    volatile uint8_t *uart = (volatile uint8_t *)ZISK_UART_ADDR;
+    for (size_t i = 0; i < n; i++)
+        *uart = p[i];
+#endif
+}
+
+void
+zk_output_flush(void)
+{
+    if (g_console_len != 0)
+    {
+        console_drain(g_console, g_console_len);
+        g_console_len = 0;
+    }
+}
+
+void
+zk_output_write(const void *data, size_t length)
+{
+    const uint8_t *p = data;
+
+    if (g_console_len + length > ZK_CONSOLE_SIZE)
+    {
+        zk_output_flush();
+        /* Larger than the whole buffer: nothing to gain from copying. */
+        if (length > ZK_CONSOLE_SIZE)
+        {
+            console_drain(p, length);
+            return;
+        }
+    }
+    memcpy(g_console + g_console_len, p, length);
+    g_console_len += length;
+}
+
+/* Sets public output word `index`; the outputs extend to cover it. */
+int
+zk_output_set(uint32_t index, uint32_t value)
+{
+    if (index >= ZK_PUBLIC_WORDS)
+        return -1;
+    g_public[index] = value;
+    if (g_public_bytes < (index + 1u) * sizeof(uint32_t))
+        g_public_bytes = (index + 1u) * sizeof(uint32_t);
+    return 0;
+}
+
+/* Appends bytes to the public outputs, little-endian within each word. */
+int
+zk_output_publish(const void *data, size_t length)
+{
+    if (length > sizeof(g_public) - g_public_bytes)
+        return -1;
+    memcpy((uint8_t *)g_public + g_public_bytes, data, length);
+    g_public_bytes += length;
+    return 0;
+}
+
+/* Called by pal's exit paths: the last flush of the console, then the public
+ * outputs. */
+void
+zk_output_commit(void)
+{
+    size_t words = (g_public_bytes + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    zk_output_flush();
+#if ZKVM_SIM
+    const char *path = zk_sim_getenv("ZKVM_OUTPUT");
+    if (words != 0 && path != NULL && path[0] != '\0')
+    {
+        long fd = __real_syscall(ZK_SYS_OPENAT, ZK_AT_FDCWD, path,
+            ZK_O_WRONLY_CREAT_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            sim_write_all(fd, (const uint8_t *)g_public, words * sizeof(uint32_t));
+            __real_syscall(ZK_SYS_CLOSE, fd);
+        }
+    }
+#else
+    volatile uint32_t *out = (volatile uint32_t *)ZISK_OUTPUT_ADDR;
+    for (size_t i = 0; i < words; i++)
+        out[1 + i] = g_public[i];
+    if (words != 0)
+        out[0] = (uint32_t)words;
+#endif
+}
+
+/* Console.Write on both flavours. Under zisk_sim, stderr stays unbuffered so
+ * diagnostics are not held back behind regular output. */
+int
+__wrap_SystemNative_Write(intptr_t fd, const void *buffer, int bufferSize)
+{
+    if (bufferSize <= 0)
+        return 0;
+#if ZKVM_SIM
+    if (fd != 1)
+    {
+        sim_write_all(fd, buffer, (size_t)bufferSize);
+        return bufferSize;
+    }
+#else
+    (void)fd;
+#endif
+    zk_output_write(buffer, (size_t)bufferSize);
+    return bufferSize;
+}
+
+/*
+ * musl's stdio backend. The FILE layout is musl's (src/internal/stdio_impl.h);
+ * only the fields __stdio_write itself touches are spelt out. Like the real
+ * one, it writes what the FILE has buffered followed by `buf`, then rewinds
+ * the FILE's buffer.
+ */
+struct zk_musl_file
+{
+    unsigned       flags;
+    unsigned char *rpos, *rend;
+    int          (*close)(void *);
+    unsigned char *wend, *wpos;
+    unsigned char *mustbezero_1;
+    unsigned char *wbase;
+    size_t       (*read)(void *, unsigned char *, size_t);
+    size_t       (*write)(void *, const unsigned char *, size_t);
+    long         (*seek)(void *, long, int);
+    unsigned char *buf;
+    size_t         buf_size;
+    void          *prev, *next;
+    int            fd;
+};
+
+size_t
+__wrap___stdio_write(struct zk_musl_file *f, const unsigned char *buf, size_t len)
+{
+    size_t pending = (size_t)(f->wpos - f->wbase);
+
+#if ZKVM_SIM
+    if (f->fd != 1)
+    {
+        sim_write_all(f->fd, f->wbase, pending);
+        sim_write_all(f->fd, buf, len);
+    }
+    else
+#endif
+    {
+        zk_output_write(f->wbase, pending);
+        zk_output_write(buf, len);
+    }
+    f->wend = f->buf + f->buf_size;
+    f->wpos = f->wbase = f->buf;
+    return len;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @brief Managed surface of the output channel
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ */
+using System;
+using System.Runtime.InteropServices;
+
+namespace Bflat.Zkvm
+{
+    /// <summary>
+    /// Console text and public outputs of the guest. Console output
+    /// (<c>Console.Write</c> included) is buffered in RAM and written out in
+    /// batches; public outputs are collected and published once, at exit.
+    /// </summary>
+    /// <remarks>
+    /// There are <see cref="PublicWords"/> 32-bit public output words. On zisk
+    /// they become the proof's public outputs; under zisk_sim they are written
+    /// to the file named by <c>ZKVM_OUTPUT</c> in the environment, if any.
+    /// </remarks>
+    public static unsafe class ZkOutput
+    {
+        /// <summary>Number of public output words the prover accepts.</summary>
+        public const int PublicWords = 64;
+
+        /// <summary>Sets public output word <paramref name="index"/>.</summary>
+        public static void Set(int index, uint value)
+        {
+            if ((uint)index >= PublicWords)
+                throw new ArgumentOutOfRangeException(nameof(index));
+            zk_output_set((uint)index, value);
+        }
+
+        /// <summary>
+        /// Appends <paramref name="data"/> to the public outputs, packed
+        /// little-endian into the words after those already set.
+        /// </summary>
+        public static void Publish(ReadOnlySpan<byte> data)
+        {
+            fixed (byte* d = data)
+            {
+                if (zk_output_publish(d, (nuint)data.Length) != 0)
+                    throw new ArgumentException("Public outputs hold at most 256 bytes", nameof(data));
+            }
+        }
+
+        /// <summary>Appends raw bytes to the console buffer.</summary>
+        public static void Write(ReadOnlySpan<byte> text)
+        {
+            fixed (byte* t = text)
+                zk_output_write(t, (nuint)text.Length);
+        }
+
+        /// <summary>Writes out the console buffer now rather than later.</summary>
+        public static void Flush() => zk_output_flush();
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern int zk_output_set(uint index, uint value);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern int zk_output_publish(byte* data, nuint length);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_output_write(byte* data, nuint length);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_output_flush();
+    }
+}
@@ -0,0 +1,735 @@
+/**
+ * @file
+ * @brief ZisK precompiles (Keccak-f, SHA-256, secp256k1, 256-bit arithmetic)
+ *        with software fallbacks for zisk_sim.
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ *
+ * @author Maxim Menshikov <maksim.menshikov@nethermind.io>
+ */
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+/* sim flavour (module.sim.o): the precompiles are computed in software, with
+ * the same inputs, outputs and preconditions as the ZisK circuits. */
+#ifndef ZKVM_SIM
+#define ZKVM_SIM 0
+#endif
+
+/*
+ * A ZisK precompile is a write to its CSR with the address of the operand
+ * block; the emulator runs the circuit and writes the result back in place
+ * before the next instruction. The numbers and operand layouts are those of
+ * ziskos' syscalls.
+ */
+#define ZISK_CSR_KECCAKF        0x800
+#define ZISK_CSR_ARITH256       0x801
+#define ZISK_CSR_ARITH256_MOD   0x802
+#define ZISK_CSR_SECP256K1_ADD  0x803
+#define ZISK_CSR_SECP256K1_DBL  0x804
+#define ZISK_CSR_SHA256F        0x805
+
+#define ZISK_STR(x) #x
+#define ZISK_PRECOMPILE(csr, arg) \
+    __asm__ volatile("csrs " ZISK_STR(csr) ", %0" : : "r"(arg) : "memory")
+
+/* Affine point, coordinates as little-endian 64-bit limbs. Same layout as
+ * Bflat.Zkvm.Secp256k1Point. */
+struct zk_secp256k1_point
+{
+    uint64_t x[4];
+    uint64_t y[4];
+};
+
+#define KECCAK256_RATE 136
+#define SHA256_BLOCK   64
+
+#if !ZKVM_SIM
+struct zisk_sha256f_params
+{
+    uint64_t       *state; /* 8 words, two per limb, first word high */
+    const uint64_t *input; /* 64 block bytes, big-endian per limb */
+};
+
+struct zisk_secp256k1_add_params
+{
+    struct zk_secp256k1_point       *p1;
+    const struct zk_secp256k1_point *p2;
+};
+
+struct zisk_arith256_params
+{
+    const uint64_t *a, *b, *c;
+    uint64_t       *dl, *dh;
+};
+
+struct zisk_arith256_mod_params
+{
+    const uint64_t *a, *b, *c, *module;
+    uint64_t       *d;
+};
+
+void
+zk_keccakf(uint64_t state[25])
+{
+    ZISK_PRECOMPILE(ZISK_CSR_KECCAKF, state);
+}
+
+void
+zk_arith256(const uint64_t a[4], const uint64_t b[4], const uint64_t c[4], uint64_t dl[4], uint64_t dh[4])
+{
+    struct zisk_arith256_params params = { a, b, c, dl, dh };
+
+    ZISK_PRECOMPILE(ZISK_CSR_ARITH256, &params);
+}
+
+void
+zk_arith256_mod(const uint64_t a[4], const uint64_t b[4], const uint64_t c[4], const uint64_t m[4], uint64_t d[4])
+{
+    struct zisk_arith256_mod_params params = { a, b, c, m, d };
+
+    ZISK_PRECOMPILE(ZISK_CSR_ARITH256_MOD, &params);
+}
+
+void
+zk_secp256k1_add(struct zk_secp256k1_point *p1, const struct zk_secp256k1_point *p2)
+{
+    struct zisk_secp256k1_add_params params = { p1, p2 };
+
+    ZISK_PRECOMPILE(ZISK_CSR_SECP256K1_ADD, &params);
+}
+
+void
+zk_secp256k1_dbl(struct zk_secp256k1_point *p)
+{
+    ZISK_PRECOMPILE(ZISK_CSR_SECP256K1_DBL, p);
+}
+
+static inline void
+zisk_sha256_block(uint64_t packed[4], const uint8_t *block)
+{
+    uint64_t                   input[8];
+    struct zisk_sha256f_params params = { packed, input };
+
+    for (int i = 0; i < 8; i++)
+    {
+        uint64_t w;
+        memcpy(&w, block + 8 * i, sizeof(w));
+        input[i] = __builtin_bswap64(w);
+    }
+    ZISK_PRECOMPILE(ZISK_CSR_SHA256F, &params);
+}
+
+/* The circuit keeps the state packed two words per limb; convert once per
+ * call rather than once per block. */
+static inline void
+sha256_blocks(uint32_t state[8], const uint8_t *blocks, size_t count)
+{
+    uint64_t packed[4];
+
+    for (int i = 0; i < 4; i++)
+        packed[i] = ((uint64_t)state[2 * i] << 32) | state[2 * i + 1];
+    for (size_t i = 0; i < count; i++)
+        zisk_sha256_block(packed, blocks + SHA256_BLOCK * i);
+    for (int i = 0; i < 4; i++)
+    {
+        state[2 * i]     = (uint32_t)(packed[i] >> 32);
+        state[2 * i + 1] = (uint32_t)packed[i];
+    }
+}
+#else
+static inline uint64_t
+rotl64(uint64_t x, int k)
+{
+    return (x << k) | (x >> ((64 - k) & 63));
+}
+
+static const uint64_t keccak_rc[24] = {
+    0x0000000000000001ull, 0x0000000000008082ull, 0x800000000000808Aull, 0x8000000080008000ull,
+    0x000000000000808Bull, 0x0000000080000001ull, 0x8000000080008081ull, 0x8000000000008009ull,
+    0x000000000000008Aull, 0x0000000000000088ull, 0x0000000080008009ull, 0x000000008000000Aull,
+    0x000000008000808Bull, 0x800000000000008Bull, 0x8000000000008089ull, 0x8000000000008003ull,
+    0x8000000000008002ull, 0x8000000000000080ull, 0x000000000000800Aull, 0x800000008000000Aull,
+    0x8000000080008081ull, 0x8000000000008080ull, 0x0000000080000001ull, 0x8000000080008008ull,
+};
+
+static const uint8_t keccak_rho[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44,
+};
+
+static const uint8_t keccak_pi[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1,
+};
+
+void
+zk_keccakf(uint64_t st[25])
+{
+    for (int round = 0; round < 24; round++)
+    {
+        uint64_t bc[5];
+
+        for (int i = 0; i < 5; i++)
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        for (int i = 0; i < 5; i++)
+        {
+            uint64_t t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5)
+                st[j + i] ^= t;
+        }
+
+        uint64_t t = st[1];
+        for (int i = 0; i < 24; i++)
+        {
+            int      j   = keccak_pi[i];
+            uint64_t tmp = st[j];
+            st[j] = rotl64(t, keccak_rho[i]);
+            t     = tmp;
+        }
+
+        for (int j = 0; j < 25; j += 5)
+        {
+            for (int i = 0; i < 5; i++)
+                bc[i] = st[j + i];
+            for (int i = 0; i < 5; i++)
+                st[j + i] ^= ~bc[(i + 1) % 5] & bc[(i + 2) % 5];
+        }
+
+        st[0] ^= keccak_rc[round];
+    }
+}
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t
+rotr32(uint32_t x, int k)
+{
+    return (x >> k) | (x << (32 - k));
+}
+
+static void
+sha256_block(uint32_t state[8], const uint8_t *block)
+{
+    uint32_t w[64];
+
+    for (int i = 0; i < 16; i++)
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16)
+               | ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+    for (int i = 16; i < 64; i++)
+    {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t t1 = h + (rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25)) + ((e & f) ^ (~e & g))
+                      + sha256_k[i] + w[i];
+        uint32_t t2 = (rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+static inline void
+sha256_blocks(uint32_t state[8], const uint8_t *blocks, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        sha256_block(state, blocks + SHA256_BLOCK * i);
+}
+
+/* a * b + c as a 512-bit t[8]; cannot overflow. */
+static void
+u256_mul_add(uint64_t t[8], const uint64_t a[4], const uint64_t b[4], const uint64_t c[4])
+{
+    memcpy(t, c, 4 * sizeof(uint64_t));
+    memset(t + 4, 0, 4 * sizeof(uint64_t));
+    for (int i = 0; i < 4; i++)
+    {
+        unsigned __int128 acc = 0;
+        for (int j = 0; j < 4; j++)
+        {
+            acc += (unsigned __int128)a[i] * b[j] + t[i + j];
+            t[i + j] = (uint64_t)acc;
+            acc >>= 64;
+        }
+        for (int k = i + 4; k < 8 && acc != 0; k++)
+        {
+            acc += t[k];
+            t[k] = (uint64_t)acc;
+            acc >>= 64;
+        }
+    }
+}
+
+void
+zk_arith256(const uint64_t a[4], const uint64_t b[4], const uint64_t c[4], uint64_t dl[4], uint64_t dh[4])
+{
+    uint64_t t[8];
+
+    u256_mul_add(t, a, b, c);
+    memcpy(dl, t, 4 * sizeof(uint64_t));
+    memcpy(dh, t + 4, 4 * sizeof(uint64_t));
+}
+
+/* Shift-subtract reduction of the 512-bit value, one bit per step; slow,
+ * but only the simulator runs it. The remainder stays below 2m < 2^257. */
+void
+zk_arith256_mod(const uint64_t a[4], const uint64_t b[4], const uint64_t c[4], const uint64_t m[4], uint64_t d[4])
+{
+    uint64_t t[8], r[5] = { 0 };
+
+    u256_mul_add(t, a, b, c);
+    for (int i = 511; i >= 0; i--)
+    {
+        for (int k = 4; k > 0; k--)
+            r[k] = (r[k] << 1) | (r[k - 1] >> 63);
+        r[0] = (r[0] << 1) | ((t[i / 64] >> (i % 64)) & 1);
+
+        int ge = r[4] != 0;
+        for (int k = 3; k >= 0 && !ge; k--)
+        {
+            if (r[k] != m[k])
+            {
+                ge = r[k] > m[k];
+                break;
+            }
+            if (k == 0)
+                ge = 1;
+        }
+        if (ge)
+        {
+            uint64_t borrow = 0;
+            for (int k = 0; k < 5; k++)
+            {
+                uint64_t mk = k < 4 ? m[k] : 0;
+                uint64_t v  = r[k] - mk - borrow;
+                borrow = (r[k] < mk) | ((r[k] - mk) < borrow);
+                r[k]   = v;
+            }
+        }
+    }
+    memcpy(d, r, 4 * sizeof(uint64_t));
+}
+
+/*
+ * secp256k1 field arithmetic modulo p = 2^256 - 2^32 - 977, on 4 x 64-bit
+ * little-endian limbs, always fully reduced so results match the circuit's
+ * canonical output bit for bit.
+ */
+typedef unsigned __int128 u128;
+
+#define FE_C 0x1000003D1ull /* 2^256 mod p */
+
+/* r < 2^256 with an optional carry of 2^256 -> canonical r mod p. */
+static inline void
+fe_canonical(uint64_t r[4], uint64_t carry)
+{
+    u128 acc;
+
+    if (carry)
+    {
+        acc = (u128)r[0] + FE_C;
+        r[0] = (uint64_t)acc;
+        for (int i = 1; i < 4; i++)
+        {
+            acc = (acc >> 64) + r[i];
+            r[i] = (uint64_t)acc;
+        }
+    }
+
+    /* r >= p exactly when r + (2^256 - p) carries out. */
+    uint64_t t[4];
+    acc  = (u128)r[0] + FE_C;
+    t[0] = (uint64_t)acc;
+    for (int i = 1; i < 4; i++)
+    {
+        acc  = (acc >> 64) + r[i];
+        t[i] = (uint64_t)acc;
+    }
+    if (acc >> 64)
+        memcpy(r, t, sizeof(t));
+}
+
+static void
+fe_add(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    u128 acc = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        acc += (u128)a[i] + b[i];
+        r[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+    fe_canonical(r, (uint64_t)acc);
+}
+
+static void
+fe_sub(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t borrow = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t d = a[i] - b[i];
+        uint64_t o = (a[i] < b[i]) | (d < borrow);
+        r[i]   = d - borrow;
+        borrow = o;
+    }
+
+    /* Wrapped by 2^256: adding p back is subtracting 2^256 - p. */
+    if (borrow)
+    {
+        uint64_t d = r[0] - FE_C;
+        borrow = r[0] < FE_C;
+        r[0]   = d;
+        for (int i = 1; i < 4 && borrow; i++)
+            borrow = r[i]-- == 0;
+    }
+}
+
+static void
+fe_mul(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t t[8] = { 0 };
+
+    for (int i = 0; i < 4; i++)
+    {
+        u128 acc = 0;
+        for (int j = 0; j < 4; j++)
+        {
+            acc += (u128)a[i] * b[j] + t[i + j];
+            t[i + j] = (uint64_t)acc;
+            acc >>= 64;
+        }
+        t[i + 4] = (uint64_t)acc;
+    }
+
+    /* hi * 2^256 + lo = hi * FE_C + lo (mod p), folded twice. */
+    u128     acc = 0;
+    uint64_t m[4];
+    for (int i = 0; i < 4; i++)
+    {
+        acc += (u128)t[4 + i] * FE_C + t[i];
+        m[i] = (uint64_t)acc;
+        acc >>= 64;
+    }
+
+    acc  = (u128)(uint64_t)acc * FE_C + m[0];
+    r[0] = (uint64_t)acc;
+    for (int i = 1; i < 4; i++)
+    {
+        acc  = (acc >> 64) + m[i];
+        r[i] = (uint64_t)acc;
+    }
+    fe_canonical(r, (uint64_t)(acc >> 64));
+}
+
+/* a^(p - 2) = a^-1 for a != 0. */
+static void
+fe_inv(uint64_t r[4], const uint64_t a[4])
+{
+    static const uint64_t e[4] = {
+        0xFFFFFFFEFFFFFC2Dull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull,
+    };
+    uint64_t x[4] = { 1, 0, 0, 0 };
+
+    for (int i = 255; i >= 0; i--)
+    {
+        fe_mul(x, x, x);
+        if ((e[i / 64] >> (i % 64)) & 1)
+            fe_mul(x, x, a);
+    }
+    memcpy(r, x, sizeof(x));
+}
+
+/* x3 = l^2 - x1 - x2, y3 = l * (x1 - x3) - y1 */
+static void
+secp256k1_finish(struct zk_secp256k1_point *p1, const uint64_t l[4], const uint64_t x2[4])
+{
+    uint64_t x3[4], t[4];
+
+    fe_mul(x3, l, l);
+    fe_sub(x3, x3, p1->x);
+    fe_sub(x3, x3, x2);
+    fe_sub(t, p1->x, x3);
+    fe_mul(t, l, t);
+    fe_sub(p1->y, t, p1->y);
+    memcpy(p1->x, x3, sizeof(x3));
+}
+
+/* As the circuit: p1 and p2 are distinct, not opposite, not infinity. */
+void
+zk_secp256k1_add(struct zk_secp256k1_point *p1, const struct zk_secp256k1_point *p2)
+{
+    uint64_t l[4], t[4];
+
+    fe_sub(t, p2->x, p1->x);
+    fe_inv(t, t);
+    fe_sub(l, p2->y, p1->y);
+    fe_mul(l, l, t);
+    secp256k1_finish(p1, l, p2->x);
+}
+
+void
+zk_secp256k1_dbl(struct zk_secp256k1_point *p)
+{
+    uint64_t l[4], t[4], x[4];
+
+    memcpy(x, p->x, sizeof(x));
+    fe_add(t, p->y, p->y);
+    fe_inv(t, t);
+    fe_mul(l, x, x);
+    fe_add(x, l, l);
+    fe_add(l, x, l);
+    fe_mul(l, l, t);
+    secp256k1_finish(p, l, p->x);
+}
+#endif
+
+/* Whole-message helpers on top of the compression functions; identical for
+ * both flavours, so only the permutation differs between prover and sim. */
+
+void
+zk_keccak256(const uint8_t *data, size_t length, uint8_t hash[32])
+{
+    uint64_t st[25] = { 0 };
+    uint8_t  last[KECCAK256_RATE];
+
+    while (length >= KECCAK256_RATE)
+    {
+        for (int i = 0; i < KECCAK256_RATE / 8; i++)
+        {
+            uint64_t w;
+            memcpy(&w, data + 8 * i, sizeof(w));
+            st[i] ^= w;
+        }
+        zk_keccakf(st);
+        data += KECCAK256_RATE;
+        length -= KECCAK256_RATE;
+    }
+
+    memset(last, 0, sizeof(last));
+    memcpy(last, data, length);
+    last[length] ^= 0x01;
+    last[KECCAK256_RATE - 1] ^= 0x80;
+    for (int i = 0; i < KECCAK256_RATE / 8; i++)
+    {
+        uint64_t w;
+        memcpy(&w, last + 8 * i, sizeof(w));
+        st[i] ^= w;
+    }
+    zk_keccakf(st);
+
+    memcpy(hash, st, 32);
+}
+
+void
+zk_sha256f(uint32_t state[8], const uint8_t block[64])
+{
+    sha256_blocks(state, block, 1);
+}
+
+void
+zk_sha256(const uint8_t *data, size_t length, uint8_t hash[32])
+{
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    uint8_t  tail[2 * SHA256_BLOCK];
+    size_t   full = length / SHA256_BLOCK;
+    size_t   rest = length % SHA256_BLOCK;
+    uint64_t bits = (uint64_t)length * 8;
+
+    sha256_blocks(state, data, full);
+
+    size_t tailLength = rest < SHA256_BLOCK - 8 ? SHA256_BLOCK : 2 * SHA256_BLOCK;
+    memset(tail, 0, tailLength);
+    memcpy(tail, data + full * SHA256_BLOCK, rest);
+    tail[rest] = 0x80;
+    for (int i = 0; i < 8; i++)
+        tail[tailLength - 1 - i] = (uint8_t)(bits >> (8 * i));
+    sha256_blocks(state, tail, tailLength / SHA256_BLOCK);
+
+    for (int i = 0; i < 8; i++)
+    {
+        hash[4 * i]     = (uint8_t)(state[i] >> 24);
+        hash[4 * i + 1] = (uint8_t)(state[i] >> 16);
+        hash[4 * i + 2] = (uint8_t)(state[i] >> 8);
+        hash[4 * i + 3] = (uint8_t)state[i];
+    }
+}
+
+/*
+ * EVM-style 256-bit arithmetic on top of arith256 / arith256_mod. A zero
+ * modulus yields zero, as MULMOD and ADDMOD define it; the circuit is
+ * never asked to divide by zero.
+ */
+static const uint64_t u256_zero[4] = { 0, 0, 0, 0 };
+static const uint64_t u256_one[4]  = { 1, 0, 0, 0 };
+
+static inline int
+u256_is_zero(const uint64_t a[4])
+{
+    return (a[0] | a[1] | a[2] | a[3]) == 0;
+}
+
+/* r = a + b mod 2^256; returns the carry. Plain adds beat a precompile call
+ * here. */
+int
+zk_add256(const uint64_t a[4], const uint64_t b[4], uint64_t r[4])
+{
+    uint64_t carry = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t s = a[i] + carry;
+        uint64_t c = s < carry;
+        r[i]  = s + b[i];
+        carry = c | (r[i] < b[i]);
+    }
+    return (int)carry;
+}
+
+/* Full 512-bit product. */
+void
+zk_mul256(const uint64_t a[4], const uint64_t b[4], uint64_t lo[4], uint64_t hi[4])
+{
+    zk_arith256(a, b, u256_zero, lo, hi);
+}
+
+void
+zk_addmod256(const uint64_t a[4], const uint64_t b[4], const uint64_t m[4], uint64_t r[4])
+{
+    if (u256_is_zero(m))
+    {
+        memset(r, 0, 4 * sizeof(uint64_t));
+        return;
+    }
+    zk_arith256_mod(a, u256_one, b, m, r);
+}
+
+void
+zk_mulmod256(const uint64_t a[4], const uint64_t b[4], const uint64_t m[4], uint64_t r[4])
+{
+    if (u256_is_zero(m))
+    {
+        memset(r, 0, 4 * sizeof(uint64_t));
+        return;
+    }
+    zk_arith256_mod(a, b, u256_zero, m, r);
+}
+
+/* base^e mod m, square-and-multiply from the top set bit; m == 0 means
+ * mod 2^256 (EVM EXP). Outputs never alias inputs of the same call. */
+static inline void
+u256_mulmod_step(uint64_t x[4], const uint64_t b[4], const uint64_t m[4], int wrap)
+{
+    uint64_t lo[4], hi[4];
+
+    if (wrap)
+        zk_arith256(x, b, u256_zero, lo, hi);
+    else
+        zk_arith256_mod(x, b, u256_zero, m, lo);
+    memcpy(x, lo, sizeof(lo));
+}
+
+void
+zk_expmod256(const uint64_t base[4], const uint64_t e[4], const uint64_t m[4], uint64_t r[4])
+{
+    int      wrap = u256_is_zero(m);
+    uint64_t x[4], b[4];
+    int      top = 255;
+
+    while (top >= 0 && !((e[top / 64] >> (top % 64)) & 1))
+        top--;
+
+    memcpy(b, base, sizeof(b));
+    memcpy(x, u256_one, sizeof(x));
+    if (!wrap)
+        u256_mulmod_step(x, u256_one, m, 0); /* 1 mod m: 0 for m == 1 */
+
+    for (int i = top; i >= 0; i--)
+    {
+        uint64_t sq[4];
+
+        memcpy(sq, x, sizeof(sq));
+        u256_mulmod_step(x, sq, m, wrap);
+        if ((e[i / 64] >> (i % 64)) & 1)
+            u256_mulmod_step(x, b, m, wrap);
+    }
+    memcpy(r, x, sizeof(x));
+}
+
+/*
+ * k * p by double-and-add over the add/dbl precompiles, MSB first. The
+ * circuits take no special points, so the loop tracks infinity itself and
+ * routes p + p to the doubling and p + (-p) to infinity. Returns 0 when the
+ * result is the point at infinity (p is then left unchanged).
+ */
+int
+zk_secp256k1_mul(struct zk_secp256k1_point *p, const uint64_t k[4])
+{
+    struct zk_secp256k1_point acc;
+    int                       infinity = 1;
+
+    for (int i = 255; i >= 0; i--)
+    {
+        if (!infinity)
+            zk_secp256k1_dbl(&acc);
+        if (!((k[i / 64] >> (i % 64)) & 1))
+            continue;
+
+        if (infinity)
+        {
+            acc      = *p;
+            infinity = 0;
+        }
+        else if (memcmp(acc.x, p->x, sizeof(acc.x)) != 0)
+        {
+            zk_secp256k1_add(&acc, p);
+        }
+        else if (memcmp(acc.y, p->y, sizeof(acc.y)) == 0)
+        {
+            zk_secp256k1_dbl(&acc);
+        }
+        else
+        {
+            infinity = 1;
+        }
+    }
+
+    if (infinity)
+        return 0;
+    *p = acc;
+    return 1;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file
+ * @brief Managed surface of the ZisK precompiles: Keccak, SHA-256,
+ *        secp256k1 point arithmetic and 256-bit integer arithmetic
+ *
+ * Copyright (C) 2026 Demerzel Solutions Limited (Nethermind)
+ */
+using System;
+using System.Runtime.InteropServices;
+
+namespace Bflat.Zkvm
+{
+    /// <summary>
+    /// An affine secp256k1 point, coordinates as little-endian 64-bit limbs
+    /// (<c>X[0]</c> is the least significant).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public unsafe struct Secp256k1Point
+    {
+        public fixed ulong X[4];
+        public fixed ulong Y[4];
+    }
+
+    /// <summary>
+    /// Hashing and elliptic-curve primitives backed by ZisK precompiles. A
+    /// zisk build hands each compression or point operation to the prover's
+    /// circuit; a zisk_sim build computes the same values in software, so the
+    /// same code runs, bit for bit, under QEMU.
+    /// </summary>
+    public static unsafe class ZkPrecompiles
+    {
+        /// <summary>Keccak-f[1600] on 25 lanes, in place.</summary>
+        public static void KeccakF1600(Span<ulong> state)
+        {
+            if (state.Length < 25)
+                throw new ArgumentException("Keccak state needs 25 lanes", nameof(state));
+            fixed (ulong* p = state)
+                zk_keccakf(p);
+        }
+
+        /// <summary>Ethereum's Keccak-256 of <paramref name="data"/>.</summary>
+        public static void Keccak256(ReadOnlySpan<byte> data, Span<byte> hash)
+        {
+            if (hash.Length < 32)
+                throw new ArgumentException("Keccak-256 hash needs 32 bytes", nameof(hash));
+            fixed (byte* d = data)
+            fixed (byte* h = hash)
+                zk_keccak256(d, (nuint)data.Length, h);
+        }
+
+        /// <summary>
+        /// One SHA-256 compression of a 64-byte block into the 8-word state.
+        /// </summary>
+        public static void Sha256Compress(Span<uint> state, ReadOnlySpan<byte> block)
+        {
+            if (state.Length < 8)
+                throw new ArgumentException("SHA-256 state needs 8 words", nameof(state));
+            if (block.Length < 64)
+                throw new ArgumentException("SHA-256 block needs 64 bytes", nameof(block));
+            fixed (uint* s = state)
+            fixed (byte* b = block)
+                zk_sha256f(s, b);
+        }
+
+        /// <summary>SHA-256 of <paramref name="data"/>.</summary>
+        public static void Sha256(ReadOnlySpan<byte> data, Span<byte> hash)
+        {
+            if (hash.Length < 32)
+                throw new ArgumentException("SHA-256 hash needs 32 bytes", nameof(hash));
+            fixed (byte* d = data)
+            fixed (byte* h = hash)
+                zk_sha256(d, (nuint)data.Length, h);
+        }
+
+        /// <summary>
+        /// <paramref name="p"/> += <paramref name="q"/>. Like the circuit, this
+        /// requires two finite points that are neither equal nor opposite.
+        /// </summary>
+        public static void Secp256k1Add(ref Secp256k1Point p, Secp256k1Point q)
+        {
+            fixed (Secp256k1Point* pp = &p)
+                zk_secp256k1_add(pp, &q);
+        }
+
+        /// <summary><paramref name="p"/> = 2 * <paramref name="p"/> for a finite point.</summary>
+        public static void Secp256k1Double(ref Secp256k1Point p)
+        {
+            fixed (Secp256k1Point* pp = &p)
+                zk_secp256k1_dbl(pp);
+        }
+
+        /// <summary>
+        /// <paramref name="p"/> = k * <paramref name="p"/>, with the scalar as
+        /// 4 little-endian limbs. Returns false, leaving <paramref name="p"/>
+        /// unchanged, when the product is the point at infinity.
+        /// </summary>
+        public static bool Secp256k1Multiply(ref Secp256k1Point p, ReadOnlySpan<ulong> scalar)
+        {
+            if (scalar.Length < 4)
+                throw new ArgumentException("Scalar needs 4 limbs", nameof(scalar));
+            fixed (Secp256k1Point* pp = &p)
+            fixed (ulong* k = scalar)
+                return zk_secp256k1_mul(pp, k) != 0;
+        }
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_keccakf(ulong* state);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_keccak256(byte* data, nuint length, byte* hash);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_sha256f(uint* state, byte* block);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_sha256(byte* data, nuint length, byte* hash);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_secp256k1_add(Secp256k1Point* p1, Secp256k1Point* p2);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_secp256k1_dbl(Secp256k1Point* p);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern int zk_secp256k1_mul(Secp256k1Point* p, ulong* scalar);
+    }
+
+    /// <summary>
+    /// A 256-bit unsigned integer as little-endian 64-bit limbs, laid out like
+    /// Nethermind.Int256.UInt256 (<c>U0</c> is the least significant).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ZkUInt256
+    {
+        public ulong U0, U1, U2, U3;
+
+        public ZkUInt256(ulong u0, ulong u1 = 0, ulong u2 = 0, ulong u3 = 0)
+        {
+            U0 = u0;
+            U1 = u1;
+            U2 = u2;
+            U3 = u3;
+        }
+    }
+
+    /// <summary>
+    /// 256-bit arithmetic on the ZisK arith256 / arith256_mod precompiles,
+    /// with a software fallback under zisk_sim. The modular operations follow
+    /// the EVM: a zero modulus gives zero.
+    /// </summary>
+    public static unsafe class ZkArith256
+    {
+        /// <summary>a + b mod 2^256; <paramref name="carry"/> is the bit shifted out.</summary>
+        public static ZkUInt256 Add(ZkUInt256 a, ZkUInt256 b, out bool carry)
+        {
+            ZkUInt256 r;
+            carry = zk_add256(&a, &b, &r) != 0;
+            return r;
+        }
+
+        /// <summary>The full 512-bit product a * b.</summary>
+        public static ZkUInt256 Multiply(ZkUInt256 a, ZkUInt256 b, out ZkUInt256 high)
+        {
+            ZkUInt256 lo, hi;
+            zk_mul256(&a, &b, &lo, &hi);
+            high = hi;
+            return lo;
+        }
+
+        /// <summary>a * b + c as a 512-bit value; never overflows.</summary>
+        public static ZkUInt256 MultiplyAdd(ZkUInt256 a, ZkUInt256 b, ZkUInt256 c, out ZkUInt256 high)
+        {
+            ZkUInt256 lo, hi;
+            zk_arith256(&a, &b, &c, &lo, &hi);
+            high = hi;
+            return lo;
+        }
+
+        /// <summary>(a + b) mod m, without losing the carry (EVM ADDMOD).</summary>
+        public static ZkUInt256 AddMod(ZkUInt256 a, ZkUInt256 b, ZkUInt256 m)
+        {
+            ZkUInt256 r;
+            zk_addmod256(&a, &b, &m, &r);
+            return r;
+        }
+
+        /// <summary>(a * b) mod m over the full product (EVM MULMOD).</summary>
+        public static ZkUInt256 MulMod(ZkUInt256 a, ZkUInt256 b, ZkUInt256 m)
+        {
+            ZkUInt256 r;
+            zk_mulmod256(&a, &b, &m, &r);
+            return r;
+        }
+
+        /// <summary>
+        /// b^e mod m; a zero <paramref name="m"/> means mod 2^256, which is
+        /// EVM EXP.
+        /// </summary>
+        public static ZkUInt256 ExpMod(ZkUInt256 b, ZkUInt256 e, ZkUInt256 m)
+        {
+            ZkUInt256 r;
+            zk_expmod256(&b, &e, &m, &r);
+            return r;
+        }
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern int zk_add256(ZkUInt256* a, ZkUInt256* b, ZkUInt256* r);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_mul256(ZkUInt256* a, ZkUInt256* b, ZkUInt256* lo, ZkUInt256* hi);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_arith256(ZkUInt256* a, ZkUInt256* b, ZkUInt256* c, ZkUInt256* lo, ZkUInt256* hi);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_addmod256(ZkUInt256* a, ZkUInt256* b, ZkUInt256* m, ZkUInt256* r);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_mulmod256(ZkUInt256* a, ZkUInt256* b, ZkUInt256* m, ZkUInt256* r);
+
+        [DllImport("*"), SuppressGCTransition]
+        private static extern void zk_expmod256(ZkUInt256* b, ZkUInt256* e, ZkUInt256* m, ZkUInt256* r);
+    }
+}
@@ -10,40 +10,76 @@ namespace System
     {
         public static void BlockCopy(Array src, int srcOffset, Array dst, int dstOffset, int count)
         {
+            if (src == null || dst == null)
+                Environment.FailFast(null);
+            if (srcOffset < 0 || dstOffset < 0 || count < 0)
+                Environment.FailFast(null);
+
+            nuint srcLen = (nuint)ByteLength(src);
+            nuint dstLen = (nuint)ByteLength(dst);
+            if ((nuint)srcOffset + (nuint)count > srcLen || (nuint)dstOffset + (nuint)count > dstLen)
+                Environment.FailFast(null);
+
+            SpanHelpers.Memmove(
+                ref Unsafe.Add(ref ArrayData(dst), (nint)(uint)dstOffset),
+                ref Unsafe.Add(ref ArrayData(src), (nint)(uint)srcOffset),
+                (nuint)(uint)count);
         }
 
-        public static int ByteLength(Array array)
+        public static unsafe int ByteLength(Array array)
         {
-            return 0;
+            if (array == null)
+                Environment.FailFast(null);
+
+            // Only arrays of primitives are valid here, and those are the
+            // ones whose component size is the element size.
+            return array.Length * array.m_pMethodTable->_usComponentSize;
         }
 
         public static byte GetByte(Array array, int index)
         {
-            return 0;
+            if ((uint)index >= (uint)ByteLength(array))
+                Environment.FailFast(null);
+            return Unsafe.Add(ref ArrayData(array), (nint)(uint)index);
         }
 
         public static void SetByte(Array array, int index, byte value)
         {
+            if ((uint)index >= (uint)ByteLength(array))
+                Environment.FailFast(null);
+            Unsafe.Add(ref ArrayData(array), (nint)(uint)index) = value;
         }
 
         public static unsafe void MemoryCopy(void* source, void* destination, long destinationSizeInBytes, long sourceBytesToCopy)
         {
+            if (sourceBytesToCopy < 0 || sourceBytesToCopy > destinationSizeInBytes)
+                Environment.FailFast(null);
+            SpanHelpers.Memmove(ref *(byte*)destination, ref *(byte*)source, (nuint)sourceBytesToCopy);
         }
 
         public static unsafe void MemoryCopy(void* source, void* destination, ulong destinationSizeInBytes, ulong sourceBytesToCopy)
         {
+            if (sourceBytesToCopy > destinationSizeInBytes)
+                Environment.FailFast(null);
+            SpanHelpers.Memmove(ref *(byte*)destination, ref *(byte*)source, (nuint)sourceBytesToCopy);
         }
 
         internal static unsafe void _Memmove(ref byte dest, ref byte src, nuint len)
         {
+            SpanHelpers.Memmove(ref dest, ref src, len);
         }
 
         internal static unsafe void _ZeroMemory(ref byte b, nuint byteLength)
         {
+            SpanHelpers.ClearWithoutReferences(ref b, byteLength);
         }
 
         internal static void BulkMoveWithWriteBarrier(ref byte destination, ref byte source, nuint byteCount)
         {
+            // There is no GC, hence no write barrier: a plain move will do.
+            SpanHelpers.Memmove(ref destination, ref source, byteCount);
         }
+
+        private static ref byte ArrayData(Array array) => ref Unsafe.As<RawArrayData>(array).Data;
     }
-}
\ No newline at end of file
+}
@@ -3,19 +3,136 @@ using System.Runtime.InteropServices;
 
 namespace System
 {
-    internal static partial class SpanHelpers // .ByteMemOps
+    internal static unsafe partial class SpanHelpers // .ByteMemOps
     {
+#if ZKVM
+        // The zkVM build of zerolib hands every block operation to the C
+        // library: memmove and memset there are the libziskos
+        // DMA-accelerated ones that RhBulkMoveWithWriteBarrier also ends up in.
+        [DllImport("*", EntryPoint = "memmove"), SuppressGCTransition]
+        private static extern void* NativeMemmove(void* dest, void* src, nuint len);
+
+        [DllImport("*", EntryPoint = "memset"), SuppressGCTransition]
+        private static extern void* NativeMemset(void* dest, int value, nuint len);
+#endif
+
         [Intrinsic] // Unrolled for small constant lengths
         internal static void Memmove(ref byte dest, ref byte src, nuint len)
         {
+            byte* d = (byte*)Unsafe.AsPointer(ref dest);
+            byte* s = (byte*)Unsafe.AsPointer(ref src);
+            if (d == s || len == 0)
+                return;
+#if ZKVM
+            NativeMemmove(d, s, len);
+#else
+            // Forward unless dest starts inside the source range; d < s wraps
+            // to a huge difference and takes the forward path too.
+            if ((nuint)(d - s) >= len)
+                CopyForward(d, s, len);
+            else
+                CopyBackward(d, s, len);
+#endif
         }
 
         public static void ClearWithoutReferences(ref byte dest, nuint len)
         {
+            Fill(ref dest, 0, len);
         }
 
         internal static void Fill(ref byte dest, byte value, nuint len)
         {
+            byte* d = (byte*)Unsafe.AsPointer(ref dest);
+            if (len == 0)
+                return;
+#if ZKVM
+            NativeMemset(d, value, len);
+#else
+            while (((nuint)d & 7) != 0 && len != 0)
+            {
+                *d++ = value;
+                len--;
+            }
+
+            ulong pattern = value * 0x0101010101010101UL;
+            for (; len >= 32; len -= 32, d += 32)
+            {
+                ((ulong*)d)[0] = pattern;
+                ((ulong*)d)[1] = pattern;
+                ((ulong*)d)[2] = pattern;
+                ((ulong*)d)[3] = pattern;
+            }
+            for (; len >= 8; len -= 8, d += 8)
+                *(ulong*)d = pattern;
+
+            while (len-- != 0)
+                *d++ = value;
+#endif
+        }
+
+#if !ZKVM
+        // Word loops need source and destination at the same offset within
+        // a word: RISC-V does not promise fast (or any) misaligned access,
+        // so other pairs fall back to bytes.
+        private static void CopyForward(byte* d, byte* s, nuint len)
+        {
+            if ((((nuint)d ^ (nuint)s) & 7) == 0)
+            {
+                for (; ((nuint)d & 7) != 0 && len != 0; len--)
+                    *d++ = *s++;
+
+                for (; len >= 32; len -= 32, d += 32, s += 32)
+                {
+                    ulong w0 = ((ulong*)s)[0];
+                    ulong w1 = ((ulong*)s)[1];
+                    ulong w2 = ((ulong*)s)[2];
+                    ulong w3 = ((ulong*)s)[3];
+                    ((ulong*)d)[0] = w0;
+                    ((ulong*)d)[1] = w1;
+                    ((ulong*)d)[2] = w2;
+                    ((ulong*)d)[3] = w3;
+                }
+                for (; len >= 8; len -= 8, d += 8, s += 8)
+                    *(ulong*)d = *(ulong*)s;
+            }
+
+            for (; len != 0; len--)
+                *d++ = *s++;
+        }
+
+        private static void CopyBackward(byte* d, byte* s, nuint len)
+        {
+            d += len;
+            s += len;
+            if ((((nuint)d ^ (nuint)s) & 7) == 0)
+            {
+                for (; ((nuint)d & 7) != 0 && len != 0; len--)
+                    *--d = *--s;
+
+                for (; len >= 32; len -= 32)
+                {
+                    d -= 32;
+                    s -= 32;
+                    ulong w3 = ((ulong*)s)[3];
+                    ulong w2 = ((ulong*)s)[2];
+                    ulong w1 = ((ulong*)s)[1];
+                    ulong w0 = ((ulong*)s)[0];
+                    ((ulong*)d)[3] = w3;
+                    ((ulong*)d)[2] = w2;
+                    ((ulong*)d)[1] = w1;
+                    ((ulong*)d)[0] = w0;
+                }
+                for (; len >= 8; len -= 8)
+                {
+                    d -= 8;
+                    s -= 8;
+                    *(ulong*)d = *(ulong*)s;
+                }
+            }
+
+            for (; len != 0; len--)
+                *--d = *--s;
         }
+#endif
     }
 }
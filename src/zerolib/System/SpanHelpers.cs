@@ -9,6 +9,8 @@ namespace System
     {
         public static unsafe void ClearWithReferences(ref IntPtr ip, nuint pointerSizeLength)
         {
+            // No GC is watching, so references clear like any other bytes.
+            ClearWithoutReferences(ref Unsafe.As<IntPtr, byte>(ref ip), pointerSizeLength * (nuint)sizeof(IntPtr));
         }
 
         public static void Reverse(ref int buf, nuint length)